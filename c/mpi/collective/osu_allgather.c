@@ -17,6 +17,7 @@ int main(int argc, char *argv[])
     double timer=0.0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     char *sendbuf, *recvbuf;
+    void *sendptr = NULL;
     int po_ret;
     int errors = 0, local_errors = 0;
     size_t bufsize;
@@ -25,9 +26,20 @@ int main(int argc, char *argv[])
     int papi_eventset = OMB_PAPI_NULL;
     options.bench = COLLECTIVE;
     options.subtype = GATHER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_ref_algo = OMB_REF_HIER | OMB_REF_RING | OMB_REF_RD;
+    options.show_in_place = 1;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
+    omb_ref_t ref;
 
     set_header(HEADER);
     set_benchmark_name("osu_allgather");
@@ -86,6 +98,11 @@ int main(int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size, MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
+    omb_ref_init(&ref, options.max_message_size,
+            options.max_message_size * numprocs, MPI_COMM_WORLD);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
@@ -103,6 +120,17 @@ int main(int argc, char *argv[])
         timer = 0.0;
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR,
                 size);
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_ALLGATHER, comm_shape.comm);
+            coll_args.sendbuf = sendptr;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = coll_args.recvcount = omb_ddt_size;
+            coll_args.sendtype = coll_args.recvtype = omb_ddt_datatype;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
+
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
                 omb_papi_start(&papi_eventset);
@@ -110,20 +138,31 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Allgather(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Allgather(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, omb_ddt_size,
-                                omb_ddt_datatype, MPI_COMM_WORLD));
+                                omb_ddt_datatype, comm_shape.comm));
                 }
+                omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Allgather(sendbuf, omb_ddt_size, omb_ddt_datatype,
-                        recvbuf, omb_ddt_size, omb_ddt_datatype,
-                        MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Allgather(sendptr, omb_ddt_size,
+                            omb_ddt_datatype, recvbuf, omb_ddt_size,
+                            omb_ddt_datatype, comm_shape.comm));
+            }
 
             t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
@@ -145,14 +184,18 @@ int main(int argc, char *argv[])
 
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time/numprocs;
-
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
+
+        if (options.ref_algo) {
+            omb_coll_args_init(&coll_args, OMB_COLL_ALLGATHER, MPI_COMM_WORLD);
+            coll_args.sendbuf = sendbuf;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = coll_args.recvcount = size;
+            omb_ref_time(&ref, &coll_args, size, &local_errors);
+        }
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
                         MPI_COMM_WORLD));
@@ -168,6 +211,9 @@ int main(int argc, char *argv[])
                 omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
@@ -185,6 +231,8 @@ int main(int argc, char *argv[])
     free_buffer(sendbuf, options.accel);
     free_buffer(recvbuf, options.accel);
 
+    omb_ref_free(&ref);
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
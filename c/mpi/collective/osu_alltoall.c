@@ -10,6 +10,8 @@
  */
 #include <osu_util_mpi.h>
 
+static double alltoall_sweep_run(MPI_Comm comm, size_t size, void *arg);
+
 int main (int argc, char *argv[])
 {
     int i, j, numprocs, rank, size;
@@ -18,16 +20,31 @@ int main (int argc, char *argv[])
     int errors = 0, local_errors = 0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     char *sendbuf = NULL, *recvbuf = NULL;
+    void *sendptr = NULL;
     int po_ret;
     size_t bufsize;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
+    char *sweep_bufs[2];
+    int sweep_ret = 0;
     options.bench = COLLECTIVE;
     options.subtype = ALLTOALL;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP | OMB_THROUGHPUT_CHAIN;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_ref_algo = OMB_REF_BRUCK | OMB_REF_PAIRWISE;
+    options.show_in_place = 1;
+    options.show_algo_sweep = 1;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
+    omb_ref_t ref;
 
     set_header(HEADER);
     set_benchmark_name("osu_alltoall");
@@ -86,6 +103,30 @@ int main (int argc, char *argv[])
     }
 
     set_buffer(recvbuf, options.accel, 0, bufsize);
+
+    if (options.algo_sweep) {
+        sweep_bufs[0] = sendbuf;
+        sweep_bufs[1] = recvbuf;
+        sweep_ret = omb_coll_sweep("alltoall", 1, alltoall_sweep_run,
+                sweep_bufs, MPI_COMM_WORLD);
+        free_buffer(sendbuf, options.accel);
+        free_buffer(recvbuf, options.accel);
+        MPI_CHECK(MPI_Finalize());
+
+        if (NONE != options.accel) {
+            if (cleanup_accel()) {
+                fprintf(stderr, "Error cleaning up device\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return sweep_ret ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size * numprocs, MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
+    omb_ref_init(&ref, options.max_message_size,
+            options.max_message_size * numprocs, MPI_COMM_WORLD);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
@@ -104,6 +145,17 @@ int main (int argc, char *argv[])
 
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR,
                 size);
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_ALLTOALL, comm_shape.comm);
+            coll_args.sendbuf = sendptr;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = coll_args.recvcount = omb_ddt_size;
+            coll_args.sendtype = coll_args.recvtype = omb_ddt_datatype;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
+
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
                 omb_papi_start(&papi_eventset);
@@ -111,19 +163,29 @@ int main (int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Alltoall(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Alltoall(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, omb_ddt_size,
-                                omb_ddt_datatype, MPI_COMM_WORLD));
+                                omb_ddt_datatype, comm_shape.comm));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Alltoall(sendbuf, omb_ddt_size, omb_ddt_datatype,
-                        recvbuf, omb_ddt_size, omb_ddt_datatype,
-                        MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Alltoall(sendptr, omb_ddt_size,
+                            omb_ddt_datatype, recvbuf, omb_ddt_size,
+                            omb_ddt_datatype, comm_shape.comm));
+            }
             t_stop = MPI_Wtime();
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
@@ -142,14 +204,18 @@ int main (int argc, char *argv[])
         omb_papi_stop_and_print(&papi_eventset, size);
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time / numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
 
+        if (options.ref_algo) {
+            omb_coll_args_init(&coll_args, OMB_COLL_ALLTOALL, MPI_COMM_WORLD);
+            coll_args.sendbuf = sendbuf;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = coll_args.recvcount = size;
+            omb_ref_time(&ref, &coll_args, size, &local_errors);
+        }
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
                         MPI_COMM_WORLD));
@@ -165,6 +231,9 @@ int main (int argc, char *argv[])
             omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
@@ -182,6 +251,8 @@ int main (int argc, char *argv[])
     free_buffer(sendbuf, options.accel);
     free_buffer(recvbuf, options.accel);
 
+    omb_ref_free(&ref);
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
@@ -199,4 +270,42 @@ int main (int argc, char *argv[])
 
     return EXIT_SUCCESS;
 }
+
+/*
+ * One size of the algorithm sweep: the timed loop above on comm, returning
+ * the latency averaged over all ranks (valid on rank 0), or -1.0 if the
+ * library rejected the call with the algorithm under test.
+ */
+static double alltoall_sweep_run(MPI_Comm comm, size_t size, void *arg)
+{
+    char **bufs = arg;
+    double t_start = 0.0, t_stop = 0.0, timer = 0.0;
+    double latency = 0.0, avg_time = 0.0;
+    int i, numprocs, iterations = options.iterations, skip = options.skip;
+
+    if (size > LARGE_MESSAGE_SIZE) {
+        iterations = options.iterations_large;
+        skip = options.skip_large;
+    }
+
+    MPI_CHECK(MPI_Comm_size(comm, &numprocs));
+    MPI_CHECK(MPI_Barrier(comm));
+    for (i = 0; i < iterations + skip; i++) {
+        t_start = MPI_Wtime();
+        if (MPI_SUCCESS != MPI_Alltoall(bufs[0], size, MPI_CHAR, bufs[1],
+                    size, MPI_CHAR, comm)) {
+            return -1.0;
+        }
+        t_stop = MPI_Wtime();
+        MPI_CHECK(MPI_Barrier(comm));
+        if (i >= skip) {
+            timer += t_stop - t_start;
+        }
+    }
+    latency = (timer * 1e6) / iterations;
+    MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
+                comm));
+
+    return avg_time / numprocs;
+}
 /* vi: set sw=4 sts=4 tw=80: */
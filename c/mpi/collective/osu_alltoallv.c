@@ -18,17 +18,28 @@ int main (int argc, char *argv[])
     int errors = 0, local_errors = 0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     char *sendbuf=NULL, *recvbuf=NULL;
+    void *sendptr = NULL;
     int *rdispls=NULL, *recvcounts=NULL, *sdispls=NULL, *sendcounts=NULL;
     int po_ret;
-    size_t bufsize;
+    size_t bufsize, vbufsize;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
     options.bench = COLLECTIVE;
     options.subtype = ALLTOALL;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_in_place = 1;
+    options.show_vcounts = 1;
 
     set_header(HEADER);
     set_benchmark_name("osu_alltoallv");
@@ -71,6 +82,8 @@ int main (int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
+    omb_vcounts_init(MPI_COMM_WORLD);
+    vbufsize = omb_vcounts_bufsize(options.max_message_size);
     if (allocate_memory_coll((void**)&recvcounts, numprocs*sizeof(int), NONE)) {
         fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
         MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
@@ -89,7 +102,7 @@ int main (int argc, char *argv[])
         MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
     }
 
-    bufsize = options.max_message_size * numprocs;
+    bufsize = MAX(options.max_message_size * numprocs, vbufsize);
     if (allocate_memory_coll((void**)&sendbuf, bufsize, options.accel)) {
         fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
         MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
@@ -103,6 +116,9 @@ int main (int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size * numprocs, MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
@@ -125,12 +141,29 @@ int main (int argc, char *argv[])
             disp += omb_ddt_size;
 
         }
+        if (options.vcounts) {
+            omb_vcounts_fill(size, sendcounts, sdispls, recvcounts, rdispls);
+        }
         omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
                 &omb_graph_options, size, options.iterations);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         timer = 0.0;
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR,
                 size);
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_ALLTOALLV,
+                    comm_shape.comm);
+            coll_args.sendbuf = sendptr;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcounts = sendcounts;
+            coll_args.sdispls = sdispls;
+            coll_args.recvcounts = recvcounts;
+            coll_args.rdispls = rdispls;
+            coll_args.sendtype = coll_args.recvtype = omb_ddt_datatype;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
 
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
@@ -139,22 +172,33 @@ int main (int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Alltoallv(sendbuf, sendcounts, sdispls,
+                    MPI_CHECK(MPI_Alltoallv(sendptr, sendcounts, sdispls,
                                 omb_ddt_datatype, recvbuf, recvcounts, rdispls,
-                                omb_ddt_datatype, MPI_COMM_WORLD));
+                                omb_ddt_datatype, comm_shape.comm));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
 
-            MPI_CHECK(MPI_Alltoallv(sendbuf, sendcounts, sdispls,
-                        omb_ddt_datatype, recvbuf, recvcounts, rdispls,
-                        omb_ddt_datatype, MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Alltoallv(sendptr, sendcounts, sdispls,
+                            omb_ddt_datatype, recvbuf, recvcounts, rdispls,
+                            omb_ddt_datatype, comm_shape.comm));
+            }
 
             t_stop = MPI_Wtime();
 
+            omb_skew_record(i, t_stop);
+
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
@@ -174,13 +218,10 @@ int main (int argc, char *argv[])
 
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time / numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
 
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
@@ -197,6 +238,9 @@ int main (int argc, char *argv[])
             omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
@@ -218,6 +262,8 @@ int main (int argc, char *argv[])
     free_buffer(sendbuf, options.accel);
     free_buffer(recvbuf, options.accel);
 
+    omb_vcounts_free();
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
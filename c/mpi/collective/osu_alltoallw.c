@@ -19,12 +19,16 @@ int main (int argc, char *argv[])
     int errors = 0, local_errors = 0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     char *sendbuf = NULL, *recvbuf = NULL;
+    void *sendptr = NULL;
     int *rdispls = NULL, *sdispls = NULL;
     int *recvcounts = NULL, *sendcounts = NULL;
     MPI_Datatype *stypes = NULL, *rtypes = NULL;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int po_ret = 0;
@@ -33,6 +37,12 @@ int main (int argc, char *argv[])
 
     options.bench = COLLECTIVE;
     options.subtype = ALLTOALL;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_in_place = 1;
 
     set_header(HEADER);
     set_benchmark_name("osu_alltoallw");
@@ -119,6 +129,9 @@ int main (int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
     
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size * numprocs, MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
     print_preamble(rank);
 
     for (size = options.min_message_size; size <= options.max_message_size;
@@ -145,24 +158,49 @@ int main (int argc, char *argv[])
                 &omb_graph_options, size, options.iterations);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         timer = 0.0;
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_ALLTOALLW,
+                    comm_shape.comm);
+            coll_args.sendbuf = sendptr;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcounts = sendcounts;
+            coll_args.sdispls = sdispls;
+            coll_args.sendtypes = stypes;
+            coll_args.recvcounts = recvcounts;
+            coll_args.rdispls = rdispls;
+            coll_args.recvtypes = rtypes;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
 
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Alltoallw(sendbuf, sendcounts, sdispls, stypes,
+                    MPI_CHECK(MPI_Alltoallw(sendptr, sendcounts, sdispls, stypes,
                                 recvbuf, recvcounts, rdispls, rtypes,
-                                MPI_COMM_WORLD));
+                                comm_shape.comm));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Alltoallw(sendbuf, sendcounts, sdispls, stypes,
-                        recvbuf, recvcounts, rdispls, rtypes,
-                        MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Alltoallw(sendptr, sendcounts, sdispls,
+                            stypes, recvbuf, recvcounts, rdispls, rtypes,
+                            comm_shape.comm));
+            }
             t_stop = MPI_Wtime();
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
@@ -180,13 +218,10 @@ int main (int argc, char *argv[])
         }
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time / numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
 
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
@@ -203,6 +238,9 @@ int main (int argc, char *argv[])
             omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
@@ -223,6 +261,7 @@ int main (int argc, char *argv[])
     free_buffer(sendbuf, options.accel);
     free_buffer(recvbuf, options.accel);
 
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
@@ -21,8 +21,16 @@ int main(int argc, char *argv[])
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
     options.bench = COLLECTIVE;
     options.subtype = BARRIER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
 
     set_header(HEADER);
     set_benchmark_name("osu_barrier");
@@ -72,18 +80,33 @@ int main(int argc, char *argv[])
     omb_graph_options.number_of_graphs = 0;
     omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
             &omb_graph_options, 1, options.iterations);
+    omb_comm_shape_create(&comm_shape);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
     timer = 0.0;
 
+    if (options.persistent || options.throughput) {
+        omb_coll_args_init(&coll_args, OMB_COLL_BARRIER, comm_shape.comm);
+        if (options.persistent) {
+            omb_persistent_init(&coll_args, &persistent_request);
+        }
+    }
+
     for (i = 0; i < options.iterations + options.skip; i++) {
         if (i == options.skip) {
             omb_papi_start(&papi_eventset);
         }
+        omb_skew_delay();
         t_start = MPI_Wtime();
-        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        if (options.persistent) {
+            MPI_CHECK(MPI_Start(&persistent_request));
+            MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+        } else {
+            MPI_CHECK(MPI_Barrier(comm_shape.comm));
+        }
         t_stop = MPI_Wtime();
+        omb_skew_record(i, t_stop);
 
         if (i>=options.skip) {
             timer+=t_stop-t_start;
@@ -99,15 +122,15 @@ int main(int argc, char *argv[])
 
     latency = (timer * 1e6) / options.iterations;
 
-    MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-    MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-    MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-    avg_time = avg_time/numprocs;
+    omb_throughput_time(&coll_args);
+    omb_skew_stats();
+    omb_comm_shape_stats(&comm_shape, 0, latency, &avg_time,
+            &min_time, &max_time);
 
     print_stats(rank, 0, avg_time, min_time, max_time);
+    if (options.persistent) {
+        MPI_CHECK(MPI_Request_free(&persistent_request));
+    }
     if (0 == rank && options.graph) {
         omb_graph_data->avg = avg_time;
         omb_graph_plot(&omb_graph_options, benchmark_name);
@@ -115,6 +138,7 @@ int main(int argc, char *argv[])
         omb_graph_free_data_buffers(&omb_graph_options);
     }
     omb_papi_free(&papi_eventset);
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     return EXIT_SUCCESS;
@@ -18,6 +18,7 @@ main (int argc, char *argv[])
     double timer=0.0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     char * sendbuf = NULL, * recvbuf = NULL;
+    void *sendptr = NULL;
     int po_ret;
     int errors = 0, local_errors = 0;
     size_t bufsize;
@@ -26,9 +27,19 @@ main (int argc, char *argv[])
     int papi_eventset = OMB_PAPI_NULL;
     options.bench = COLLECTIVE;
     options.subtype = GATHER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_in_place = 1;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
+    int root_buffers = 0;
 
     set_header(HEADER);
     set_benchmark_name("osu_gather");
@@ -72,7 +83,9 @@ main (int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
-    if (0 == rank) {
+    /* Under -K the root of every group needs the root buffers */
+    root_buffers = 0 == rank || OMB_SHAPE_WORLD != options.comm_shape;
+    if (root_buffers) {
         bufsize = options.max_message_size * numprocs;
         if (allocate_memory_coll((void**)&recvbuf, bufsize, options.accel)) {
             fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
@@ -88,6 +101,10 @@ main (int argc, char *argv[])
     }
     set_buffer(sendbuf, options.accel, 0, options.max_message_size);
 
+    sendptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
@@ -105,6 +122,17 @@ main (int argc, char *argv[])
         timer = 0.0;
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR,
                 size);
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_GATHER, comm_shape.comm);
+            coll_args.sendbuf = sendptr;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = coll_args.recvcount = omb_ddt_size;
+            coll_args.sendtype = coll_args.recvtype = omb_ddt_datatype;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
+
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
                 omb_papi_start(&papi_eventset);
@@ -112,19 +140,33 @@ main (int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    if (0 == rank) {
+                        omb_inplace_seed(recvbuf, sendbuf, size);
+                    }
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Gather(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Gather(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, omb_ddt_size,
-                                omb_ddt_datatype, 0, MPI_COMM_WORLD));
+                                omb_ddt_datatype, 0, comm_shape.comm));
+                }
+                if (0 == rank) {
+                    omb_inplace_seed(recvbuf, sendbuf, size);
                 }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Gather(sendbuf, omb_ddt_size, omb_ddt_datatype,
-                        recvbuf, omb_ddt_size, omb_ddt_datatype, 0,
-                        MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Gather(sendptr, omb_ddt_size,
+                            omb_ddt_datatype, recvbuf, omb_ddt_size,
+                            omb_ddt_datatype, 0, comm_shape.comm));
+            }
             t_stop = MPI_Wtime();
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (i >= options.skip) {
@@ -143,13 +185,10 @@ main (int argc, char *argv[])
         omb_papi_stop_and_print(&papi_eventset, size);
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time/numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
 
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
@@ -166,6 +205,9 @@ main (int argc, char *argv[])
             omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         if (0 != errors) {
@@ -178,11 +220,12 @@ main (int argc, char *argv[])
     omb_graph_combined_plot(&omb_graph_options, benchmark_name);
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
-    if (0 == rank) {
+    if (root_buffers) {
         free_buffer(recvbuf, options.accel);
     }
     free_buffer(sendbuf, options.accel);
 
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
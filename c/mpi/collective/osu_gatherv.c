@@ -17,18 +17,30 @@ int main(int argc, char *argv[])
     double timer=0.0;
     int errors = 0, local_errors = 0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
-    char *sendbuf, *recvbuf;
-    int *rdispls, *recvcounts;
+    char *sendbuf = NULL, *recvbuf = NULL;
+    void *sendptr = NULL;
+    int *rdispls = NULL, *recvcounts = NULL;
     int po_ret;
-    size_t bufsize;
+    size_t bufsize, vbufsize;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
     options.bench = COLLECTIVE;
     options.subtype = GATHER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_in_place = 1;
+    options.show_vcounts = 1;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
+    int root_buffers = 0;
 
     set_header(HEADER);
     set_benchmark_name("osu_gatherv");
@@ -72,7 +84,11 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
-    if (0 == rank) {
+    omb_vcounts_init(MPI_COMM_WORLD);
+    vbufsize = omb_vcounts_bufsize(options.max_message_size);
+    /* Under -K the root of every group needs the root buffers */
+    root_buffers = 0 == rank || OMB_SHAPE_WORLD != options.comm_shape;
+    if (root_buffers) {
         if (allocate_memory_coll((void**)&recvcounts, numprocs * sizeof(int),
                     NONE)) {
             fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
@@ -83,7 +99,7 @@ int main(int argc, char *argv[])
             MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
         }
 
-        bufsize = options.max_message_size * numprocs;
+        bufsize = MAX(options.max_message_size * numprocs, vbufsize);
         if (allocate_memory_coll((void**)&recvbuf, bufsize, options.accel)) {
             fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
             MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
@@ -91,13 +107,17 @@ int main(int argc, char *argv[])
         set_buffer(recvbuf, options.accel, 1, bufsize);
     }
 
-    if (allocate_memory_coll((void**)&sendbuf, options.max_message_size,
-                options.accel)) {
+    bufsize = MAX(options.max_message_size, vbufsize);
+    if (allocate_memory_coll((void**)&sendbuf, bufsize, options.accel)) {
         fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
         MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
     }
-    set_buffer(sendbuf, options.accel, 0, options.max_message_size);
+    set_buffer(sendbuf, options.accel, 0, bufsize);
 
+    sendptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
@@ -111,7 +131,7 @@ int main(int argc, char *argv[])
 
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
-        if (0 == rank) {
+        if (root_buffers) {
             disp =0;
             for ( i = 0; i < numprocs; i++) {
                 recvcounts[i] = omb_ddt_size;
@@ -119,6 +139,10 @@ int main(int argc, char *argv[])
                 disp += omb_ddt_size;
             }
         }
+        if (options.vcounts) {
+            omb_ddt_size = omb_vcounts_fill(size, NULL, NULL, recvcounts,
+                    rdispls);
+        }
 
         omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
                 &omb_graph_options, size, options.iterations);
@@ -126,30 +150,58 @@ int main(int argc, char *argv[])
         timer = 0.0;
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR,
                 size);
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_GATHERV, comm_shape.comm);
+            coll_args.sendbuf = sendptr;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = omb_ddt_size;
+            coll_args.recvcounts = recvcounts;
+            coll_args.rdispls = rdispls;
+            coll_args.sendtype = coll_args.recvtype = omb_ddt_datatype;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
 
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
                 omb_papi_start(&papi_eventset);
             }
             if (options.validate) {
-                set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
+                set_buffer_validation(sendbuf, 0 == rank ? recvbuf : NULL,
+                        size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    if (0 == rank) {
+                        omb_inplace_seed(recvbuf, sendbuf, size);
+                    }
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Gatherv(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Gatherv(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, recvcounts, rdispls,
-                                omb_ddt_datatype, 0, MPI_COMM_WORLD));
+                                omb_ddt_datatype, 0, comm_shape.comm));
+                }
+                if (0 == rank) {
+                    omb_inplace_seed(recvbuf, sendbuf, size);
                 }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
 
-            MPI_CHECK(MPI_Gatherv(sendbuf, omb_ddt_size, omb_ddt_datatype,
-                        recvbuf, recvcounts, rdispls, omb_ddt_datatype, 0,
-                        MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Gatherv(sendptr, omb_ddt_size,
+                            omb_ddt_datatype, recvbuf, recvcounts, rdispls,
+                            omb_ddt_datatype, 0, comm_shape.comm));
+            }
 
             t_stop = MPI_Wtime();
 
+            omb_skew_record(i, t_stop);
+
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate && 0 == rank) {
@@ -171,13 +223,10 @@ int main(int argc, char *argv[])
 
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time/numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
 
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
@@ -194,6 +243,9 @@ int main(int argc, char *argv[])
             omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
@@ -208,13 +260,15 @@ int main(int argc, char *argv[])
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
 
-    if (0 == rank) {
+    if (root_buffers) {
         free_buffer(rdispls, NONE);
         free_buffer(recvcounts, NONE);
         free_buffer(recvbuf, options.accel);
     }
     free_buffer(sendbuf, options.accel);
 
+    omb_vcounts_free();
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
@@ -0,0 +1,449 @@
+#define BENCHMARK "OSU MPI Halo Exchange Latency Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+/*
+ * Every rank owns an N^d block of doubles surrounded by a one cell ghost
+ * layer and exchanges the block boundary with its Cartesian neighbors. The
+ * message size is the size of one face, N^(d-1) doubles; edges and corners
+ * shrink accordingly. Boundaries are described with subarray datatypes so
+ * all exchange methods move exactly the same non-contiguous data.
+ *
+ * Neighbor i is the rank in direction dirs[i]. Data for direction dirs[i]
+ * is sent to send_rank[i] with tag i, and the matching message from the
+ * opposite side arrives from recv_rank[i] into the ghost cells facing
+ * -dirs[i]. Using the same order for the destinations and sources of the
+ * distributed graph keeps MPI_Neighbor_alltoallw matching correct even
+ * when a small periodic grid makes one rank the neighbor several times.
+ */
+#define HALO_MAX_NEIGHBORS 26
+
+struct halo_neighbors {
+    int count;
+    int dirs[HALO_MAX_NEIGHBORS][3];
+    int send_rank[HALO_MAX_NEIGHBORS];
+    int recv_rank[HALO_MAX_NEIGHBORS];
+};
+
+static char const *exchange_names[] = {
+    "Isend/Irecv",
+    "Persistent Isend/Irecv",
+    "MPI_Neighbor_alltoallw"
+};
+#define NUM_EXCHANGES ((int)(sizeof(exchange_names) / sizeof(exchange_names[0])))
+
+static void find_neighbors(MPI_Comm cart, int ndims,
+                           struct halo_neighbors *nbrs);
+static double create_types(int ndims, int n, struct halo_neighbors *nbrs,
+                           MPI_Datatype *send_types, MPI_Datatype *recv_types);
+static double exchange(int type, MPI_Comm cart, MPI_Comm graph, int n,
+                       struct halo_neighbors *nbrs, double *s_buf,
+                       double *r_buf, double *bytes);
+static void print_halo_header(int rank, int *dims, int count);
+static void print_stats_halo(int rank, int size, double avg_time,
+                             double min_time, double max_time, double bw);
+
+int main(int argc, char *argv[])
+{
+    int rank, numprocs, i, type, ndims, n, face_bytes, prod = 1;
+    int dims[3], periods[3];
+    double *s_buf = NULL, *r_buf = NULL;
+    double latency, bytes, bw, avg_time, min_time, max_time, avg_bw;
+    size_t elements, e, iterations, skip;
+    struct halo_neighbors nbrs;
+    MPI_Comm cart, graph = MPI_COMM_NULL;
+    int po_ret;
+
+    options.bench = COLLECTIVE;
+    options.subtype = HALO;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_halo");
+    po_ret = process_options(argc, argv);
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+
+    switch (po_ret) {
+        case PO_BAD_USAGE:
+            print_bad_usage_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+            print_help_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_VERSION_MESSAGE:
+            print_version_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    ndims = options.grid_ndims;
+    for (i = 0; i < ndims; i++) {
+        dims[i] = options.grid_dims[i];
+        periods[i] = options.grid_periodic;
+        prod *= dims[i] ? dims[i] : 1;
+    }
+    for (i = 0; i < ndims && dims[i]; i++);
+    if (numprocs % prod || (i == ndims && prod != numprocs)) {
+        if (0 == rank) {
+            fprintf(stderr, "The grid does not match the number of "
+                    "processes (%d)\n", numprocs);
+        }
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+    MPI_CHECK(MPI_Dims_create(numprocs, ndims, dims));
+    MPI_CHECK(MPI_Cart_create(MPI_COMM_WORLD, ndims, dims, periods, 0,
+                &cart));
+
+    find_neighbors(cart, ndims, &nbrs);
+    print_halo_header(rank, dims, nbrs.count);
+
+#if MPI_VERSION >= 3
+    if (options.exchange_types & OMB_EXCHANGE_NEIGHBOR) {
+        int sources[HALO_MAX_NEIGHBORS], destinations[HALO_MAX_NEIGHBORS];
+        int indegree = 0, outdegree = 0;
+
+        for (i = 0; i < nbrs.count; i++) {
+            if (MPI_PROC_NULL != nbrs.recv_rank[i]) {
+                sources[indegree++] = nbrs.recv_rank[i];
+            }
+            if (MPI_PROC_NULL != nbrs.send_rank[i]) {
+                destinations[outdegree++] = nbrs.send_rank[i];
+            }
+        }
+        omb_dist_graph_create(cart, indegree, sources, outdegree,
+                destinations, &graph);
+    }
+#else
+    options.exchange_types &= ~OMB_EXCHANGE_NEIGHBOR;
+#endif
+
+    iterations = options.iterations;
+    skip = options.skip;
+    for (type = 0; type < NUM_EXCHANGES; type++) {
+        if (!(options.exchange_types & (1 << type))) {
+            continue;
+        }
+        if (0 == rank) {
+            fprintf(stdout, "# Exchange: %s\n", exchange_names[type]);
+            fprintf(stdout, "%-*s%*s%*s", 10, "# Size", FIELD_WIDTH,
+                    "Avg Latency(us)", FIELD_WIDTH, "Bandwidth(MB/s)");
+            if (options.show_full) {
+                fprintf(stdout, "%*s%*s%*s", FIELD_WIDTH, "Min Latency(us)",
+                        FIELD_WIDTH, "Max Latency(us)", 12, "Iterations");
+            }
+            fprintf(stdout, "\n");
+            fflush(stdout);
+        }
+
+        for (n = 1; ; n *= 2) {
+            for (face_bytes = sizeof(double), i = 1; i < ndims; i++) {
+                face_bytes *= n;
+            }
+            for (elements = 1, i = 0; i < ndims; i++) {
+                elements *= n + 2;
+            }
+            if (face_bytes > options.max_message_size) {
+                break;
+            }
+            if (2 * elements * sizeof(double) > options.max_mem_limit) {
+                if (0 == rank) {
+                    fprintf(stderr, "Warning! Stopping before face size "
+                            "%d. Increase -M, --mem-limit for larger "
+                            "faces.\n", face_bytes);
+                }
+                break;
+            }
+            if (face_bytes < options.min_message_size) {
+                continue;
+            }
+
+            if (face_bytes > LARGE_MESSAGE_SIZE) {
+                options.iterations = options.iterations_large;
+                options.skip = options.skip_large;
+            } else {
+                options.iterations = iterations;
+                options.skip = skip;
+            }
+
+            s_buf = malloc(elements * sizeof(double));
+            r_buf = malloc(elements * sizeof(double));
+            OMB_CHECK_NULL_AND_EXIT(s_buf, "Unable to allocate memory");
+            OMB_CHECK_NULL_AND_EXIT(r_buf, "Unable to allocate memory");
+            for (e = 0; e < elements; e++) {
+                s_buf[e] = rank;
+                r_buf[e] = -1.0;
+            }
+
+            latency = exchange(1 << type, cart, graph, n, &nbrs, s_buf,
+                    r_buf, &bytes);
+            bw = bytes / latency;
+
+            MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN,
+                        0, cart));
+            MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX,
+                        0, cart));
+            MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM,
+                        0, cart));
+            avg_time = avg_time / numprocs;
+
+            MPI_CHECK(MPI_Reduce(&bw, &avg_bw, 1, MPI_DOUBLE, MPI_SUM, 0,
+                        cart));
+            avg_bw = avg_bw / numprocs;
+
+            print_stats_halo(rank, face_bytes, avg_time, min_time, max_time,
+                    avg_bw);
+
+            free(s_buf);
+            free(r_buf);
+        }
+    }
+
+#if MPI_VERSION >= 3
+    if (MPI_COMM_NULL != graph) {
+        MPI_CHECK(MPI_Comm_free(&graph));
+    }
+#endif
+    MPI_CHECK(MPI_Comm_free(&cart));
+    MPI_CHECK(MPI_Finalize());
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Collect every direction with at most halo_type non-zero components and
+ * the ranks on both sides of it.
+ */
+static void find_neighbors(MPI_Comm cart, int ndims,
+                           struct halo_neighbors *nbrs)
+{
+    int dims[3], periods[3], coords[3], nbr[3];
+    int d, o, side, nonzero, valid, rank;
+
+    MPI_CHECK(MPI_Cart_get(cart, ndims, dims, periods, coords));
+    nbrs->count = 0;
+
+    for (o = 0; o < (ndims == 3 ? 27 : 9); o++) {
+        int dir[3] = {o % 3 - 1, (o / 3) % 3 - 1, o / 9 - 1};
+
+        for (nonzero = 0, d = 0; d < ndims; d++) {
+            nonzero += (0 != dir[d]);
+        }
+        if (0 == nonzero || nonzero > (int)options.halo_type) {
+            continue;
+        }
+
+        for (side = 1; side >= -1; side -= 2) {
+            for (valid = 1, d = 0; d < ndims; d++) {
+                nbr[d] = coords[d] + side * dir[d];
+                if (nbr[d] < 0 || nbr[d] >= dims[d]) {
+                    if (periods[d]) {
+                        nbr[d] = (nbr[d] + dims[d]) % dims[d];
+                    } else {
+                        valid = 0;
+                    }
+                }
+            }
+            rank = MPI_PROC_NULL;
+            if (valid) {
+                MPI_CHECK(MPI_Cart_rank(cart, nbr, &rank));
+            }
+            if (1 == side) {
+                nbrs->send_rank[nbrs->count] = rank;
+            } else {
+                nbrs->recv_rank[nbrs->count] = rank;
+            }
+        }
+
+        for (d = 0; d < 3; d++) {
+            nbrs->dirs[nbrs->count][d] = dir[d];
+        }
+        nbrs->count++;
+    }
+}
+
+/*
+ * Build the subarray types of every neighbor for an N^d block and return
+ * the number of bytes this rank sends per exchange.
+ */
+static double create_types(int ndims, int n, struct halo_neighbors *nbrs,
+                           MPI_Datatype *send_types, MPI_Datatype *recv_types)
+{
+    int sizes[3], subsizes[3], send_starts[3], recv_starts[3];
+    int i, d, dir;
+    double bytes = 0.0, elements;
+
+    for (i = 0; i < nbrs->count; i++) {
+        elements = 1.0;
+        for (d = 0; d < ndims; d++) {
+            dir = nbrs->dirs[i][d];
+            sizes[d] = n + 2;
+            subsizes[d] = dir ? 1 : n;
+            send_starts[d] = (dir < 0) ? 1 : ((dir > 0) ? n : 1);
+            recv_starts[d] = (dir > 0) ? 0 : ((dir < 0) ? n + 1 : 1);
+            elements *= subsizes[d];
+        }
+        MPI_CHECK(MPI_Type_create_subarray(ndims, sizes, subsizes,
+                    send_starts, MPI_ORDER_C, MPI_DOUBLE, &send_types[i]));
+        MPI_CHECK(MPI_Type_create_subarray(ndims, sizes, subsizes,
+                    recv_starts, MPI_ORDER_C, MPI_DOUBLE, &recv_types[i]));
+        MPI_CHECK(MPI_Type_commit(&send_types[i]));
+        MPI_CHECK(MPI_Type_commit(&recv_types[i]));
+
+        if (MPI_PROC_NULL != nbrs->send_rank[i]) {
+            bytes += elements * sizeof(double);
+        }
+    }
+
+    return bytes;
+}
+
+/*
+ * Time options.iterations halo exchanges with the given method. Returns the
+ * average time per exchange in us and sets bytes to the amount of data this
+ * rank sends per exchange.
+ */
+static double exchange(int type, MPI_Comm cart, MPI_Comm graph, int n,
+                       struct halo_neighbors *nbrs, double *s_buf,
+                       double *r_buf, double *bytes)
+{
+    MPI_Datatype send_types[HALO_MAX_NEIGHBORS], recv_types[HALO_MAX_NEIGHBORS];
+    MPI_Request requests[2 * HALO_MAX_NEIGHBORS];
+    int i, j, num_requests = 2 * nbrs->count;
+    double t_start = 0.0, t_stop = 0.0, latency;
+#if MPI_VERSION >= 3
+    MPI_Datatype w_send_types[HALO_MAX_NEIGHBORS];
+    MPI_Datatype w_recv_types[HALO_MAX_NEIGHBORS];
+    MPI_Aint displs[HALO_MAX_NEIGHBORS] = {0};
+    int counts[HALO_MAX_NEIGHBORS];
+    int indegree = 0, outdegree = 0;
+#endif
+
+    *bytes = create_types(options.grid_ndims, n, nbrs, send_types, recv_types);
+
+    if (OMB_EXCHANGE_PERSISTENT == type) {
+        for (j = 0; j < nbrs->count; j++) {
+            MPI_CHECK(MPI_Recv_init(r_buf, 1, recv_types[j],
+                        nbrs->recv_rank[j], j, cart, &requests[2 * j]));
+            MPI_CHECK(MPI_Send_init(s_buf, 1, send_types[j],
+                        nbrs->send_rank[j], j, cart, &requests[2 * j + 1]));
+        }
+    }
+#if MPI_VERSION >= 3
+    if (OMB_EXCHANGE_NEIGHBOR == type) {
+        for (j = 0; j < nbrs->count; j++) {
+            counts[j] = 1;
+            if (MPI_PROC_NULL != nbrs->recv_rank[j]) {
+                w_recv_types[indegree++] = recv_types[j];
+            }
+            if (MPI_PROC_NULL != nbrs->send_rank[j]) {
+                w_send_types[outdegree++] = send_types[j];
+            }
+        }
+    }
+#endif
+
+    MPI_CHECK(MPI_Barrier(cart));
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        if (i == options.skip) {
+            t_start = MPI_Wtime();
+        }
+
+        switch (type) {
+            case OMB_EXCHANGE_ISEND:
+                for (j = 0; j < nbrs->count; j++) {
+                    MPI_CHECK(MPI_Irecv(r_buf, 1, recv_types[j],
+                                nbrs->recv_rank[j], j, cart,
+                                &requests[2 * j]));
+                    MPI_CHECK(MPI_Isend(s_buf, 1, send_types[j],
+                                nbrs->send_rank[j], j, cart,
+                                &requests[2 * j + 1]));
+                }
+                MPI_CHECK(MPI_Waitall(num_requests, requests,
+                            MPI_STATUSES_IGNORE));
+                break;
+            case OMB_EXCHANGE_PERSISTENT:
+                MPI_CHECK(MPI_Startall(num_requests, requests));
+                MPI_CHECK(MPI_Waitall(num_requests, requests,
+                            MPI_STATUSES_IGNORE));
+                break;
+#if MPI_VERSION >= 3
+            case OMB_EXCHANGE_NEIGHBOR:
+                MPI_CHECK(MPI_Neighbor_alltoallw(s_buf, counts, displs,
+                            w_send_types, r_buf, counts, displs,
+                            w_recv_types, graph));
+                break;
+#endif
+        }
+    }
+    t_stop = MPI_Wtime();
+
+    latency = (t_stop - t_start) * 1e6 / options.iterations;
+
+    if (OMB_EXCHANGE_PERSISTENT == type) {
+        for (j = 0; j < num_requests; j++) {
+            MPI_CHECK(MPI_Request_free(&requests[j]));
+        }
+    }
+    for (j = 0; j < nbrs->count; j++) {
+        MPI_CHECK(MPI_Type_free(&send_types[j]));
+        MPI_CHECK(MPI_Type_free(&recv_types[j]));
+    }
+
+    return latency;
+}
+
+static void print_halo_header(int rank, int *dims, int count)
+{
+    static char const *halo_names[] = {"", "faces", "faces and edges",
+        "faces, edges and corners"};
+
+    if (rank) {
+        return;
+    }
+
+    fprintf(stdout, HEADER);
+    if (2 == options.grid_ndims) {
+        fprintf(stdout, "# Grid: %dx%d", dims[0], dims[1]);
+    } else {
+        fprintf(stdout, "# Grid: %dx%dx%d", dims[0], dims[1], dims[2]);
+    }
+    fprintf(stdout, " %s, halo: %s (%d neighbors)\n",
+            options.grid_periodic ? "periodic" : "non-periodic",
+            halo_names[options.halo_type], count);
+    fflush(stdout);
+}
+
+static void print_stats_halo(int rank, int size, double avg_time,
+                             double min_time, double max_time, double bw)
+{
+    if (rank) {
+        return;
+    }
+
+    fprintf(stdout, "%-*d%*.*f%*.*f", 10, size, FIELD_WIDTH, FLOAT_PRECISION,
+            avg_time, FIELD_WIDTH, FLOAT_PRECISION, bw);
+    if (options.show_full) {
+        fprintf(stdout, "%*.*f%*.*f%*lu", FIELD_WIDTH, FLOAT_PRECISION,
+                min_time, FIELD_WIDTH, FLOAT_PRECISION, max_time, 12,
+                options.iterations);
+    }
+    fprintf(stdout, "\n");
+    fflush(stdout);
+}
+
+/* vi: set sw=4 sts=4 tw=80: */
@@ -28,11 +28,15 @@ int main(int argc, char *argv[])
     int papi_eventset = OMB_PAPI_NULL;
     options.bench = COLLECTIVE;
     options.subtype = NBC_GATHER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
 
     char *sendbuf = NULL;
+    void *sendptr = NULL;
     char *recvbuf = NULL;
     int po_ret;
     size_t bufsize;
@@ -96,6 +100,8 @@ int main(int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size, MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
@@ -121,17 +127,19 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Iallgather(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Iallgather(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, omb_ddt_size,
                                 omb_ddt_datatype, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request, &status));
                 }
+                omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Iallgather(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Iallgather(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, omb_ddt_size, omb_ddt_datatype, MPI_COMM_WORLD,
                         &request));
             MPI_CHECK(MPI_Wait(&request,&status));
@@ -169,18 +177,22 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Iallgather(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Iallgather(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, omb_ddt_size,
                                 omb_ddt_datatype, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request, &status));
                 }
+                omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
             init_time = MPI_Wtime();
-            MPI_CHECK(MPI_Iallgather(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Iallgather(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, omb_ddt_size, omb_ddt_datatype, MPI_COMM_WORLD,
                         &request));
             init_time = MPI_Wtime() - init_time;
@@ -195,6 +207,8 @@ int main(int argc, char *argv[])
 
             t_stop = MPI_Wtime();
 
+            omb_skew_record(i, t_stop);
+
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
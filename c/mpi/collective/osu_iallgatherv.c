@@ -25,6 +25,7 @@ int main(int argc, char *argv[])
     double init_total = 0.0, wait_total = 0.0;
     double avg_time = 0.0;
     char *sendbuf=NULL;
+    void *sendptr = NULL;
     char *recvbuf=NULL;
     int po_ret;
     size_t bufsize;
@@ -36,6 +37,9 @@ int main(int argc, char *argv[])
     set_benchmark_name("osu_iallgatherv");
     options.bench = COLLECTIVE;
     options.subtype = NBC_GATHER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
@@ -106,6 +110,8 @@ int main(int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size, MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
@@ -140,18 +146,20 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Iallgatherv(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Iallgatherv(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, recvcounts, rdispls,
                                 omb_ddt_datatype, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
             t_start = MPI_Wtime();
 
-            MPI_CHECK(MPI_Iallgatherv(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Iallgatherv(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, recvcounts, rdispls, omb_ddt_datatype,
                         MPI_COMM_WORLD, &request));
             MPI_CHECK(MPI_Wait(&request,&status));
@@ -202,18 +210,22 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Iallgatherv(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Iallgatherv(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, recvcounts, rdispls,
                                 omb_ddt_datatype, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf + rank * size, sendbuf, size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
             init_time = MPI_Wtime();
-            MPI_CHECK(MPI_Iallgatherv(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Iallgatherv(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, recvcounts, rdispls, omb_ddt_datatype,
                         MPI_COMM_WORLD, &request));
             init_time = MPI_Wtime() - init_time;
@@ -228,6 +240,8 @@ int main(int argc, char *argv[])
 
             t_stop = MPI_Wtime();
 
+            omb_skew_record(i, t_stop);
+
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
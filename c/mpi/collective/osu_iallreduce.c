@@ -26,12 +26,23 @@ int main(int argc, char *argv[])
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
+    MPI_Datatype reduce_datatype = MPI_FLOAT;
+    MPI_Op reduce_op = MPI_SUM;
+    size_t reduce_size = sizeof(float);
+    omb_coll_args_t coll_args;
     options.bench = COLLECTIVE;
     options.subtype = NBC_REDUCE;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_flight = 1;
+    options.show_in_place = 1;
+    options.show_reduce_types = 1;
 
     char *sendbuf = NULL;
+    void *sendptr = NULL;
     char *recvbuf = NULL;
     int po_ret;
+    int inflight_ret = 0;
     size_t bufsize;
 
     set_header(HEADER);
@@ -78,11 +89,29 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
-    options.min_message_size /= sizeof(float);
+    omb_reduction_get(&reduce_datatype, &reduce_op, &reduce_size);
+    options.min_message_size /= reduce_size;
     if (options.min_message_size < MIN_MESSAGE_SIZE) {
         options.min_message_size = MIN_MESSAGE_SIZE;
     }
 
+    if (options.in_flight) {
+        omb_coll_args_init(&coll_args, OMB_COLL_ALLREDUCE, MPI_COMM_WORLD);
+        coll_args.sendtype = coll_args.recvtype = reduce_datatype;
+        coll_args.op = reduce_op;
+        inflight_ret = omb_inflight_run(&coll_args, reduce_size);
+        omb_reduction_free();
+        MPI_CHECK(MPI_Finalize());
+
+        if (NONE != options.accel) {
+            if (cleanup_accel()) {
+                fprintf(stderr, "Error cleaning up device\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return inflight_ret ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
     bufsize = (options.max_message_size);
 
     if (allocate_memory_coll((void**)&sendbuf, bufsize, options.accel)) {
@@ -97,10 +126,12 @@ int main(int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size, MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
-    for (size = options.min_message_size; size * sizeof(float) <=
+    for (size = options.min_message_size; size * reduce_size <=
             options.max_message_size; size *= 2) {
         if (size > LARGE_MESSAGE_SIZE) {
             options.skip = options.skip_large;
@@ -108,7 +139,7 @@ int main(int argc, char *argv[])
         }
 
         omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
-                &omb_graph_options, size * sizeof(float), options.iterations);
+                &omb_graph_options, size * reduce_size, options.iterations);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
         timer = 0.0;
@@ -120,18 +151,20 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Iallreduce(sendbuf, recvbuf, size,
-                                MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD,
+                    MPI_CHECK(MPI_Iallreduce(sendptr, recvbuf, size,
+                                reduce_datatype, reduce_op, MPI_COMM_WORLD,
                                 &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Iallreduce(sendbuf, recvbuf, size,
-                        MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD,
+            MPI_CHECK(MPI_Iallreduce(sendptr, recvbuf, size,
+                        reduce_datatype, reduce_op, MPI_COMM_WORLD,
                         &request));
             MPI_CHECK(MPI_Wait(&request,&status));
 
@@ -150,7 +183,7 @@ int main(int argc, char *argv[])
         }
 
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-        omb_papi_stop_and_print(&papi_eventset, size * sizeof(float));
+        omb_papi_stop_and_print(&papi_eventset, size * reduce_size);
 
         latency = (timer * 1e6) / options.iterations;
 
@@ -169,19 +202,23 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Iallreduce(sendbuf, recvbuf, size,
-                                MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD,
+                    MPI_CHECK(MPI_Iallreduce(sendptr, recvbuf, size,
+                                reduce_datatype, reduce_op, MPI_COMM_WORLD,
                                 &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
             init_time = MPI_Wtime();
-            MPI_CHECK(MPI_Iallreduce(sendbuf, recvbuf, size,
-                        MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD,
+            MPI_CHECK(MPI_Iallreduce(sendptr, recvbuf, size,
+                        reduce_datatype, reduce_op, MPI_COMM_WORLD,
                         &request));
             init_time = MPI_Wtime() - init_time;
 
@@ -195,6 +232,8 @@ int main(int argc, char *argv[])
 
             t_stop = MPI_Wtime();
 
+            omb_skew_record(i, t_stop);
+
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
@@ -222,7 +261,7 @@ int main(int argc, char *argv[])
                         MPI_COMM_WORLD));
         }
 
-        avg_time = calculate_and_print_stats(rank, size*sizeof(float),
+        avg_time = calculate_and_print_stats(rank, size * reduce_size,
                                   numprocs, timer, latency,
                                   test_total, tcomp_total,
                                   wait_total, init_total,
@@ -242,6 +281,7 @@ int main(int argc, char *argv[])
     omb_graph_combined_plot(&omb_graph_options, benchmark_name);
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
+    omb_reduction_free();
 
     free_buffer(sendbuf, options.accel);
     free_buffer(recvbuf, options.accel);
@@ -33,6 +33,7 @@ int main(int argc, char *argv[])
     size_t omb_ddt_transmit_size = 0;
 
     char *sendbuf=NULL;
+    void *sendptr = NULL;
     char *recvbuf=NULL;
     int po_ret;
     size_t bufsize;
@@ -42,6 +43,9 @@ int main(int argc, char *argv[])
 
     options.bench = COLLECTIVE;
     options.subtype = NBC_ALLTOALL;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
 
     po_ret = process_options(argc, argv);
 
@@ -100,6 +104,8 @@ int main(int argc, char *argv[])
 
     set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size * numprocs, MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
@@ -125,17 +131,19 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Ialltoall(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Ialltoall(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, omb_ddt_size,
                                 omb_ddt_datatype, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Ialltoall(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Ialltoall(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, omb_ddt_size, omb_ddt_datatype, MPI_COMM_WORLD,
                         &request));
             MPI_CHECK(MPI_Wait(&request,&status));
@@ -175,19 +183,23 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Ialltoall(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Ialltoall(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, omb_ddt_size,
                                 omb_ddt_datatype, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
 
             init_time = MPI_Wtime();
-            MPI_CHECK(MPI_Ialltoall(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Ialltoall(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, omb_ddt_size, omb_ddt_datatype, MPI_COMM_WORLD,
                         &request));
             init_time = MPI_Wtime() - init_time;
@@ -202,6 +214,8 @@ int main(int argc, char *argv[])
 
             t_stop = MPI_Wtime();
 
+            omb_skew_record(i, t_stop);
+
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
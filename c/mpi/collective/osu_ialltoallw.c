@@ -25,6 +25,7 @@ int main(int argc, char *argv[])
     double init_total = 0.0, wait_total = 0.0;
 
     char *sendbuf=NULL;
+    void *sendptr = NULL;
     char *recvbuf=NULL;
     int *rdispls=NULL, *recvcounts=NULL, *sdispls=NULL, *sendcounts=NULL;
     MPI_Datatype *stypes = NULL, *rtypes = NULL;
@@ -39,6 +40,9 @@ int main(int argc, char *argv[])
 
     options.bench = COLLECTIVE;
     options.subtype = NBC_ALLTOALL;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
@@ -127,6 +131,8 @@ int main(int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size * numprocs, MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
@@ -161,17 +167,19 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Ialltoallw(sendbuf, sendcounts, sdispls,
+                    MPI_CHECK(MPI_Ialltoallw(sendptr, sendcounts, sdispls,
                                 stypes, recvbuf, recvcounts, rdispls, rtypes,
                                 MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Ialltoallw(sendbuf, sendcounts, sdispls, stypes,
+            MPI_CHECK(MPI_Ialltoallw(sendptr, sendcounts, sdispls, stypes,
                           recvbuf, recvcounts, rdispls, rtypes,
                           MPI_COMM_WORLD, &request));
             MPI_CHECK(MPI_Wait(&request,&status));
@@ -218,19 +226,23 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Ialltoallw(sendbuf, sendcounts, sdispls,
+                    MPI_CHECK(MPI_Ialltoallw(sendptr, sendcounts, sdispls,
                                 stypes, recvbuf, recvcounts, rdispls, rtypes,
                                 MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * numprocs);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
 
             init_time = MPI_Wtime();
-            MPI_CHECK(MPI_Ialltoallw(sendbuf, sendcounts, sdispls, stypes,
+            MPI_CHECK(MPI_Ialltoallw(sendptr, sendcounts, sdispls, stypes,
                           recvbuf, recvcounts, rdispls, rtypes,
                           MPI_COMM_WORLD, &request));
             init_time = MPI_Wtime() - init_time;
@@ -244,6 +256,8 @@ int main(int argc, char *argv[])
             wait_time = MPI_Wtime() - wait_time;
 
             t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
@@ -32,6 +32,8 @@ int main(int argc, char *argv[])
 
     options.bench = COLLECTIVE;
     options.subtype = NBC;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
 
     po_ret = process_options(argc, argv);
 
@@ -120,6 +122,7 @@ int main(int argc, char *argv[])
     test_time = 0.0, test_total = 0.0;
 
     for (i = 0; i < options.iterations + options.skip; i++) {
+            omb_skew_delay();
             t_start = MPI_Wtime();
 
             init_time = MPI_Wtime();
@@ -136,6 +139,8 @@ int main(int argc, char *argv[])
 
             t_stop = MPI_Wtime();
 
+            omb_skew_record(i, t_stop);
+
             if (i>=options.skip) {
                 timer += t_stop-t_start;
                 tcomp_total += tcomp;
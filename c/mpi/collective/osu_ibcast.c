@@ -25,18 +25,23 @@ int main(int argc, char *argv[])
     double init_total = 0.0, wait_total = 0.0;
     char *buffer=NULL;
     int po_ret;
+    int inflight_ret = 0;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
+    omb_coll_args_t coll_args;
 
     set_header(HEADER);
     set_benchmark_name("osu_ibcast");
 
     options.bench = COLLECTIVE;
     options.subtype = NBC_BCAST;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_flight = 1;
 
     po_ret = process_options(argc, argv);
 
@@ -80,6 +85,21 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
+
+    if (options.in_flight) {
+        omb_coll_args_init(&coll_args, OMB_COLL_BCAST, MPI_COMM_WORLD);
+        inflight_ret = omb_inflight_run(&coll_args, 1);
+        MPI_CHECK(MPI_Finalize());
+
+        if (NONE != options.accel) {
+            if (cleanup_accel()) {
+                fprintf(stderr, "Error cleaning up device\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return inflight_ret ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
     if (allocate_memory_coll((void**)&buffer, options.max_message_size,
                 options.accel)) {
         fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
@@ -168,6 +188,8 @@ int main(int argc, char *argv[])
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
             init_time = MPI_Wtime();
             MPI_CHECK(MPI_Ibcast(buffer, omb_ddt_size, omb_ddt_datatype, 0,
@@ -183,6 +205,8 @@ int main(int argc, char *argv[])
             wait_time = MPI_Wtime() - wait_time;
 
             t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
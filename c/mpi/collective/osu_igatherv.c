@@ -24,6 +24,7 @@ int main(int argc, char *argv[])
     double init_total = 0.0, wait_total = 0.0;
     double avg_time = 0.0;
     char *sendbuf=NULL;
+    void *sendptr = NULL;
     char *recvbuf=NULL;
     int *rdispls, *recvcounts;
     int po_ret;
@@ -39,6 +40,9 @@ int main(int argc, char *argv[])
     set_benchmark_name("osu_igatherv");
     options.bench = COLLECTIVE;
     options.subtype = NBC_GATHER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
     po_ret = process_options(argc, argv);
 
     if (PO_OKAY == po_ret && NONE != options.accel) {
@@ -107,6 +111,9 @@ int main(int argc, char *argv[])
     }
     set_buffer(sendbuf, options.accel, 0, options.max_message_size);
 
+    sendptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
@@ -145,17 +152,23 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    if (0 == rank) {
+                        omb_inplace_seed(recvbuf, sendbuf, size);
+                    }
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Igatherv(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Igatherv(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, recvcounts, rdispls,
                                 omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                if (0 == rank) {
+                    omb_inplace_seed(recvbuf, sendbuf, size);
+                }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Igatherv(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Igatherv(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, recvcounts, rdispls, omb_ddt_datatype, 0,
                         MPI_COMM_WORLD, &request));
             MPI_CHECK(MPI_Wait(&request,&status));
@@ -207,19 +220,27 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    if (0 == rank) {
+                        omb_inplace_seed(recvbuf, sendbuf, size);
+                    }
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Igatherv(sendbuf, omb_ddt_size,
+                    MPI_CHECK(MPI_Igatherv(sendptr, omb_ddt_size,
                                 omb_ddt_datatype, recvbuf, recvcounts, rdispls,
                                 omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                if (0 == rank) {
+                    omb_inplace_seed(recvbuf, sendbuf, size);
+                }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
 
             init_time = MPI_Wtime();
-            MPI_CHECK(MPI_Igatherv(sendbuf, omb_ddt_size, omb_ddt_datatype,
+            MPI_CHECK(MPI_Igatherv(sendptr, omb_ddt_size, omb_ddt_datatype,
                         recvbuf, recvcounts, rdispls, omb_ddt_datatype, 0,
                         MPI_COMM_WORLD, &request));
             init_time = MPI_Wtime() - init_time;
@@ -233,6 +254,8 @@ int main(int argc, char *argv[])
             wait_time = MPI_Wtime() - wait_time;
 
             t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate && 0 == rank) {
@@ -0,0 +1,204 @@
+#define BENCHMARK "OSU MPI%s Non-blocking Neighbor Allgather Latency Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+int main(int argc, char *argv[])
+{
+    int i, rank, numprocs, size;
+    int indegree = 0, outdegree = 0, max_degree = 0;
+    double latency = 0.0, t_start = 0.0, t_stop = 0.0;
+    double test_time = 0.0, test_total = 0.0;
+    double tcomp = 0.0, tcomp_total = 0.0, latency_in_secs = 0.0;
+    double wait_time = 0.0, init_time = 0.0;
+    double init_total = 0.0, wait_total = 0.0;
+    double timer = 0.0;
+    double avg_time = 0.0;
+    char *sendbuf = NULL, *recvbuf = NULL;
+    int po_ret;
+    size_t bufsize;
+    omb_graph_options_t omb_graph_options;
+    omb_graph_data_t *omb_graph_data = NULL;
+    int papi_eventset = OMB_PAPI_NULL;
+    MPI_Comm graph_comm;
+    MPI_Request request;
+    MPI_Status status;
+
+    options.bench = COLLECTIVE;
+    options.subtype = NBC_NEIGHBOR;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_ineighbor_allgather");
+    po_ret = process_options(argc, argv);
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+
+    omb_graph_options_init(&omb_graph_options);
+    switch (po_ret) {
+        case PO_BAD_USAGE:
+            print_bad_usage_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+            print_help_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_VERSION_MESSAGE:
+            print_version_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    if (numprocs < 2) {
+        if (rank == 0) {
+            fprintf(stderr, "This test requires at least two processes\n");
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    if (omb_neighbor_create_comm(&graph_comm, &indegree, &outdegree,
+                &max_degree)) {
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    check_mem_limit(max_degree);
+    bufsize = options.max_message_size * (max_degree ? max_degree : 1);
+    if (allocate_memory_coll((void**)&sendbuf, bufsize, options.accel)) {
+        fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
+        MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+    }
+    set_buffer(sendbuf, options.accel, 1, bufsize);
+
+    if (allocate_memory_coll((void**)&recvbuf, bufsize, options.accel)) {
+        fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
+        MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+    }
+    set_buffer(recvbuf, options.accel, 0, bufsize);
+
+    print_preamble_nbc(rank);
+    omb_papi_init(&papi_eventset);
+
+    for (size = options.min_message_size; size <= options.max_message_size;
+            size *= 2) {
+        if (size > LARGE_MESSAGE_SIZE) {
+            options.skip = options.skip_large;
+            options.iterations = options.iterations_large;
+        }
+
+        omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
+                &omb_graph_options, size, options.iterations);
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        timer = 0.0;
+
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            if (i == options.skip) {
+                omb_papi_start(&papi_eventset);
+            }
+            t_start = MPI_Wtime();
+            MPI_CHECK(MPI_Ineighbor_allgather(sendbuf, size, MPI_CHAR,
+                        recvbuf, size, MPI_CHAR, graph_comm, &request));
+            MPI_CHECK(MPI_Wait(&request, &status));
+            t_stop = MPI_Wtime();
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+            if (i >= options.skip) {
+                timer += t_stop - t_start;
+            }
+        }
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        omb_papi_stop_and_print(&papi_eventset, size);
+
+        /* This is the pure comm. time */
+        latency = (timer * 1e6) / options.iterations;
+
+        /* Comm. latency in seconds, fed to dummy_compute */
+        latency_in_secs = timer / options.iterations;
+
+        init_arrays(latency_in_secs);
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+        timer = 0.0; tcomp_total = 0.0; tcomp = 0.0;
+        init_total = 0.0; wait_total = 0.0;
+        test_time = 0.0, test_total = 0.0;
+
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            omb_skew_delay();
+            t_start = MPI_Wtime();
+
+            init_time = MPI_Wtime();
+            MPI_CHECK(MPI_Ineighbor_allgather(sendbuf, size, MPI_CHAR,
+                        recvbuf, size, MPI_CHAR, graph_comm, &request));
+            init_time = MPI_Wtime() - init_time;
+
+            tcomp = MPI_Wtime();
+            test_time = dummy_compute(latency_in_secs, &request);
+            tcomp = MPI_Wtime() - tcomp;
+
+            wait_time = MPI_Wtime();
+            MPI_CHECK(MPI_Wait(&request, &status));
+            wait_time = MPI_Wtime() - wait_time;
+
+            t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
+
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+            if (i >= options.skip) {
+                timer += t_stop - t_start;
+                tcomp_total += tcomp;
+                init_total += init_time;
+                test_total += test_time;
+                wait_total += wait_time;
+                if (options.graph && 0 == rank) {
+                    omb_graph_data->data[i - options.skip] = (t_stop -
+                            t_start) * 1e6;
+                }
+            }
+        }
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+        avg_time = calculate_and_print_stats(rank, size, numprocs,
+                                  timer, latency,
+                                  test_total, tcomp_total,
+                                  wait_total, init_total,
+                                  0);
+        if (options.graph && 0 == rank) {
+            omb_graph_data->avg = avg_time;
+        }
+    }
+    if (0 == rank && options.graph) {
+        omb_graph_plot(&omb_graph_options, benchmark_name);
+    }
+    omb_graph_combined_plot(&omb_graph_options, benchmark_name);
+    omb_graph_free_data_buffers(&omb_graph_options);
+    omb_papi_free(&papi_eventset);
+
+    free_buffer(sendbuf, options.accel);
+    free_buffer(recvbuf, options.accel);
+    MPI_CHECK(MPI_Comm_free(&graph_comm));
+
+    MPI_CHECK(MPI_Finalize());
+
+    return EXIT_SUCCESS;
+}
+/* vi: set sw=4 sts=4 tw=80: */
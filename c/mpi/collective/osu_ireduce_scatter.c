@@ -27,10 +27,18 @@ int main(int argc, char *argv[])
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
+    MPI_Datatype reduce_datatype = MPI_FLOAT;
+    MPI_Op reduce_op = MPI_SUM;
+    size_t reduce_size = sizeof(float);
     options.bench = COLLECTIVE;
     options.subtype = NBC_REDUCE_SCATTER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
+    options.show_reduce_types = 1;
     int *recvcounts = NULL;
     float *sendbuf = NULL;
+    void *sendptr = NULL;
     float *recvbuf = NULL;
     int po_ret = 0;
     size_t bufsize = 0;
@@ -78,7 +86,8 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
-    options.min_message_size /= sizeof(float);
+    omb_reduction_get(&reduce_datatype, &reduce_op, &reduce_size);
+    options.min_message_size /= reduce_size;
     if (options.min_message_size < MIN_MESSAGE_SIZE) {
         options.min_message_size = MIN_MESSAGE_SIZE;
     }
@@ -93,16 +102,22 @@ int main(int argc, char *argv[])
         MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
     }
     set_buffer(sendbuf, options.accel, 1, bufsize);
-    bufsize = sizeof(float) * (options.max_message_size / numprocs /
-            sizeof(float) + 1);
+    /*
+     * One extra element of the widest -B datatype; in place, the whole
+     * vector is reduced out of the receive buffer
+     */
+    bufsize = options.in_place ? options.max_message_size :
+        options.max_message_size / numprocs + sizeof(double);
     if (allocate_memory_coll((void**)&recvbuf, bufsize, options.accel)) {
         fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
         MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
     }
     set_buffer(recvbuf, options.accel, 0, bufsize);
+    sendptr = options.in_place ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(options.max_message_size / numprocs, MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
-    for (size = options.min_message_size; size * sizeof(float) <=
+    for (size = options.min_message_size; size * reduce_size <=
             options.max_message_size; size *= 2) {
         if (size > LARGE_MESSAGE_SIZE) {
             options.skip = options.skip_large;
@@ -134,16 +149,20 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Ireduce_scatter(sendbuf, recvbuf, recvcounts,
-                                MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD, &request));
+                    MPI_CHECK(MPI_Ireduce_scatter(sendptr, recvbuf, recvcounts,
+                                reduce_datatype, reduce_op, MPI_COMM_WORLD,
+                                &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Ireduce_scatter(sendbuf, recvbuf, recvcounts,
-                        MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD, &request));
+            MPI_CHECK(MPI_Ireduce_scatter(sendptr, recvbuf, recvcounts,
+                        reduce_datatype, reduce_op, MPI_COMM_WORLD,
+                        &request));
             MPI_CHECK(MPI_Wait(&request, &status));
             t_stop = MPI_Wtime();
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
@@ -158,7 +177,7 @@ int main(int argc, char *argv[])
             }
         }
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-        omb_papi_stop_and_print(&papi_eventset, size * sizeof(float));
+        omb_papi_stop_and_print(&papi_eventset, size * reduce_size);
         latency = (timer * 1e6) / options.iterations;
         /* Comm. latency in seconds, fed to dummy_compute */
         latency_in_secs = timer / options.iterations;
@@ -173,17 +192,22 @@ int main(int argc, char *argv[])
             if (options.validate) {
                 set_buffer_validation(sendbuf, recvbuf, size, options.accel, i);
                 for (j = 0; j < options.warmup_validation; j++) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Ireduce_scatter(sendbuf, recvbuf, recvcounts,
-                                MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD, &request));
+                    MPI_CHECK(MPI_Ireduce_scatter(sendptr, recvbuf, recvcounts,
+                                reduce_datatype, reduce_op, MPI_COMM_WORLD,
+                                &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
+                omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
+            omb_skew_delay();
             t_start = MPI_Wtime();
             init_time = MPI_Wtime();
-            MPI_CHECK(MPI_Ireduce_scatter(sendbuf, recvbuf, recvcounts,
-                        MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD, &request));
+            MPI_CHECK(MPI_Ireduce_scatter(sendptr, recvbuf, recvcounts,
+                        reduce_datatype, reduce_op, MPI_COMM_WORLD,
+                        &request));
             init_time = MPI_Wtime() - init_time;
             tcomp = MPI_Wtime();
             test_time = dummy_compute(latency_in_secs, &request);
@@ -192,6 +216,7 @@ int main(int argc, char *argv[])
             MPI_CHECK(MPI_Wait(&request, &status));
             wait_time = MPI_Wtime() - wait_time;
             t_stop = MPI_Wtime();
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             if (options.validate) {
                 if (recvcounts[rank] != 0) {
@@ -216,7 +241,7 @@ int main(int argc, char *argv[])
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
                         MPI_COMM_WORLD));
         }
-        avg_time = calculate_and_print_stats(rank, size * sizeof(float),
+        avg_time = calculate_and_print_stats(rank, size * reduce_size,
                                   numprocs, timer, latency,
                                   test_total, tcomp_total,
                                   wait_total, init_total,
@@ -234,6 +259,7 @@ int main(int argc, char *argv[])
     omb_graph_combined_plot(&omb_graph_options, benchmark_name);
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
+    omb_reduction_free();
     free_buffer(recvcounts, NONE);
     free_buffer(sendbuf, options.accel);
     free_buffer(recvbuf, options.accel);
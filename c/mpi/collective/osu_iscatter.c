@@ -25,6 +25,7 @@ int main(int argc, char *argv[])
     double init_total = 0.0, wait_total = 0.0;
     char *sendbuf=NULL;
     char *recvbuf=NULL;
+    void *recvptr = NULL;
     int po_ret;
     size_t bufsize;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
@@ -39,6 +40,9 @@ int main(int argc, char *argv[])
 
     options.bench = COLLECTIVE;
     options.subtype = NBC_SCATTER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
 
     po_ret = process_options(argc, argv);
 
@@ -98,6 +102,9 @@ int main(int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, options.max_message_size);
 
+    recvptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : recvbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
@@ -124,7 +131,7 @@ int main(int argc, char *argv[])
                 for (j = 0; j < options.warmup_validation; j++) {
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
                     MPI_CHECK(MPI_Iscatter(sendbuf, omb_ddt_size,
-                                omb_ddt_datatype, recvbuf, omb_ddt_size,
+                                omb_ddt_datatype, recvptr, omb_ddt_size,
                                 omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
@@ -133,7 +140,7 @@ int main(int argc, char *argv[])
 
             t_start = MPI_Wtime();
             MPI_CHECK(MPI_Iscatter(sendbuf, omb_ddt_size, omb_ddt_datatype,
-                        recvbuf, omb_ddt_size, omb_ddt_datatype, 0,
+                        recvptr, omb_ddt_size, omb_ddt_datatype, 0,
                         MPI_COMM_WORLD, &request));
             MPI_CHECK(MPI_Wait(&request,&status));
 
@@ -141,8 +148,8 @@ int main(int argc, char *argv[])
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
-                local_errors += validate_data(recvbuf, size, numprocs,
-                        options.accel, i);
+                local_errors += validate_data(MPI_IN_PLACE == recvptr ?
+                        sendbuf : recvbuf, size, numprocs, options.accel, i);
             }
 
             if (i>=options.skip) {
@@ -170,17 +177,19 @@ int main(int argc, char *argv[])
                 for (j = 0; j < options.warmup_validation; j++) {
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
                     MPI_CHECK(MPI_Iscatter(sendbuf, omb_ddt_size,
-                                omb_ddt_datatype, recvbuf, omb_ddt_size,
+                                omb_ddt_datatype, recvptr, omb_ddt_size,
                                 omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
             init_time = MPI_Wtime();
             MPI_CHECK(MPI_Iscatter(sendbuf, omb_ddt_size, omb_ddt_datatype,
-                        recvbuf, omb_ddt_size, omb_ddt_datatype, 0,
+                        recvptr, omb_ddt_size, omb_ddt_datatype, 0,
                         MPI_COMM_WORLD, &request));
             init_time = MPI_Wtime() - init_time;
 
@@ -193,11 +202,13 @@ int main(int argc, char *argv[])
             wait_time = MPI_Wtime() - wait_time;
 
             t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
-                local_errors += validate_data(recvbuf, size, numprocs,
-                        options.accel, i);
+                local_errors += validate_data(MPI_IN_PLACE == recvptr ?
+                        sendbuf : recvbuf, size, numprocs, options.accel, i);
             }
 
             if (i>=options.skip) {
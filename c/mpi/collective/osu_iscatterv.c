@@ -25,6 +25,7 @@ int main(int argc, char *argv[])
     double avg_time = 0.0;
     char *sendbuf=NULL;
     char *recvbuf=NULL;
+    void *recvptr = NULL;
     int *sdispls=NULL, *sendcounts=NULL;
     int po_ret;
     size_t bufsize;
@@ -39,6 +40,9 @@ int main(int argc, char *argv[])
     set_benchmark_name("osu_iscatterv");
     options.bench = COLLECTIVE;
     options.subtype = NBC_SCATTER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_in_place = 1;
     po_ret = process_options(argc, argv);
 
     if (PO_OKAY == po_ret && NONE != options.accel) {
@@ -107,6 +111,9 @@ int main(int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, options.max_message_size);
 
+    recvptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : recvbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
     print_preamble_nbc(rank);
     omb_papi_init(&papi_eventset);
 
@@ -146,7 +153,7 @@ int main(int argc, char *argv[])
                 for (j = 0; j < options.warmup_validation; j++) {
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
                     MPI_CHECK(MPI_Iscatterv(sendbuf, sendcounts, sdispls,
-                                omb_ddt_datatype, recvbuf, omb_ddt_size,
+                                omb_ddt_datatype, recvptr, omb_ddt_size,
                                 omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
@@ -156,7 +163,7 @@ int main(int argc, char *argv[])
             t_start = MPI_Wtime();
 
             MPI_CHECK(MPI_Iscatterv(sendbuf, sendcounts, sdispls,
-                        omb_ddt_datatype, recvbuf, omb_ddt_size,
+                        omb_ddt_datatype, recvptr, omb_ddt_size,
                         omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
             MPI_CHECK(MPI_Wait(&request,&status));
 
@@ -164,8 +171,8 @@ int main(int argc, char *argv[])
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
-                local_errors += validate_data(recvbuf, size, numprocs,
-                        options.accel, i);
+                local_errors += validate_data(MPI_IN_PLACE == recvptr ?
+                        sendbuf : recvbuf, size, numprocs, options.accel, i);
             }
 
             if (i >= options.skip) {
@@ -208,18 +215,20 @@ int main(int argc, char *argv[])
                 for (j = 0; j < options.warmup_validation; j++) {
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
                     MPI_CHECK(MPI_Iscatterv(sendbuf, sendcounts, sdispls,
-                                omb_ddt_datatype, recvbuf, omb_ddt_size,
+                                omb_ddt_datatype, recvptr, omb_ddt_size,
                                 omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
                     MPI_CHECK(MPI_Wait(&request,&status));
                 }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
 
             init_time = MPI_Wtime();
             MPI_CHECK(MPI_Iscatterv(sendbuf, sendcounts, sdispls,
-                        omb_ddt_datatype, recvbuf, omb_ddt_size,
+                        omb_ddt_datatype, recvptr, omb_ddt_size,
                         omb_ddt_datatype, 0, MPI_COMM_WORLD, &request));
             init_time = MPI_Wtime() - init_time;
 
@@ -232,11 +241,13 @@ int main(int argc, char *argv[])
             wait_time = MPI_Wtime() - wait_time;
 
             t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
-                local_errors += validate_data(recvbuf, size, numprocs,
-                        options.accel, i);
+                local_errors += validate_data(MPI_IN_PLACE == recvptr ?
+                        sendbuf : recvbuf, size, numprocs, options.accel, i);
             }
 
             if (i>=options.skip) {
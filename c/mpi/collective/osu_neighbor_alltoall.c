@@ -0,0 +1,176 @@
+#define BENCHMARK "OSU MPI%s Neighbor All-to-All Latency Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+int main(int argc, char *argv[])
+{
+    int i, rank, numprocs, size;
+    int indegree = 0, outdegree = 0, max_degree = 0;
+    double latency = 0.0, t_start = 0.0, t_stop = 0.0;
+    double timer = 0.0;
+    double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
+    char *sendbuf = NULL, *recvbuf = NULL;
+    int po_ret;
+    size_t bufsize;
+    omb_graph_options_t omb_graph_options;
+    omb_graph_data_t *omb_graph_data = NULL;
+    int papi_eventset = OMB_PAPI_NULL;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    MPI_Comm graph_comm;
+
+    options.bench = COLLECTIVE;
+    options.subtype = NEIGHBOR;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_persistent = 1;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_neighbor_alltoall");
+    po_ret = process_options(argc, argv);
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+
+    omb_graph_options_init(&omb_graph_options);
+    switch (po_ret) {
+        case PO_BAD_USAGE:
+            print_bad_usage_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+            print_help_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_VERSION_MESSAGE:
+            print_version_message(rank);
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    if (numprocs < 2) {
+        if (rank == 0) {
+            fprintf(stderr, "This test requires at least two processes\n");
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    if (omb_neighbor_create_comm(&graph_comm, &indegree, &outdegree,
+                &max_degree)) {
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    check_mem_limit(max_degree);
+    bufsize = options.max_message_size * (max_degree ? max_degree : 1);
+    if (allocate_memory_coll((void**)&sendbuf, bufsize, options.accel)) {
+        fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
+        MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+    }
+    set_buffer(sendbuf, options.accel, 1, bufsize);
+
+    if (allocate_memory_coll((void**)&recvbuf, bufsize, options.accel)) {
+        fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
+        MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+    }
+    set_buffer(recvbuf, options.accel, 0, bufsize);
+
+    print_preamble(rank);
+    omb_papi_init(&papi_eventset);
+
+    for (size = options.min_message_size; size <= options.max_message_size;
+            size *= 2) {
+        if (size > LARGE_MESSAGE_SIZE) {
+            options.skip = options.skip_large;
+            options.iterations = options.iterations_large;
+        }
+
+        omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
+                &omb_graph_options, size, options.iterations);
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        timer = 0.0;
+        if (options.persistent) {
+            omb_coll_args_init(&coll_args, OMB_COLL_NEIGHBOR_ALLTOALL,
+                    graph_comm);
+            coll_args.sendbuf = sendbuf;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = coll_args.recvcount = size;
+            omb_persistent_init(&coll_args, &persistent_request);
+        }
+
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            if (i == options.skip) {
+                omb_papi_start(&papi_eventset);
+            }
+            omb_skew_delay();
+            t_start = MPI_Wtime();
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Neighbor_alltoall(sendbuf, size, MPI_CHAR,
+                            recvbuf, size, MPI_CHAR, graph_comm));
+            }
+            t_stop = MPI_Wtime();
+            omb_skew_record(i, t_stop);
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+            if (i >= options.skip) {
+                timer += t_stop - t_start;
+                if (options.graph && 0 == rank) {
+                    omb_graph_data->data[i - options.skip] = (t_stop -
+                            t_start) * 1e6;
+                }
+            }
+        }
+        omb_papi_stop_and_print(&papi_eventset, size);
+        latency = (double)(timer * 1e6) / options.iterations;
+
+        omb_skew_stats();
+        omb_per_rank_stats(size, latency, 1);
+        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
+                MPI_COMM_WORLD));
+        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
+                MPI_COMM_WORLD));
+        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
+                MPI_COMM_WORLD));
+        avg_time = avg_time / numprocs;
+
+        print_stats(rank, size, avg_time, min_time, max_time);
+        if (options.graph && 0 == rank) {
+            omb_graph_data->avg = avg_time;
+        }
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+    }
+    if (0 == rank && options.graph) {
+        omb_graph_plot(&omb_graph_options, benchmark_name);
+    }
+    omb_graph_combined_plot(&omb_graph_options, benchmark_name);
+    omb_graph_free_data_buffers(&omb_graph_options);
+    omb_papi_free(&papi_eventset);
+
+    free_buffer(sendbuf, options.accel);
+    free_buffer(recvbuf, options.accel);
+    MPI_CHECK(MPI_Comm_free(&graph_comm));
+
+    MPI_CHECK(MPI_Finalize());
+
+    return EXIT_SUCCESS;
+}
+/* vi: set sw=4 sts=4 tw=80: */
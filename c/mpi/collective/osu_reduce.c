@@ -10,6 +10,8 @@
  */
 #include <osu_util_mpi.h>
 
+static double reduce_sweep_run(MPI_Comm comm, size_t count, void *arg);
+
 int main(int argc, char *argv[])
 {
     int i, j, numprocs, rank, size;
@@ -17,18 +19,36 @@ int main(int argc, char *argv[])
     double timer=0.0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     float *sendbuf, *recvbuf;
+    void *sendptr = NULL;
     int po_ret;
     int errors = 0, local_errors = 0;
     size_t bufsize;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
+    omb_ref_t ref;
+    MPI_Datatype reduce_datatype = MPI_FLOAT;
+    MPI_Op reduce_op = MPI_SUM;
+    size_t reduce_size = sizeof(float);
+    float *sweep_bufs[2];
+    int sweep_ret = 0;
 
     set_header(HEADER);
     set_benchmark_name("osu_reduce");
 
     options.bench = COLLECTIVE;
     options.subtype = REDUCE;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_ref_algo = OMB_REF_HIER;
+    options.show_in_place = 1;
+    options.show_reduce_types = 1;
 
     po_ret = process_options(argc, argv);
 
@@ -70,7 +90,8 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
-    options.min_message_size /= sizeof(float);
+    omb_reduction_get(&reduce_datatype, &reduce_op, &reduce_size);
+    options.min_message_size /= reduce_size;
     if (options.min_message_size < MIN_MESSAGE_SIZE) {
         options.min_message_size = MIN_MESSAGE_SIZE;
     }
@@ -91,10 +112,34 @@ int main(int argc, char *argv[])
     }
     set_buffer(sendbuf, options.accel, 0, bufsize);
 
+    if (options.reduce_sweep) {
+        sweep_bufs[0] = sendbuf;
+        sweep_bufs[1] = recvbuf;
+        sweep_ret = omb_reduction_sweep(reduce_size, reduce_sweep_run,
+                sweep_bufs, MPI_COMM_WORLD);
+        free_buffer(recvbuf, options.accel);
+        free_buffer(sendbuf, options.accel);
+        MPI_CHECK(MPI_Finalize());
+
+        if (NONE != options.accel) {
+            if (cleanup_accel()) {
+                fprintf(stderr, "Error cleaning up device\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return sweep_ret ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    sendptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : sendbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
+    omb_ref_init(&ref, options.max_message_size, options.max_message_size,
+            MPI_COMM_WORLD);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
-    for (size = options.min_message_size; size * sizeof(float) <=
+    for (size = options.min_message_size; size * reduce_size <=
             options.max_message_size; size *= 2) {
         if (size > LARGE_MESSAGE_SIZE) {
             options.skip = options.skip_large;
@@ -102,11 +147,23 @@ int main(int argc, char *argv[])
         }
 
         omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
-                &omb_graph_options, size * sizeof(float), options.iterations);
+                &omb_graph_options, size * reduce_size, options.iterations);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
         timer=0.0;
 
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_REDUCE, comm_shape.comm);
+            coll_args.sendbuf = sendptr;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = size;
+            coll_args.sendtype = reduce_datatype;
+            coll_args.op = reduce_op;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
+
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
                 omb_papi_start(&papi_eventset);
@@ -120,18 +177,33 @@ int main(int argc, char *argv[])
                             i);
                 }
                 for (j = 0; j < options.warmup_validation; j++) {
+                    if (0 == rank) {
+                        omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
+                    }
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Reduce(sendbuf, recvbuf, size, MPI_FLOAT,
-                                MPI_SUM, 0, MPI_COMM_WORLD ));
+                    MPI_CHECK(MPI_Reduce(sendptr, recvbuf, size,
+                                reduce_datatype, reduce_op, 0,
+                                comm_shape.comm));
+                }
+                if (0 == rank) {
+                    omb_inplace_seed(recvbuf, sendbuf, size * reduce_size);
                 }
             }
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
 
-            MPI_CHECK(MPI_Reduce(sendbuf, recvbuf, size, MPI_FLOAT, MPI_SUM, 0,
-                        MPI_COMM_WORLD ));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Reduce(sendptr, recvbuf, size,
+                            reduce_datatype, reduce_op, 0, comm_shape.comm));
+            }
             t_stop=MPI_Wtime();
+            omb_skew_record(i, t_stop);
 
             if (0 == rank) {
                 if (options.validate) {
@@ -148,31 +220,40 @@ int main(int argc, char *argv[])
                 }
             }
         }
-        omb_papi_stop_and_print(&papi_eventset, size * sizeof(float));
+        omb_papi_stop_and_print(&papi_eventset, size * reduce_size);
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time/numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size * reduce_size, latency,
+                &avg_time, &min_time, &max_time);
+        if (options.ref_algo) {
+            omb_coll_args_init(&coll_args, OMB_COLL_REDUCE, MPI_COMM_WORLD);
+            coll_args.sendbuf = sendbuf;
+            coll_args.recvbuf = recvbuf;
+            coll_args.sendcount = size;
+            coll_args.sendtype = reduce_datatype;
+            coll_args.op = reduce_op;
+            omb_ref_time(&ref, &coll_args, size, &local_errors);
+        }
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
                         MPI_COMM_WORLD));
         }
 
         if (options.validate) {
-            print_stats_validate(rank, size * sizeof(float), avg_time, min_time,
+            print_stats_validate(rank, size * reduce_size, avg_time, min_time,
                     max_time, errors);
         } else {
-            print_stats(rank, size * sizeof(float), avg_time, min_time,
+            print_stats(rank, size * reduce_size, avg_time, min_time,
                     max_time);
         }
         if (options.graph && 0 == rank) {
             omb_graph_data->avg = avg_time;
         }
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         if (0 != errors) {
             break;
@@ -184,10 +265,13 @@ int main(int argc, char *argv[])
     omb_graph_combined_plot(&omb_graph_options, benchmark_name);
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
+    omb_reduction_free();
 
     free_buffer(recvbuf, options.accel);
     free_buffer(sendbuf, options.accel);
 
+    omb_ref_free(&ref);
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
@@ -203,3 +287,42 @@ int main(int argc, char *argv[])
     }
     return EXIT_SUCCESS;
 }
+
+/*
+ * One size of the datatype sweep: the timed loop above on comm with the
+ * current datatype and op, returning the latency averaged over all ranks
+ * (valid on rank 0).
+ */
+static double reduce_sweep_run(MPI_Comm comm, size_t count, void *arg)
+{
+    float **bufs = arg;
+    double t_start = 0.0, t_stop = 0.0, timer = 0.0;
+    double latency = 0.0, avg_time = 0.0;
+    int i, numprocs, iterations = options.iterations, skip = options.skip;
+    MPI_Datatype datatype;
+    MPI_Op op;
+    size_t unit;
+
+    if (count > LARGE_MESSAGE_SIZE) {
+        iterations = options.iterations_large;
+        skip = options.skip_large;
+    }
+
+    omb_reduction_get(&datatype, &op, &unit);
+    MPI_CHECK(MPI_Comm_size(comm, &numprocs));
+    MPI_CHECK(MPI_Barrier(comm));
+    for (i = 0; i < iterations + skip; i++) {
+        MPI_CHECK(MPI_Barrier(comm));
+        t_start = MPI_Wtime();
+        MPI_CHECK(MPI_Reduce(bufs[0], bufs[1], count, datatype, op, 0, comm));
+        t_stop = MPI_Wtime();
+        if (i >= skip) {
+            timer += t_stop - t_start;
+        }
+    }
+    latency = (timer * 1e6) / iterations;
+    MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
+                comm));
+
+    return avg_time / numprocs;
+}
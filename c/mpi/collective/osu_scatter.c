@@ -18,12 +18,17 @@ main (int argc, char *argv[])
     double timer=0.0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     char * sendbuf = NULL, * recvbuf = NULL;
+    void *recvptr = NULL;
     int po_ret;
     int errors = 0, local_errors = 0;
     size_t bufsize;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
+    int root_buffers = 0;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
@@ -33,6 +38,12 @@ main (int argc, char *argv[])
 
     options.bench = COLLECTIVE;
     options.subtype = SCATTER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_in_place = 1;
 
     po_ret = process_options(argc, argv);
 
@@ -74,7 +85,9 @@ main (int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
-    if (0 == rank) {
+    /* Under -K the root of every group needs the root buffers */
+    root_buffers = 0 == rank || OMB_SHAPE_WORLD != options.comm_shape;
+    if (root_buffers) {
         bufsize = options.max_message_size * numprocs;
         if (allocate_memory_coll((void**)&sendbuf, bufsize, options.accel)) {
             fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
@@ -90,6 +103,10 @@ main (int argc, char *argv[])
     }
     set_buffer(recvbuf, options.accel, 0, options.max_message_size);
 
+    recvptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : recvbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
@@ -107,6 +124,16 @@ main (int argc, char *argv[])
         timer=0.0;
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR,
                 size);
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_SCATTER, comm_shape.comm);
+            coll_args.sendbuf = sendbuf;
+            coll_args.recvbuf = recvptr;
+            coll_args.sendcount = coll_args.recvcount = omb_ddt_size;
+            coll_args.sendtype = coll_args.recvtype = omb_ddt_datatype;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
 
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
@@ -117,17 +144,25 @@ main (int argc, char *argv[])
                 for (j = 0; j < options.warmup_validation; j++) {
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
                     MPI_CHECK(MPI_Scatter(sendbuf, omb_ddt_size,
-                                omb_ddt_datatype, recvbuf, omb_ddt_size,
-                                omb_ddt_datatype, 0, MPI_COMM_WORLD));
+                                omb_ddt_datatype, recvptr, omb_ddt_size,
+                                omb_ddt_datatype, 0, comm_shape.comm));
                 }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Scatter(sendbuf, omb_ddt_size, omb_ddt_datatype,
-                        recvbuf, omb_ddt_size, omb_ddt_datatype, 0,
-                        MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Scatter(sendbuf, omb_ddt_size,
+                            omb_ddt_datatype, recvptr, omb_ddt_size,
+                            omb_ddt_datatype, 0, comm_shape.comm));
+            }
             t_stop = MPI_Wtime();
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (i >= options.skip) {
@@ -139,20 +174,17 @@ main (int argc, char *argv[])
             }
 
             if (options.validate) {
-                local_errors += validate_data(recvbuf, size, numprocs,
-                        options.accel, i);
+                local_errors += validate_data(MPI_IN_PLACE == recvptr ?
+                        sendbuf : recvbuf, size, numprocs, options.accel, i);
             }
         }
         omb_papi_stop_and_print(&papi_eventset, size);
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time/numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
 
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
@@ -169,6 +201,9 @@ main (int argc, char *argv[])
             omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
@@ -183,11 +218,12 @@ main (int argc, char *argv[])
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
 
-    if (0 == rank) {
+    if (root_buffers) {
         free_buffer(sendbuf, options.accel);
     }
     free_buffer(recvbuf, options.accel);
 
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
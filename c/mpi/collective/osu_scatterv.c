@@ -17,13 +17,18 @@ int main(int argc, char *argv[])
     double timer=0.0;
     double avg_time = 0.0, max_time = 0.0, min_time = 0.0;
     char *sendbuf, *recvbuf;
+    void *recvptr = NULL;
     int *sdispls=NULL, *sendcounts=NULL;
     int po_ret;
     int errors = 0, local_errors = 0;
-    size_t bufsize;
+    size_t bufsize, vbufsize;
     MPI_Datatype omb_ddt_datatype = MPI_CHAR;
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
+    omb_coll_args_t coll_args;
+    MPI_Request persistent_request = MPI_REQUEST_NULL;
+    omb_comm_shape_t comm_shape;
+    int root_buffers = 0;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
     int papi_eventset = OMB_PAPI_NULL;
@@ -33,6 +38,13 @@ int main(int argc, char *argv[])
 
     options.bench = COLLECTIVE;
     options.subtype = SCATTER;
+    options.show_skew = 1;
+    options.show_per_rank = 1;
+    options.show_throughput = OMB_THROUGHPUT_INDEP;
+    options.show_persistent = 1;
+    options.show_comm_shape = 1;
+    options.show_in_place = 1;
+    options.show_vcounts = 1;
 
     po_ret = process_options(argc, argv);
 
@@ -74,7 +86,11 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
     check_mem_limit(numprocs);
-    if (0 == rank) {
+    omb_vcounts_init(MPI_COMM_WORLD);
+    vbufsize = omb_vcounts_bufsize(options.max_message_size);
+    /* Under -K the root of every group needs the root buffers */
+    root_buffers = 0 == rank || OMB_SHAPE_WORLD != options.comm_shape;
+    if (root_buffers) {
         if (allocate_memory_coll((void**)&sendcounts, numprocs * sizeof(int),
                     NONE)) {
             fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
@@ -86,7 +102,7 @@ int main(int argc, char *argv[])
             MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
         }
 
-        bufsize = options.max_message_size * numprocs;
+        bufsize = MAX(options.max_message_size * numprocs, vbufsize);
         if (allocate_memory_coll((void**)&sendbuf, bufsize, options.accel)) {
             fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
             MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
@@ -94,13 +110,17 @@ int main(int argc, char *argv[])
         set_buffer(sendbuf, options.accel, 1, bufsize);
     }
 
-    if (allocate_memory_coll((void**)&recvbuf, options.max_message_size,
-                options.accel)) {
+    bufsize = MAX(options.max_message_size, vbufsize);
+    if (allocate_memory_coll((void**)&recvbuf, bufsize, options.accel)) {
         fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
         MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
     }
-    set_buffer(recvbuf, options.accel, 0, options.max_message_size);
+    set_buffer(recvbuf, options.accel, 0, bufsize);
 
+    recvptr = (options.in_place && 0 == rank) ? MPI_IN_PLACE : recvbuf;
+    omb_inplace_footprint(0 == rank ? options.max_message_size : 0,
+            MPI_COMM_WORLD);
+    omb_comm_shape_create(&comm_shape);
     print_preamble(rank);
     omb_papi_init(&papi_eventset);
 
@@ -114,7 +134,7 @@ int main(int argc, char *argv[])
 
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
-        if (0 == rank) {
+        if (root_buffers) {
             disp =0;
             for ( i = 0; i < numprocs; i++) {
                 sendcounts[i] = omb_ddt_size;
@@ -122,6 +142,10 @@ int main(int argc, char *argv[])
                 disp += omb_ddt_size;
             }
         }
+        if (options.vcounts) {
+            omb_ddt_size = omb_vcounts_fill(size, sendcounts, sdispls, NULL,
+                    NULL);
+        }
 
         omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
                 &omb_graph_options, size, options.iterations);
@@ -130,6 +154,19 @@ int main(int argc, char *argv[])
         timer=0.0;
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR,
                 size);
+        if (options.persistent || options.throughput) {
+            omb_coll_args_init(&coll_args, OMB_COLL_SCATTERV,
+                    comm_shape.comm);
+            coll_args.sendbuf = sendbuf;
+            coll_args.recvbuf = recvptr;
+            coll_args.sendcounts = sendcounts;
+            coll_args.sdispls = sdispls;
+            coll_args.recvcount = omb_ddt_size;
+            coll_args.sendtype = coll_args.recvtype = omb_ddt_datatype;
+            if (options.persistent) {
+                omb_persistent_init(&coll_args, &persistent_request);
+            }
+        }
 
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
@@ -140,23 +177,32 @@ int main(int argc, char *argv[])
                 for (j = 0; j < options.warmup_validation; j++) {
                     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
                     MPI_CHECK(MPI_Scatterv(sendbuf, sendcounts, sdispls,
-                                omb_ddt_datatype, recvbuf, omb_ddt_size,
-                                omb_ddt_datatype, 0, MPI_COMM_WORLD));
+                                omb_ddt_datatype, recvptr, omb_ddt_size,
+                                omb_ddt_datatype, 0, comm_shape.comm));
                 }
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
             }
 
+            omb_skew_delay();
+
             t_start = MPI_Wtime();
-            MPI_CHECK(MPI_Scatterv(sendbuf, sendcounts, sdispls,
-                        omb_ddt_datatype, recvbuf, omb_ddt_size,
-                        omb_ddt_datatype, 0, MPI_COMM_WORLD));
+            if (options.persistent) {
+                MPI_CHECK(MPI_Start(&persistent_request));
+                MPI_CHECK(MPI_Wait(&persistent_request, MPI_STATUS_IGNORE));
+            } else {
+                MPI_CHECK(MPI_Scatterv(sendbuf, sendcounts, sdispls,
+                            omb_ddt_datatype, recvptr, omb_ddt_size,
+                            omb_ddt_datatype, 0, comm_shape.comm));
+            }
 
             t_stop = MPI_Wtime();
+
+            omb_skew_record(i, t_stop);
             MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
             if (options.validate) {
-                local_errors += validate_data(recvbuf, size, numprocs,
-                        options.accel, i);
+                local_errors += validate_data(MPI_IN_PLACE == recvptr ?
+                        sendbuf : recvbuf, size, numprocs, options.accel, i);
             }
 
             if (i >= options.skip) {
@@ -170,13 +216,10 @@ int main(int argc, char *argv[])
         omb_papi_stop_and_print(&papi_eventset, size);
         latency = (double)(timer * 1e6) / options.iterations;
 
-        MPI_CHECK(MPI_Reduce(&latency, &min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
-                MPI_COMM_WORLD));
-        MPI_CHECK(MPI_Reduce(&latency, &avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
-                MPI_COMM_WORLD));
-        avg_time = avg_time/numprocs;
+        omb_throughput_time(&coll_args);
+        omb_skew_stats();
+        omb_comm_shape_stats(&comm_shape, size, latency, &avg_time,
+                &min_time, &max_time);
 
         if (options.validate) {
             MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT, MPI_SUM,
@@ -193,6 +236,9 @@ int main(int argc, char *argv[])
             omb_graph_data->avg = avg_time;
         }
         omb_ddt_append_stats(omb_ddt_transmit_size);
+        if (options.persistent) {
+            MPI_CHECK(MPI_Request_free(&persistent_request));
+        }
         omb_ddt_free(&omb_ddt_datatype);
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
@@ -207,13 +253,15 @@ int main(int argc, char *argv[])
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
 
-    if (0 == rank) {
+    if (root_buffers) {
         free_buffer(sendcounts, NONE);
         free_buffer(sdispls, NONE);
         free_buffer(sendbuf, options.accel);
     }
     free_buffer(recvbuf, options.accel);
 
+    omb_vcounts_free();
+    omb_comm_shape_free(&comm_shape);
     MPI_CHECK(MPI_Finalize());
 
     if (NONE != options.accel) {
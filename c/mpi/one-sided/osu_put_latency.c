@@ -23,6 +23,7 @@ void run_put_with_pscw (int, enum WINDOW);
 void run_put_with_lock_all (int, enum WINDOW);
 void run_put_with_flush (int, enum WINDOW);
 void run_put_with_flush_local (int, enum WINDOW);
+void run_put_soak (int, enum WINDOW);
 #endif
 
 int main (int argc, char *argv[])
@@ -33,6 +34,7 @@ int main (int argc, char *argv[])
 #if MPI_VERSION >= 3
     options.win = WIN_ALLOCATE;
     options.sync = FLUSH;
+    options.show_soak = 1;
 #else
     options.win = WIN_CREATE;
     options.sync = LOCK;
@@ -104,6 +106,31 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+#if MPI_VERSION >= 3
+    if (options.soak_duration > 0) {
+        if (FLUSH != options.sync) {
+            if (rank == 0) {
+                fprintf(stderr, "Soak mode requires the flush "
+                        "synchronization\n");
+            }
+            MPI_CHECK(MPI_Finalize());
+
+            return EXIT_FAILURE;
+        }
+
+        run_put_soak(rank, options.win);
+        MPI_CHECK(MPI_Finalize());
+
+        if (NONE != options.accel) {
+            if (cleanup_accel()) {
+                fprintf(stderr, "Error cleaning up device\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+#endif
+
     print_header_one_sided(rank, options.win, options.sync);
 
     switch (options.sync) {
@@ -285,6 +312,52 @@ void run_put_with_flush (int rank, enum WINDOW type)
     omb_papi_free(&papi_eventset);
 }
 
+/*Run PUT with flush at a single message size until the soak duration expires */
+void run_put_soak (int rank, enum WINDOW type)
+{
+    size_t size = options.max_message_size;
+    int i;
+    omb_soak_t soak;
+    MPI_Aint disp = 0;
+    MPI_Win     win;
+
+    allocate_memory_one_sided(rank, &sbuf, &win_base, size, type, &win);
+
+    if (type == WIN_DYNAMIC) {
+        disp = disp_remote;
+    }
+
+    if (size > LARGE_MESSAGE_SIZE) {
+        options.iterations = options.iterations_large;
+        options.skip = options.skip_large;
+    }
+
+    omb_soak_init(&soak, size, "Latency(us)", 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        MPI_CHECK(MPI_Win_lock(MPI_LOCK_SHARED, 1, 0, win));
+    }
+    do {
+        if (rank == 0) {
+            for (i = 0; i < options.skip + options.iterations; i++) {
+                t_start = MPI_Wtime();
+                MPI_CHECK(MPI_Put(sbuf, size, MPI_CHAR, 1, disp, size,
+                            MPI_CHAR, win));
+                MPI_CHECK(MPI_Win_flush(1, win));
+                if (i >= options.skip) {
+                    omb_soak_record(&soak, (MPI_Wtime() - t_start) * 1.0e6);
+                }
+            }
+        }
+        /* Only the first batch warms up */
+        options.skip = 0;
+    } while (omb_soak_continue(&soak, MPI_COMM_WORLD));
+    if (rank == 0) {
+        MPI_CHECK(MPI_Win_unlock(1, win));
+    }
+
+    free_memory_one_sided (sbuf, win_base, type, win, rank);
+}
+
 /*Run PUT with Lock_all/unlock_all */
 void run_put_with_lock_all (int rank, enum WINDOW type)
 {
@@ -11,16 +11,16 @@
 #include <osu_util_mpi.h>
 
 #ifdef _ENABLE_CUDA_KERNEL_
-double measure_kernel_lo(char **, int, int);
-void touch_managed_src(char **, int, int);
-void touch_managed_dst(char **, int, int);
+double measure_kernel_lo(char **, size_t, int);
+void touch_managed_src(char **, size_t, int);
+void touch_managed_dst(char **, size_t, int);
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
 double calculate_total(double, double, double, int);
 
 int main(int argc, char *argv[])
 {
     int myid, numprocs, i, j, k;
-    int size;
+    size_t size;
     char **s_buf, **r_buf;
     double t_start = 0.0, t_end = 0.0, t_lo = 0.0, t_total = 0.0;
     int window_size = 64;
@@ -118,6 +118,7 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    check_mem_limit(numprocs);
     if (options.buf_num == SINGLE) {
         if (allocate_memory_pt2pt(&s_buf[0], &r_buf[0], myid)) {
             /* Error allocating memory */
@@ -201,11 +202,11 @@ int main(int argc, char *argv[])
 
                     for (j = 0; j < window_size; j++) {
                         if (options.buf_num == SINGLE) {
-                            MPI_CHECK(MPI_Irecv(r_buf[0], omb_ddt_size,
+                            MPI_CHECK(omb_large_irecv(r_buf[0], omb_ddt_size,
                                         omb_ddt_datatype, 1, 10,
                                         MPI_COMM_WORLD, recv_request + j));
                         } else {
-                            MPI_CHECK(MPI_Irecv(r_buf[j], omb_ddt_size,
+                            MPI_CHECK(omb_large_irecv(r_buf[j], omb_ddt_size,
                                         omb_ddt_datatype, 1, 10,
                                         MPI_COMM_WORLD, recv_request + j));
                         }
@@ -213,11 +214,11 @@ int main(int argc, char *argv[])
 
                     for (j = 0; j < window_size; j++) {
                         if (options.buf_num == SINGLE) {
-                            MPI_CHECK(MPI_Isend(s_buf[0],  omb_ddt_size,
+                            MPI_CHECK(omb_large_isend(s_buf[0],  omb_ddt_size,
                                         omb_ddt_datatype, 1, 100,
                                         MPI_COMM_WORLD, send_request + j));
                         } else {
-                            MPI_CHECK(MPI_Isend(s_buf[j], omb_ddt_size,
+                            MPI_CHECK(omb_large_isend(s_buf[j], omb_ddt_size,
                                         omb_ddt_datatype, 1, 100,
                                         MPI_COMM_WORLD, send_request + j));
                         }
@@ -258,11 +259,11 @@ int main(int argc, char *argv[])
 
                     for (j = 0; j < window_size; j++) {
                         if (options.buf_num == SINGLE) {
-                            MPI_CHECK(MPI_Irecv(r_buf[0], omb_ddt_size,
+                            MPI_CHECK(omb_large_irecv(r_buf[0], omb_ddt_size,
                                         omb_ddt_datatype, 0, 100,
                                         MPI_COMM_WORLD, recv_request + j));
                         } else {
-                            MPI_CHECK(MPI_Irecv(r_buf[j], omb_ddt_size,
+                            MPI_CHECK(omb_large_irecv(r_buf[j], omb_ddt_size,
                                         omb_ddt_datatype, 0, 100,
                                         MPI_COMM_WORLD, recv_request + j));
                         }
@@ -270,11 +271,11 @@ int main(int argc, char *argv[])
 
                     for (j = 0; j < window_size; j++) {
                         if (options.buf_num == SINGLE) {
-                            MPI_CHECK(MPI_Isend(s_buf[0], omb_ddt_size,
+                            MPI_CHECK(omb_large_isend(s_buf[0], omb_ddt_size,
                                         omb_ddt_datatype, 0, 10,
                                         MPI_COMM_WORLD, send_request + j));
                         } else {
-                            MPI_CHECK(MPI_Isend(s_buf[j], omb_ddt_size,
+                            MPI_CHECK(omb_large_isend(s_buf[j], omb_ddt_size,
                                         omb_ddt_datatype, 0, 10,
                                         MPI_COMM_WORLD, send_request + j));
                         }
@@ -314,7 +315,7 @@ int main(int argc, char *argv[])
             } else {
                 tmp_total = size / 1e6 * options.iterations * window_size * 2;
             }
-            fprintf(stdout, "%-*d", 10, size);
+            fprintf(stdout, "%-*zu", 10, size);
             if (options.validate) {
                 fprintf(stdout, "%*.*f%*s", FIELD_WIDTH, FLOAT_PRECISION,
                         tmp_total / t_total, FIELD_WIDTH,
@@ -370,7 +371,7 @@ int main(int argc, char *argv[])
     }
     if (0 != errors && options.validate && 0 == myid) {
         fprintf(stdout, "DATA VALIDATION ERROR: %s exited with status %d on"
-                " message size %d.\n", argv[0], EXIT_FAILURE, size);
+                " message size %zu.\n", argv[0], EXIT_FAILURE, size);
         exit(EXIT_FAILURE);
     }
 
@@ -379,7 +380,7 @@ int main(int argc, char *argv[])
 
 #ifdef _ENABLE_CUDA_KERNEL_
 double
-measure_kernel_lo(char **buf, int size, int window_size)
+measure_kernel_lo(char **buf, size_t size, int window_size)
 {
     int i;
     double t_lo = 0.0, t_start, t_end;
@@ -401,7 +402,7 @@ measure_kernel_lo(char **buf, int size, int window_size)
 }
 
 void
-touch_managed_src(char **buf, int size, int window_size)
+touch_managed_src(char **buf, size_t size, int window_size)
 {
     int j;
 
@@ -427,7 +428,7 @@ touch_managed_src(char **buf, int size, int window_size)
 }
 
 void
-touch_managed_dst(char **buf, int size, int window_size)
+touch_managed_dst(char **buf, size_t size, int window_size)
 {
     int j;
 
@@ -12,17 +12,18 @@
 #include <osu_util_mpi.h>
 
 #ifdef _ENABLE_CUDA_KERNEL_
-double measure_kernel_lo(char **, int, int);
-void touch_managed_src(char **, int, int);
-void touch_managed_dst(char **, int, int);
+double measure_kernel_lo(char **, size_t, int);
+void touch_managed_src(char **, size_t, int);
+void touch_managed_dst(char **, size_t, int);
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
 double calculate_total(double, double, double, int);
+static void bw_soak(int, char *, char *, size_t, int);
 
 int
 main (int argc, char *argv[])
 {
     int myid, numprocs, i, j, k;
-    int size;
+    size_t size;
     char **s_buf, **r_buf;
     double t_start = 0.0, t_end = 0.0, t_lo = 0.0, t_total = 0.0;
     int window_size = 64;
@@ -35,8 +36,15 @@ main (int argc, char *argv[])
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
     int papi_eventset = OMB_PAPI_NULL;
+    omb_ipc_t ipc;
+    double shm_floor = 0.0, cma_floor = 0.0;
+    double t_touch = 0.0, t_touch_start = 0.0, t_touch_peer = 0.0;
+    int touch_bufs = 1;
     options.bench = PT2PT;
     options.subtype = BW;
+    options.show_soak = 1;
+    options.show_ipc_floor = 1;
+    options.show_touch_data = 1;
 
     set_header(HEADER);
     set_benchmark_name("osu_bw");
@@ -121,6 +129,10 @@ main (int argc, char *argv[])
     }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
 
+    if (options.soak_duration > 0) {
+        options.buf_num = SINGLE;
+    }
+    check_mem_limit(numprocs);
     if (options.buf_num == SINGLE) {
         if (allocate_memory_pt2pt(&s_buf[0], &r_buf[0], myid)) {
             /* Error allocating memory */
@@ -129,6 +141,33 @@ main (int argc, char *argv[])
         }
     }
 
+    if (options.soak_duration > 0) {
+        bw_soak(myid, s_buf[0], r_buf[0], options.max_message_size,
+                window_size);
+        free_memory(s_buf[0], r_buf[0], myid);
+        free(s_buf);
+        free(r_buf);
+        MPI_CHECK(MPI_Finalize());
+
+        if (NONE != options.accel) {
+            if (cleanup_accel()) {
+                fprintf(stderr, "Error cleaning up device\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (options.ipc_floor && omb_ipc_init(&ipc, 1 - myid,
+                options.max_message_size, MPI_COMM_WORLD)) {
+        if (0 == myid) {
+            fprintf(stderr, "IPC floor skipped: ranks do not share a node or"
+                    " the shared segment could not be mapped\n");
+        }
+        omb_ipc_free(&ipc);
+        options.ipc_floor = 0;
+    }
+
     print_header(myid, BW);
     omb_papi_init(&papi_eventset);
 
@@ -173,9 +212,12 @@ main (int argc, char *argv[])
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         t_total = 0.0;
 
+        /* Each distinct buffer is touched once per window */
+        touch_bufs = options.buf_num == SINGLE ? 1 : window_size;
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
                 omb_papi_start(&papi_eventset);
+                t_touch = 0.0;
             }
             if (options.validate) {
                 if (options.buf_num == MULTIPLE) {
@@ -200,14 +242,21 @@ main (int argc, char *argv[])
                         touch_managed_src(s_buf, size, window_size);
                     }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
+                    if (options.touch_data) {
+                        t_touch_start = MPI_Wtime();
+                        for (j = 0; j < touch_bufs; j++) {
+                            omb_touch_produce(s_buf[j], size, i);
+                        }
+                        t_touch += MPI_Wtime() - t_touch_start;
+                    }
 
                     for (j = 0; j < window_size; j++) {
                         if (options.buf_num == SINGLE) {
-                            MPI_CHECK(MPI_Isend(s_buf[0], omb_ddt_size,
+                            MPI_CHECK(omb_large_isend(s_buf[0], omb_ddt_size,
                                         omb_ddt_datatype, 1, 100,
                                         MPI_COMM_WORLD, request + j));
                         } else {
-                            MPI_CHECK(MPI_Isend(s_buf[j], omb_ddt_size,
+                            MPI_CHECK(omb_large_isend(s_buf[j], omb_ddt_size,
                                         omb_ddt_datatype, 1, 100,
                                         MPI_COMM_WORLD, request + j));
                         }
@@ -254,11 +303,11 @@ main (int argc, char *argv[])
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
                     for (j = 0; j < window_size; j++) {
                         if (options.buf_num == SINGLE) {
-                            MPI_CHECK(MPI_Irecv(r_buf[0], omb_ddt_size,
+                            MPI_CHECK(omb_large_irecv(r_buf[0], omb_ddt_size,
                                         omb_ddt_datatype, 0, 100,
                                         MPI_COMM_WORLD, request + j));
                         } else {
-                            MPI_CHECK(MPI_Irecv(r_buf[j], omb_ddt_size,
+                            MPI_CHECK(omb_large_irecv(r_buf[j], omb_ddt_size,
                                         omb_ddt_datatype, 0, 100,
                                         MPI_COMM_WORLD, request + j));
                         }
@@ -270,6 +319,13 @@ main (int argc, char *argv[])
                         touch_managed_dst(r_buf, size, window_size);
                     }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
+                    if (options.touch_data) {
+                        t_touch_start = MPI_Wtime();
+                        for (j = 0; j < touch_bufs; j++) {
+                            omb_touch_consume(r_buf[j], size);
+                        }
+                        t_touch += MPI_Wtime() - t_touch_start;
+                    }
 
                     MPI_CHECK(MPI_Send(s_buf[0], 4, MPI_CHAR, 0, 101,
                                 MPI_COMM_WORLD));
@@ -291,6 +347,26 @@ main (int argc, char *argv[])
         }
         omb_papi_stop_and_print(&papi_eventset, size);
 
+        /* The receiver consumes before acknowledging, so both count */
+        if (options.touch_data) {
+            if (myid == 0) {
+                MPI_CHECK(MPI_Recv(&t_touch_peer, 1, MPI_DOUBLE, 1, 103,
+                            MPI_COMM_WORLD, &reqstat[0]));
+            } else if (myid == 1) {
+                MPI_CHECK(MPI_Send(&t_touch, 1, MPI_DOUBLE, 0, 103,
+                            MPI_COMM_WORLD));
+            }
+        }
+
+        if (options.ipc_floor) {
+            shm_floor = omb_ipc_bandwidth(&ipc, OMB_IPC_SHM, size,
+                    window_size);
+            if (ipc.cma) {
+                cma_floor = omb_ipc_bandwidth(&ipc, OMB_IPC_CMA, size,
+                        window_size);
+            }
+        }
+
         if (myid == 0) {
             if (options.omb_enable_ddt) {
                 tmp_total = omb_ddt_transmit_size / 1e6 * options.iterations *
@@ -298,18 +374,32 @@ main (int argc, char *argv[])
             } else {
                 tmp_total = size / 1e6 * options.iterations * window_size;
             }
-            fprintf(stdout, "%-*d", 10, size);
+            fprintf(stdout, "%-*zu", 10, size);
             if (options.validate) {
                 fprintf(stdout, "%*.*f%*s", FIELD_WIDTH, FLOAT_PRECISION,
                         tmp_total / t_total, FIELD_WIDTH,
                         VALIDATION_STATUS(errors));
             } else{
                 fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
-                        tmp_total / t_total);
+                        tmp_total / (t_total - t_touch - t_touch_peer));
             }
             if (options.omb_enable_ddt) {
                 fprintf(stdout, "%*zu", FIELD_WIDTH, omb_ddt_transmit_size);
             }
+            if (options.touch_data) {
+                fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                        tmp_total / t_total);
+            }
+            if (options.ipc_floor) {
+                fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                        shm_floor);
+                if (ipc.cma) {
+                    fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                            cma_floor);
+                } else {
+                    fprintf(stdout, "%*s", FIELD_WIDTH, "N/A");
+                }
+            }
             fprintf(stdout, "\n");
             fflush(stdout);
             if (options.graph && 0 == myid) {
@@ -336,6 +426,9 @@ main (int argc, char *argv[])
     omb_graph_combined_plot(&omb_graph_options, benchmark_name);
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
+    if (options.ipc_floor) {
+        omb_ipc_free(&ipc);
+    }
 
     if (options.buf_num == SINGLE) {
         free_memory(s_buf[0], r_buf[0], myid);
@@ -354,14 +447,14 @@ main (int argc, char *argv[])
 
     if (0 != errors && options.validate && 0 == myid) {
         fprintf(stdout, "DATA VALIDATION ERROR: %s exited with status %d on"
-                " message size %d.\n", argv[0], EXIT_FAILURE, size);
+                " message size %zu.\n", argv[0], EXIT_FAILURE, size);
         exit(EXIT_FAILURE);
     }
     return EXIT_SUCCESS;
 }
 
 #ifdef _ENABLE_CUDA_KERNEL_
-double measure_kernel_lo(char **buf, int size, int window_size)
+double measure_kernel_lo(char **buf, size_t size, int window_size)
 {
     int i;
     double t_lo = 0.0, t_start, t_end;
@@ -382,7 +475,7 @@ double measure_kernel_lo(char **buf, int size, int window_size)
     return t_lo;
 }
 
-void touch_managed_src(char **buf, int size, int window_size)
+void touch_managed_src(char **buf, size_t size, int window_size)
 {
     int j;
 
@@ -407,7 +500,7 @@ void touch_managed_src(char **buf, int size, int window_size)
     }
 }
 
-void touch_managed_dst(char **buf, int size, int window_size)
+void touch_managed_dst(char **buf, size_t size, int window_size)
 {
     int j;
 
@@ -433,6 +526,56 @@ void touch_managed_dst(char **buf, int size, int window_size)
 }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
 
+/*
+ * Stream windows at a single message size until the soak duration expires.
+ * Rank 0 records the bandwidth of every window.
+ */
+static void bw_soak(int myid, char *s_buf, char *r_buf, size_t size,
+                    int window_size)
+{
+    omb_soak_t soak;
+    double t_start = 0.0;
+    int i, j;
+
+    set_buffer_pt2pt(s_buf, myid, options.accel, 'a', size);
+    set_buffer_pt2pt(r_buf, myid, options.accel, 'b', size);
+
+    if (size > LARGE_MESSAGE_SIZE) {
+        options.iterations = options.iterations_large;
+        options.skip = options.skip_large;
+    }
+
+    omb_soak_init(&soak, size, "BW(MB/s)", 1, MPI_COMM_WORLD);
+    do {
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            if (myid == 0) {
+                t_start = MPI_Wtime();
+                for (j = 0; j < window_size; j++) {
+                    MPI_CHECK(omb_large_isend(s_buf, size, MPI_CHAR, 1, 100,
+                                MPI_COMM_WORLD, request + j));
+                }
+                MPI_CHECK(MPI_Waitall(window_size, request, reqstat));
+                MPI_CHECK(MPI_Recv(r_buf, 4, MPI_CHAR, 1, 101,
+                            MPI_COMM_WORLD, &reqstat[0]));
+                if (i >= options.skip) {
+                    omb_soak_record(&soak, size / 1e6 * window_size /
+                            (MPI_Wtime() - t_start));
+                }
+            } else if (myid == 1) {
+                for (j = 0; j < window_size; j++) {
+                    MPI_CHECK(omb_large_irecv(r_buf, size, MPI_CHAR, 0, 100,
+                                MPI_COMM_WORLD, request + j));
+                }
+                MPI_CHECK(MPI_Waitall(window_size, request, reqstat));
+                MPI_CHECK(MPI_Send(s_buf, 4, MPI_CHAR, 0, 101,
+                            MPI_COMM_WORLD));
+            }
+        }
+        /* Only the first batch warms up */
+        options.skip = 0;
+    } while (omb_soak_continue(&soak, MPI_COMM_WORLD));
+}
+
 double calculate_total(double t_start, double t_end, double t_lo, int window_size)
 {
     double t_total;
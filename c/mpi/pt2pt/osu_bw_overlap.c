@@ -0,0 +1,206 @@
+#define BENCHMARK "OSU MPI%s Bandwidth Overlap Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+/*
+ * Rank 0 posts a window of MPI_Isend and rank 1 the matching MPI_Irecv,
+ * then both compute for as long as the pure window transfer takes before
+ * waiting. All times are per window.
+ */
+static void post_window(int myid, char *s_buf, char *r_buf, int size,
+                        MPI_Request *request);
+
+int main(int argc, char *argv[])
+{
+    int myid, numprocs, i, size;
+    char *s_buf, *r_buf;
+    double latency = 0.0, t_start = 0.0, t_stop = 0.0;
+    double test_time = 0.0, test_total = 0.0;
+    double tcomp = 0.0, tcomp_total = 0.0, latency_in_secs = 0.0;
+    double wait_time = 0.0, init_time = 0.0;
+    double init_total = 0.0, wait_total = 0.0;
+    double timer = 0.0;
+    MPI_Request *request = NULL;
+    MPI_Status *status = NULL;
+    int po_ret = 0;
+
+    options.bench = PT2PT;
+    options.subtype = BW_OVERLAP;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_bw_overlap");
+
+    po_ret = process_options(argc, argv);
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &myid));
+
+    if (0 == myid) {
+        switch (po_ret) {
+            case PO_BAD_USAGE:
+                print_bad_usage_message(myid);
+                break;
+            case PO_HELP_MESSAGE:
+                print_help_message(myid);
+                break;
+            case PO_VERSION_MESSAGE:
+                print_version_message(myid);
+                MPI_CHECK(MPI_Finalize());
+                exit(EXIT_SUCCESS);
+            case PO_OKAY:
+                break;
+        }
+    }
+
+    switch (po_ret) {
+        case PO_BAD_USAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+        case PO_VERSION_MESSAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    if (numprocs != 2) {
+        if (myid == 0) {
+            fprintf(stderr, "This test requires exactly two processes\n");
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    request = malloc(options.window_size * sizeof(MPI_Request));
+    status = malloc(options.window_size * sizeof(MPI_Status));
+    OMB_CHECK_NULL_AND_EXIT(request, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(status, "Unable to allocate memory");
+
+    if (allocate_memory_pt2pt(&s_buf, &r_buf, myid)) {
+        /* Error allocating memory */
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    /* Host arrays for the dummy compute */
+    allocate_host_arrays();
+
+    if (0 == myid) {
+        fprintf(stdout, "# Window size: %d, times are per window\n",
+                options.window_size);
+    }
+    print_preamble_nbc(myid);
+
+    for (size = options.min_message_size; size <= options.max_message_size;
+            size *= 2) {
+        set_buffer_pt2pt(s_buf, myid, options.accel, 'a', size);
+        set_buffer_pt2pt(r_buf, myid, options.accel, 'b', size);
+
+        if (size > LARGE_MESSAGE_SIZE) {
+            options.iterations = options.iterations_large;
+            options.skip = options.skip_large;
+        }
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        timer = 0.0;
+
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            t_start = MPI_Wtime();
+            post_window(myid, s_buf, r_buf, size, request);
+            MPI_CHECK(MPI_Waitall(options.window_size, request, status));
+            t_stop = MPI_Wtime();
+
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+            if (i >= options.skip) {
+                timer += t_stop - t_start;
+            }
+        }
+
+        /* This is the pure comm. time */
+        latency = (timer * 1e6) / options.iterations;
+
+        /* Comm. latency in seconds, fed to dummy_compute */
+        latency_in_secs = timer / options.iterations;
+
+        init_arrays(latency_in_secs);
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+        timer = 0.0; tcomp_total = 0.0; tcomp = 0.0;
+        init_total = 0.0; wait_total = 0.0;
+        test_time = 0.0, test_total = 0.0;
+
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            t_start = MPI_Wtime();
+
+            init_time = MPI_Wtime();
+            post_window(myid, s_buf, r_buf, size, request);
+            init_time = MPI_Wtime() - init_time;
+
+            tcomp = MPI_Wtime();
+            test_time = dummy_compute(latency_in_secs,
+                    &request[options.window_size - 1]);
+            tcomp = MPI_Wtime() - tcomp;
+
+            wait_time = MPI_Wtime();
+            MPI_CHECK(MPI_Waitall(options.window_size, request, status));
+            wait_time = MPI_Wtime() - wait_time;
+
+            t_stop = MPI_Wtime();
+
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+            if (i >= options.skip) {
+                timer += t_stop - t_start;
+                tcomp_total += tcomp;
+                init_total += init_time;
+                test_total += test_time;
+                wait_total += wait_time;
+            }
+        }
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+        calculate_and_print_stats(myid, size, numprocs, timer, latency,
+                                  test_total, tcomp_total, wait_total,
+                                  init_total, 0);
+    }
+
+    free(request);
+    free(status);
+    free_host_arrays();
+    free_memory(s_buf, r_buf, myid);
+    MPI_CHECK(MPI_Finalize());
+
+    return EXIT_SUCCESS;
+}
+
+static void post_window(int myid, char *s_buf, char *r_buf, int size,
+                        MPI_Request *request)
+{
+    int j;
+
+    for (j = 0; j < options.window_size; j++) {
+        if (0 == myid) {
+            MPI_CHECK(MPI_Isend(s_buf, size, MPI_CHAR, 1, 100,
+                        MPI_COMM_WORLD, request + j));
+        } else {
+            MPI_CHECK(MPI_Irecv(r_buf, size, MPI_CHAR, 0, 100,
+                        MPI_COMM_WORLD, request + j));
+        }
+    }
+}
+
+/* vi: set sw=4 sts=4 tw=80: */
@@ -0,0 +1,353 @@
+#define BENCHMARK "OSU MPI Congestion Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+/*
+ * All ranks stream windows of messages at the same time, each to the
+ * destination given by a global traffic pattern, and receive from the rank
+ * that targets them. Per-rank bandwidth of every trial is pooled on rank 0
+ * to report the distribution across ranks together with the aggregate
+ * bandwidth of the whole job.
+ */
+static char const *pattern_names[] = {
+    "random permutation",
+    "ring shift",
+    "bit complement",
+    "tornado",
+    "all-pairs rotation"
+};
+#define NUM_PATTERNS ((int)(sizeof(pattern_names) / sizeof(pattern_names[0])))
+
+static void build_pattern(int pattern, int phase, int trial, int nprocs,
+                          int *dest);
+static double run_trial(int pattern, int trial, int rank, int nprocs,
+                        int size, int *dest, char *s_buf, char *r_buf,
+                        MPI_Request *request, double *bytes);
+static void print_stats_congestion(int size, int nprocs, double aggregate,
+                                   double *samples, double *sorted);
+
+int
+main (int argc, char *argv[])
+{
+    int rank, nprocs, pattern, trial, size;
+    size_t iterations, skip;
+    int *dest = NULL;
+    char *s_buf, *r_buf;
+    double bw, bytes, elapsed, total_bytes, max_elapsed, aggregate;
+    double *samples = NULL, *sorted = NULL;
+    MPI_Request *request = NULL;
+    int po_ret = 0;
+
+    options.bench = PT2PT;
+    options.subtype = CONGESTION;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_congestion");
+
+    po_ret = process_options(argc, argv);
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &nprocs));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+
+    if (0 == rank) {
+        switch (po_ret) {
+            case PO_BAD_USAGE:
+                print_bad_usage_message(rank);
+                break;
+            case PO_HELP_MESSAGE:
+                print_help_message(rank);
+                break;
+            case PO_VERSION_MESSAGE:
+                print_version_message(rank);
+                MPI_CHECK(MPI_Finalize());
+                exit(EXIT_SUCCESS);
+            default:
+                break;
+        }
+    }
+
+    switch (po_ret) {
+        case PO_CUDA_NOT_AVAIL:
+        case PO_OPENACC_NOT_AVAIL:
+        case PO_BAD_USAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+        case PO_VERSION_MESSAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    if (nprocs < 2) {
+        if (0 == rank) {
+            fprintf(stderr, "This test requires at least two processes\n");
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    if (allocate_memory_pt2pt_mul_size(&s_buf, &r_buf, rank, nprocs,
+                options.max_message_size)) {
+        /* Error allocating memory */
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+    set_buffer_pt2pt_mul(s_buf, rank, options.accel, 'a',
+            options.max_message_size, nprocs);
+    set_buffer_pt2pt_mul(r_buf, rank, options.accel, 'b',
+            options.max_message_size, nprocs);
+
+    dest = malloc(nprocs * sizeof(int));
+    request = malloc(2 * options.window_size * sizeof(MPI_Request));
+    OMB_CHECK_NULL_AND_EXIT(dest, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(request, "Unable to allocate memory");
+    if (0 == rank) {
+        samples = malloc(options.num_trials * nprocs * sizeof(double));
+        sorted = malloc(options.num_trials * nprocs * sizeof(double));
+        OMB_CHECK_NULL_AND_EXIT(samples, "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(sorted, "Unable to allocate memory");
+
+        fprintf(stdout, HEADER);
+        fprintf(stdout, "# Ranks: %d, trials: %d, window size: %d\n", nprocs,
+                options.num_trials, options.window_size);
+        fflush(stdout);
+    }
+
+    iterations = options.iterations;
+    skip = options.skip;
+    for (pattern = 0; pattern < NUM_PATTERNS; pattern++) {
+        if (!(options.patterns & (1 << pattern))) {
+            continue;
+        }
+
+        if (0 == rank) {
+            if (OMB_PATTERN_SHIFT == (1 << pattern)) {
+                fprintf(stdout, "# Pattern: %s by %d\n",
+                        pattern_names[pattern], options.pattern_shift);
+            } else {
+                fprintf(stdout, "# Pattern: %s\n", pattern_names[pattern]);
+            }
+            fprintf(stdout, "%-*s%*s%*s%*s%*s%*s%*s\n", 10, "# Size",
+                    FIELD_WIDTH, "Aggregate(MB/s)", FIELD_WIDTH, "Min(MB/s)",
+                    FIELD_WIDTH, "P10(MB/s)", FIELD_WIDTH, "Median(MB/s)",
+                    FIELD_WIDTH, "Max(MB/s)", FIELD_WIDTH, "Slowest Rank");
+            fflush(stdout);
+        }
+
+        for (size = options.min_message_size;
+                size <= options.max_message_size;
+                size = (size ? size * 2 : 1)) {
+            if (size > LARGE_MESSAGE_SIZE) {
+                options.iterations = options.iterations_large;
+                options.skip = options.skip_large;
+            } else {
+                options.iterations = iterations;
+                options.skip = skip;
+            }
+
+            aggregate = 0.0;
+            for (trial = 0; trial < options.num_trials; trial++) {
+                elapsed = run_trial(1 << pattern, trial, rank, nprocs, size,
+                        dest, s_buf, r_buf, request, &bytes);
+                bw = (bytes > 0) ? bytes / elapsed / 1e6 : -1.0;
+
+                MPI_CHECK(MPI_Gather(&bw, 1, MPI_DOUBLE,
+                            0 == rank ? &samples[trial * nprocs] : NULL, 1,
+                            MPI_DOUBLE, 0, MPI_COMM_WORLD));
+                MPI_CHECK(MPI_Reduce(&bytes, &total_bytes, 1, MPI_DOUBLE,
+                            MPI_SUM, 0, MPI_COMM_WORLD));
+                MPI_CHECK(MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE,
+                            MPI_MAX, 0, MPI_COMM_WORLD));
+                if (0 == rank) {
+                    aggregate += total_bytes / max_elapsed / 1e6;
+                }
+            }
+
+            if (0 == rank) {
+                print_stats_congestion(size, nprocs,
+                        aggregate / options.num_trials, samples, sorted);
+            }
+        }
+    }
+
+    free(dest);
+    free(request);
+    free(samples);
+    free(sorted);
+    free_memory_pt2pt_mul(s_buf, r_buf, rank, nprocs);
+
+    MPI_CHECK(MPI_Finalize());
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Fill dest with the destination of every rank. A rank mapped onto itself
+ * stays idle. Bit complement falls back to rank reversal when nprocs is not
+ * a power of two, tornado shifts by ceil(nprocs / 2) - 1 and all-pairs uses
+ * a shift of phase + 1.
+ */
+static void build_pattern(int pattern, int phase, int trial, int nprocs,
+                          int *dest)
+{
+    int i, j, tmp;
+
+    switch (pattern) {
+        case OMB_PATTERN_RANDOM:
+            for (i = 0; i < nprocs; i++) {
+                dest[i] = i;
+            }
+            srand(trial + 1);
+            for (i = nprocs - 1; i > 0; i--) {
+                j = rand() % (i + 1);
+                tmp = dest[i];
+                dest[i] = dest[j];
+                dest[j] = tmp;
+            }
+            /* Swapping a fixed point with its neighbour removes it */
+            for (i = 0; i < nprocs; i++) {
+                if (dest[i] == i) {
+                    j = (i + 1) % nprocs;
+                    dest[i] = dest[j];
+                    dest[j] = i;
+                }
+            }
+            break;
+        case OMB_PATTERN_SHIFT:
+            for (i = 0; i < nprocs; i++) {
+                dest[i] = (i + options.pattern_shift) % nprocs;
+            }
+            break;
+        case OMB_PATTERN_BITCOMP:
+            for (i = 0; i < nprocs; i++) {
+                dest[i] = (0 == (nprocs & (nprocs - 1))) ?
+                    (~i & (nprocs - 1)) : (nprocs - 1 - i);
+            }
+            break;
+        case OMB_PATTERN_TORNADO:
+            for (i = 0; i < nprocs; i++) {
+                dest[i] = (i + MAX(1, (nprocs + 1) / 2 - 1)) % nprocs;
+            }
+            break;
+        case OMB_PATTERN_ALLPAIRS:
+            for (i = 0; i < nprocs; i++) {
+                dest[i] = (i + phase + 1) % nprocs;
+            }
+            break;
+    }
+}
+
+/*
+ * Run one trial and return the time this rank spent streaming. bytes is set
+ * to the amount of data sent by this rank, 0 if the pattern left it idle.
+ */
+static double run_trial(int pattern, int trial, int rank, int nprocs,
+                        int size, int *dest, char *s_buf, char *r_buf,
+                        MPI_Request *request, double *bytes)
+{
+    int phase, num_phases, i, j, src, num_requests;
+    double t_start = 0.0;
+
+    num_phases = (OMB_PATTERN_ALLPAIRS == pattern) ? nprocs - 1 : 1;
+    *bytes = 0.0;
+
+    for (phase = 0; phase < num_phases; phase++) {
+        if (0 == rank) {
+            build_pattern(pattern, phase, trial, nprocs, dest);
+        }
+        MPI_CHECK(MPI_Bcast(dest, nprocs, MPI_INT, 0, MPI_COMM_WORLD));
+
+        for (src = 0; src < nprocs && dest[src] != rank; src++);
+
+        if (0 == phase) {
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        }
+
+        for (i = 0; i < options.iterations + (0 == phase ? options.skip : 0);
+                i++) {
+            if (0 == phase && i == options.skip) {
+                t_start = MPI_Wtime();
+            }
+
+            num_requests = 0;
+            if (src != rank) {
+                for (j = 0; j < options.window_size; j++) {
+                    MPI_CHECK(MPI_Irecv(r_buf, size, MPI_CHAR, src, 100,
+                                MPI_COMM_WORLD, &request[num_requests++]));
+                }
+            }
+            if (dest[rank] != rank) {
+                for (j = 0; j < options.window_size; j++) {
+                    MPI_CHECK(MPI_Isend(s_buf, size, MPI_CHAR, dest[rank],
+                                100, MPI_COMM_WORLD,
+                                &request[num_requests++]));
+                }
+            }
+            MPI_CHECK(MPI_Waitall(num_requests, request,
+                        MPI_STATUSES_IGNORE));
+        }
+
+        if (dest[rank] != rank) {
+            *bytes += (double)size * options.window_size * options.iterations;
+        }
+    }
+
+    return MPI_Wtime() - t_start;
+}
+
+/*
+ * samples holds one bandwidth per rank and trial, negative for idle ranks.
+ * The slowest rank is the one with the lowest bandwidth averaged over all
+ * trials, which points at hot links when the placement is known.
+ */
+static void print_stats_congestion(int size, int nprocs, double aggregate,
+                                   double *samples, double *sorted)
+{
+    int i, trial, count = 0, slowest = -1;
+    double mean, slowest_mean = 0.0;
+
+    for (i = 0; i < nprocs; i++) {
+        mean = 0.0;
+        for (trial = 0; trial < options.num_trials; trial++) {
+            if (samples[trial * nprocs + i] >= 0) {
+                sorted[count++] = samples[trial * nprocs + i];
+                mean += samples[trial * nprocs + i];
+            }
+        }
+        if (mean > 0 && (-1 == slowest || mean < slowest_mean)) {
+            slowest = i;
+            slowest_mean = mean;
+        }
+    }
+
+    fprintf(stdout, "%-*d%*.*f", 10, size, FIELD_WIDTH, FLOAT_PRECISION,
+            aggregate);
+    if (0 == count) {
+        fprintf(stdout, "%*s\n", FIELD_WIDTH, "idle");
+        fflush(stdout);
+        return;
+    }
+
+    qsort(sorted, count, sizeof(double), omb_compare_double);
+    fprintf(stdout, "%*.*f%*.*f%*.*f%*.*f%*d\n",
+            FIELD_WIDTH, FLOAT_PRECISION, sorted[0],
+            FIELD_WIDTH, FLOAT_PRECISION, omb_percentile(sorted, count, 10.0),
+            FIELD_WIDTH, FLOAT_PRECISION, omb_percentile(sorted, count, 50.0),
+            FIELD_WIDTH, FLOAT_PRECISION, sorted[count - 1],
+            FIELD_WIDTH, slowest);
+    fflush(stdout);
+}
+
+/* vi: set sw=4 sts=4 tw=80: */
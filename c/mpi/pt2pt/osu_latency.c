@@ -11,17 +11,18 @@
 #include <osu_util_mpi.h>
 
 #ifdef _ENABLE_CUDA_KERNEL_
-double measure_kernel_lo(char *, int);
-void touch_managed_src(char *, int);
-void touch_managed_dst(char *, int);
+double measure_kernel_lo(char *, size_t);
+void touch_managed_src(char *, size_t);
+void touch_managed_dst(char *, size_t);
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
 double calculate_total(double, double, double);
+static void latency_soak(int, char *, char *, size_t);
 
 int
 main (int argc, char *argv[])
 {
     int myid, numprocs, i, j;
-    int size;
+    size_t size;
     MPI_Status reqstat;
     omb_graph_options_t omb_graph_options;
     omb_graph_data_t *omb_graph_data = NULL;
@@ -33,9 +34,15 @@ main (int argc, char *argv[])
     size_t omb_ddt_size = 0;
     size_t omb_ddt_transmit_size = 0;
     int papi_eventset = OMB_PAPI_NULL;
+    omb_ipc_t ipc;
+    double shm_floor = 0.0, cma_floor = 0.0;
+    double t_touch = 0.0, t_touch_start = 0.0, t_touch_peer = 0.0;
 
     options.bench = PT2PT;
     options.subtype = LAT;
+    options.show_soak = 1;
+    options.show_ipc_floor = 1;
+    options.show_touch_data = 1;
 
     set_header(HEADER);
     set_benchmark_name("osu_latency");
@@ -102,6 +109,10 @@ main (int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    if (options.soak_duration > 0) {
+        options.buf_num = SINGLE;
+    }
+    check_mem_limit(numprocs);
     if (options.buf_num == SINGLE) {
         if (allocate_memory_pt2pt(&s_buf, &r_buf, myid)) {
             /* Error allocating memory */
@@ -110,6 +121,30 @@ main (int argc, char *argv[])
         }
     }
 
+    if (options.soak_duration > 0) {
+        latency_soak(myid, s_buf, r_buf, options.max_message_size);
+        free_memory(s_buf, r_buf, myid);
+        MPI_CHECK(MPI_Finalize());
+
+        if (NONE != options.accel) {
+            if (cleanup_accel()) {
+                fprintf(stderr, "Error cleaning up device\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (options.ipc_floor && omb_ipc_init(&ipc, 1 - myid,
+                options.max_message_size, MPI_COMM_WORLD)) {
+        if (0 == myid) {
+            fprintf(stderr, "IPC floor skipped: ranks do not share a node or"
+                    " the shared segment could not be mapped\n");
+        }
+        omb_ipc_free(&ipc);
+        options.ipc_floor = 0;
+    }
+
     print_header(myid, LAT);
     omb_papi_init(&papi_eventset);
 
@@ -150,6 +185,7 @@ main (int argc, char *argv[])
         for (i = 0; i < options.iterations + options.skip; i++) {
             if (i == options.skip) {
                 omb_papi_start(&papi_eventset);
+                t_touch = 0.0;
             }
             if (options.validate) {
                 set_buffer_validation(s_buf, r_buf, size, options.accel, i);
@@ -165,10 +201,21 @@ main (int argc, char *argv[])
                         touch_managed_src(s_buf, size);
                     }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
-                    MPI_CHECK(MPI_Send(s_buf, omb_ddt_size, omb_ddt_datatype,
-                                1, 1, MPI_COMM_WORLD));
-                    MPI_CHECK(MPI_Recv(r_buf, omb_ddt_size, omb_ddt_datatype,
-                                1, 1, MPI_COMM_WORLD, &reqstat));
+                    if (options.touch_data) {
+                        t_touch_start = MPI_Wtime();
+                        omb_touch_produce(s_buf, size, i);
+                        t_touch += MPI_Wtime() - t_touch_start;
+                    }
+                    MPI_CHECK(omb_large_send(s_buf, omb_ddt_size,
+                                omb_ddt_datatype, 1, 1, MPI_COMM_WORLD));
+                    MPI_CHECK(omb_large_recv(r_buf, omb_ddt_size,
+                                omb_ddt_datatype, 1, 1, MPI_COMM_WORLD,
+                                &reqstat));
+                    if (options.touch_data) {
+                        t_touch_start = MPI_Wtime();
+                        omb_touch_consume(r_buf, size);
+                        t_touch += MPI_Wtime() - t_touch_start;
+                    }
 #ifdef _ENABLE_CUDA_KERNEL_
                     if (options.src == 'M') {
                         touch_managed_src(r_buf, size);
@@ -197,15 +244,22 @@ main (int argc, char *argv[])
                         touch_managed_dst(s_buf, size);
                     }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
-                    MPI_CHECK(MPI_Recv(r_buf, omb_ddt_size, omb_ddt_datatype,
-                                0, 1, MPI_COMM_WORLD, &reqstat));
+                    MPI_CHECK(omb_large_recv(r_buf, omb_ddt_size,
+                                omb_ddt_datatype, 0, 1, MPI_COMM_WORLD,
+                                &reqstat));
 #ifdef _ENABLE_CUDA_KERNEL_
                     if (options.dst == 'M') {
                         touch_managed_dst(r_buf, size);
                     }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
-                    MPI_CHECK(MPI_Send(s_buf ,omb_ddt_size, omb_ddt_datatype,
-                                0, 1, MPI_COMM_WORLD));
+                    if (options.touch_data) {
+                        t_touch_start = MPI_Wtime();
+                        omb_touch_consume(r_buf, size);
+                        omb_touch_produce(s_buf, size, i);
+                        t_touch += MPI_Wtime() - t_touch_start;
+                    }
+                    MPI_CHECK(omb_large_send(s_buf, omb_ddt_size,
+                                omb_ddt_datatype, 0, 1, MPI_COMM_WORLD));
                 }
                 if (options.validate) {
                     errors = validate_data(r_buf, size, 1, options.accel, i);
@@ -217,9 +271,28 @@ main (int argc, char *argv[])
 
         omb_papi_stop_and_print(&papi_eventset, size);
 
+        /* Both sides' touch time is on the critical path of the round trip */
+        if (options.touch_data) {
+            if (myid == 0) {
+                MPI_CHECK(MPI_Recv(&t_touch_peer, 1, MPI_DOUBLE, 1, 3,
+                            MPI_COMM_WORLD, &reqstat));
+            } else if (myid == 1) {
+                MPI_CHECK(MPI_Send(&t_touch, 1, MPI_DOUBLE, 0, 3,
+                            MPI_COMM_WORLD));
+            }
+        }
+
+        if (options.ipc_floor) {
+            shm_floor = omb_ipc_latency(&ipc, OMB_IPC_SHM, size);
+            if (ipc.cma) {
+                cma_floor = omb_ipc_latency(&ipc, OMB_IPC_CMA, size);
+            }
+        }
+
         if (myid == 0) {
-            double latency = (t_total * 1e6) / (2.0 * options.iterations);
-            fprintf(stdout, "%-*d", 10, size);
+            double latency = ((t_total - t_touch - t_touch_peer) * 1e6) /
+                (2.0 * options.iterations);
+            fprintf(stdout, "%-*zu", 10, size);
             if (options.validate) {
                 fprintf(stdout, "%*.*f%*s", FIELD_WIDTH, FLOAT_PRECISION,
                         latency, FIELD_WIDTH, VALIDATION_STATUS(errors));
@@ -230,6 +303,20 @@ main (int argc, char *argv[])
             if (options.omb_enable_ddt) {
                 fprintf(stdout, "%*zu", FIELD_WIDTH, omb_ddt_transmit_size);
             }
+            if (options.touch_data) {
+                fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                        (t_total * 1e6) / (2.0 * options.iterations));
+            }
+            if (options.ipc_floor) {
+                fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                        shm_floor);
+                if (ipc.cma) {
+                    fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                            cma_floor);
+                } else {
+                    fprintf(stdout, "%*s", FIELD_WIDTH, "N/A");
+                }
+            }
             fprintf(stdout, "\n");
             fflush(stdout);
             if (options.graph && 0 == myid) {
@@ -254,6 +341,9 @@ main (int argc, char *argv[])
     omb_graph_combined_plot(&omb_graph_options, benchmark_name);
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
+    if (options.ipc_floor) {
+        omb_ipc_free(&ipc);
+    }
     if (options.buf_num == SINGLE) {
         free_memory(s_buf, r_buf, myid);
     }
@@ -269,14 +359,14 @@ main (int argc, char *argv[])
 
     if (errors !=0 && options.validate && myid == 0 ) {
         fprintf(stdout, "DATA VALIDATION ERROR: %s exited with status %d on"
-                " message size %d.\n", argv[0], EXIT_FAILURE, size);
+                " message size %zu.\n", argv[0], EXIT_FAILURE, size);
         exit(EXIT_FAILURE);
     }
     return EXIT_SUCCESS;
 }
 
 #ifdef _ENABLE_CUDA_KERNEL_
-double measure_kernel_lo(char *buf, int size)
+double measure_kernel_lo(char *buf, size_t size)
 {
     int i;
     double t_lo = 0.0, t_start, t_end;
@@ -297,7 +387,7 @@ double measure_kernel_lo(char *buf, int size)
     return t_lo;
 }
 
-void touch_managed_src(char *buf, int size)
+void touch_managed_src(char *buf, size_t size)
 {
     if (options.src == 'M') {
         if (options.MMsrc == 'D') {
@@ -314,7 +404,7 @@ void touch_managed_src(char *buf, int size)
     }
 }
 
-void touch_managed_dst(char *buf, int size)
+void touch_managed_dst(char *buf, size_t size)
 {
     if (options.dst == 'M') {
         if (options.MMdst == 'D') {
@@ -332,6 +422,50 @@ void touch_managed_dst(char *buf, int size)
 }
 #endif /* #ifdef _ENABLE_CUDA_KERNEL_ */
 
+/*
+ * Ping-pong at a single message size until the soak duration expires. Rank 0
+ * records the one-way latency of every round trip.
+ */
+static void latency_soak(int myid, char *s_buf, char *r_buf, size_t size)
+{
+    omb_soak_t soak;
+    MPI_Status reqstat;
+    double t_start = 0.0;
+    int i;
+
+    set_buffer_pt2pt(s_buf, myid, options.accel, 'a', size);
+    set_buffer_pt2pt(r_buf, myid, options.accel, 'b', size);
+
+    if (size > LARGE_MESSAGE_SIZE) {
+        options.iterations = options.iterations_large;
+        options.skip = options.skip_large;
+    }
+
+    omb_soak_init(&soak, size, "Latency(us)", 0, MPI_COMM_WORLD);
+    do {
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            if (myid == 0) {
+                t_start = MPI_Wtime();
+                MPI_CHECK(omb_large_send(s_buf, size, MPI_CHAR, 1, 1,
+                            MPI_COMM_WORLD));
+                MPI_CHECK(omb_large_recv(r_buf, size, MPI_CHAR, 1, 1,
+                            MPI_COMM_WORLD, &reqstat));
+                if (i >= options.skip) {
+                    omb_soak_record(&soak, (MPI_Wtime() - t_start) * 1e6 /
+                            2.0);
+                }
+            } else if (myid == 1) {
+                MPI_CHECK(omb_large_recv(r_buf, size, MPI_CHAR, 0, 1,
+                            MPI_COMM_WORLD, &reqstat));
+                MPI_CHECK(omb_large_send(s_buf, size, MPI_CHAR, 0, 1,
+                            MPI_COMM_WORLD));
+            }
+        }
+        /* Only the first batch warms up */
+        options.skip = 0;
+    } while (omb_soak_continue(&soak, MPI_COMM_WORLD));
+}
+
 double calculate_total(double t_start, double t_end, double t_lo)
 {
     double t_total;
@@ -0,0 +1,345 @@
+#define BENCHMARK "OSU MPI Latency Under Load Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+/*
+ * Ranks are paired like in osu_multi_lat (rank i with rank i + nprocs/2).
+ * The first probe pairs run a ping-pong, the remaining pairs stream
+ * osu_bw-style windows at them. Every message size is measured twice, first
+ * with the load pairs idle and then with the load running, and the probe
+ * samples of all probe pairs are pooled on rank 0.
+ */
+#define LOAD_DATA_TAG   100
+#define LOAD_ACK_TAG    101
+#define LOAD_STOP_TAG   102
+
+static void probe_pingpong(int rank, int partner, int is_sender, char *s_buf,
+                           char *r_buf, int size, double *samples);
+static double stream_load(int partner, int is_sender, char *s_buf,
+                          char *r_buf, MPI_Request *stop_request);
+static void print_load_header(int rank, int pairs, int probe_pairs);
+
+int
+main (int argc, char *argv[])
+{
+    int rank, nprocs, pairs, probe_pairs, partner, is_sender, is_probe;
+    int size, iterations, max_iterations, num_samples;
+    char *s_buf, *r_buf;
+    double *base_samples = NULL, *load_samples = NULL;
+    double *all_base = NULL, *all_load = NULL;
+    double load_bw = 0.0, total_bw = 0.0;
+    MPI_Comm probe_comm = MPI_COMM_NULL;
+    MPI_Request stop_request;
+    int po_ret = 0;
+
+    options.bench = PT2PT;
+    options.subtype = LAT_LOAD;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_latency_load");
+
+    po_ret = process_options(argc, argv);
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &nprocs));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+
+    if (0 == rank) {
+        switch (po_ret) {
+            case PO_BAD_USAGE:
+                print_bad_usage_message(rank);
+                break;
+            case PO_HELP_MESSAGE:
+                print_help_message(rank);
+                break;
+            case PO_VERSION_MESSAGE:
+                print_version_message(rank);
+                MPI_CHECK(MPI_Finalize());
+                exit(EXIT_SUCCESS);
+            default:
+                break;
+        }
+    }
+
+    switch (po_ret) {
+        case PO_CUDA_NOT_AVAIL:
+        case PO_OPENACC_NOT_AVAIL:
+        case PO_BAD_USAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+        case PO_VERSION_MESSAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    pairs = nprocs / 2;
+    probe_pairs = options.pairs ? options.pairs : 1;
+
+    if (nprocs % 2 || probe_pairs < 1 || probe_pairs >= pairs) {
+        if (0 == rank) {
+            fprintf(stderr, "This test requires an even number of processes "
+                    "and at least one pair more than the %d probe pair(s)\n",
+                    probe_pairs);
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    is_sender = rank < pairs;
+    partner = is_sender ? rank + pairs : rank - pairs;
+    is_probe = (rank % pairs) < probe_pairs;
+
+    if (allocate_memory_pt2pt_mul_size(&s_buf, &r_buf, rank, pairs,
+                MAX(options.max_message_size, options.load_size))) {
+        /* Error allocating memory */
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+    set_buffer_pt2pt_mul(s_buf, rank, options.accel, 'a',
+            MAX(options.max_message_size, options.load_size), pairs);
+    set_buffer_pt2pt_mul(r_buf, rank, options.accel, 'b',
+            MAX(options.max_message_size, options.load_size), pairs);
+
+    max_iterations = MAX(options.iterations, options.iterations_large);
+    if (is_probe && is_sender) {
+        base_samples = malloc(max_iterations * sizeof(double));
+        load_samples = malloc(max_iterations * sizeof(double));
+        OMB_CHECK_NULL_AND_EXIT(base_samples, "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(load_samples, "Unable to allocate memory");
+    }
+    if (0 == rank) {
+        all_base = malloc(probe_pairs * max_iterations * sizeof(double));
+        all_load = malloc(probe_pairs * max_iterations * sizeof(double));
+        OMB_CHECK_NULL_AND_EXIT(all_base, "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(all_load, "Unable to allocate memory");
+    }
+    MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, (is_probe && is_sender) ? 0 :
+                MPI_UNDEFINED, rank, &probe_comm));
+
+    print_load_header(rank, pairs, probe_pairs);
+
+    for (size = options.min_message_size; size <= options.max_message_size;
+            size = (size ? size * 2 : 1)) {
+        if (size > LARGE_MESSAGE_SIZE) {
+            options.iterations = options.iterations_large;
+            options.skip = options.skip_large;
+        }
+        iterations = options.iterations;
+        num_samples = iterations * probe_pairs;
+
+        /* Baseline, load pairs idle */
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        if (is_probe) {
+            probe_pingpong(rank, partner, is_sender, s_buf, r_buf, size,
+                    base_samples);
+        }
+
+        /* Probe while the load pairs stream */
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        if (is_probe) {
+            probe_pingpong(rank, partner, is_sender, s_buf, r_buf, size,
+                    load_samples);
+            MPI_CHECK(MPI_Ibarrier(MPI_COMM_WORLD, &stop_request));
+            MPI_CHECK(MPI_Wait(&stop_request, MPI_STATUS_IGNORE));
+            load_bw = 0.0;
+        } else {
+            MPI_CHECK(MPI_Ibarrier(MPI_COMM_WORLD, &stop_request));
+            load_bw = stream_load(partner, is_sender, s_buf, r_buf,
+                    &stop_request);
+        }
+
+        MPI_CHECK(MPI_Reduce(&load_bw, &total_bw, 1, MPI_DOUBLE, MPI_SUM, 0,
+                    MPI_COMM_WORLD));
+        if (MPI_COMM_NULL != probe_comm) {
+            MPI_CHECK(MPI_Gather(base_samples, iterations, MPI_DOUBLE,
+                        all_base, iterations, MPI_DOUBLE, 0, probe_comm));
+            MPI_CHECK(MPI_Gather(load_samples, iterations, MPI_DOUBLE,
+                        all_load, iterations, MPI_DOUBLE, 0, probe_comm));
+        }
+
+        if (0 == rank) {
+            qsort(all_base, num_samples, sizeof(double), omb_compare_double);
+            qsort(all_load, num_samples, sizeof(double), omb_compare_double);
+
+            fprintf(stdout, "%-*d", 10, size);
+            fprintf(stdout, "%*.*f%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                    omb_percentile(all_base, num_samples, 50.0),
+                    FIELD_WIDTH, FLOAT_PRECISION,
+                    omb_percentile(all_base, num_samples, 99.0));
+            fprintf(stdout, "%*.*f%*.*f%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                    omb_percentile(all_load, num_samples, 50.0),
+                    FIELD_WIDTH, FLOAT_PRECISION,
+                    omb_percentile(all_load, num_samples, 99.0),
+                    FIELD_WIDTH, FLOAT_PRECISION, all_load[num_samples - 1]);
+            fprintf(stdout, "%*.*f\n", FIELD_WIDTH, FLOAT_PRECISION, total_bw);
+            fflush(stdout);
+        }
+    }
+
+    if (MPI_COMM_NULL != probe_comm) {
+        MPI_CHECK(MPI_Comm_free(&probe_comm));
+    }
+    free(base_samples);
+    free(load_samples);
+    free(all_base);
+    free(all_load);
+    free_memory_pt2pt_mul(s_buf, r_buf, rank, pairs);
+
+    MPI_CHECK(MPI_Finalize());
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * One ping-pong per iteration; the sender side stores the one-way latency
+ * of every timed iteration in samples.
+ */
+static void probe_pingpong(int rank, int partner, int is_sender, char *s_buf,
+                           char *r_buf, int size, double *samples)
+{
+    double t_start = 0.0, t_end = 0.0;
+    int i;
+
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        if (is_sender) {
+            t_start = MPI_Wtime();
+            MPI_CHECK(MPI_Send(s_buf, size, MPI_CHAR, partner, 1,
+                        MPI_COMM_WORLD));
+            MPI_CHECK(MPI_Recv(r_buf, size, MPI_CHAR, partner, 1,
+                        MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+            t_end = MPI_Wtime();
+
+            if (i >= options.skip) {
+                samples[i - options.skip] = (t_end - t_start) * 1e6 / 2.0;
+            }
+        } else {
+            MPI_CHECK(MPI_Recv(r_buf, size, MPI_CHAR, partner, 1,
+                        MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+            MPI_CHECK(MPI_Send(s_buf, size, MPI_CHAR, partner, 1,
+                        MPI_COMM_WORLD));
+        }
+    }
+}
+
+/*
+ * Stream windows of load_size messages until the probe pairs have entered
+ * the stop barrier. After each window the sender idles long enough to keep
+ * the link busy only load_duty percent of the time and then tells the
+ * receiver whether another window follows. Returns the bandwidth achieved
+ * by the sender in MB/s, 0 on the receiver.
+ */
+static double stream_load(int partner, int is_sender, char *s_buf,
+                          char *r_buf, MPI_Request *stop_request)
+{
+    MPI_Request request[MAX_REQ_NUM];
+    double t_begin, t_start, t_busy, bytes = 0.0;
+    int i, stop = 0, ack = 0, window;
+
+    window = options.load_window;
+    t_begin = MPI_Wtime();
+
+    while (!stop) {
+        if (is_sender) {
+            t_start = MPI_Wtime();
+            for (i = 0; i < window; i++) {
+                MPI_CHECK(MPI_Isend(s_buf, options.load_size, MPI_CHAR,
+                            partner, LOAD_DATA_TAG, MPI_COMM_WORLD,
+                            &request[i]));
+            }
+            MPI_CHECK(MPI_Waitall(window, request, MPI_STATUSES_IGNORE));
+            MPI_CHECK(MPI_Recv(&ack, 1, MPI_INT, partner, LOAD_ACK_TAG,
+                        MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+            bytes += (double)window * options.load_size;
+
+            t_busy = MPI_Wtime() - t_start;
+            while (MPI_Wtime() - t_start < t_busy * 100.0 / options.load_duty);
+
+            MPI_CHECK(MPI_Test(stop_request, &stop, MPI_STATUS_IGNORE));
+            MPI_CHECK(MPI_Send(&stop, 1, MPI_INT, partner, LOAD_STOP_TAG,
+                        MPI_COMM_WORLD));
+        } else {
+            for (i = 0; i < window; i++) {
+                MPI_CHECK(MPI_Irecv(r_buf, options.load_size, MPI_CHAR,
+                            partner, LOAD_DATA_TAG, MPI_COMM_WORLD,
+                            &request[i]));
+            }
+            MPI_CHECK(MPI_Waitall(window, request, MPI_STATUSES_IGNORE));
+            MPI_CHECK(MPI_Send(&ack, 1, MPI_INT, partner, LOAD_ACK_TAG,
+                        MPI_COMM_WORLD));
+            MPI_CHECK(MPI_Recv(&stop, 1, MPI_INT, partner, LOAD_STOP_TAG,
+                        MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+        }
+    }
+
+    if (!is_sender) {
+        MPI_CHECK(MPI_Wait(stop_request, MPI_STATUS_IGNORE));
+        return 0.0;
+    }
+
+    return bytes / (MPI_Wtime() - t_begin) / 1e6;
+}
+
+/*
+ * Print the run configuration, including how many probe and load pairs
+ * cross a node boundary.
+ */
+static void print_load_header(int rank, int pairs, int probe_pairs)
+{
+    MPI_Comm node_comm;
+    int node_id = rank, *node_ids = NULL, nprocs = pairs * 2, i;
+    int probe_intra = 0, load_intra = 0;
+
+    MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                MPI_INFO_NULL, &node_comm));
+    MPI_CHECK(MPI_Bcast(&node_id, 1, MPI_INT, 0, node_comm));
+    MPI_CHECK(MPI_Comm_free(&node_comm));
+
+    if (0 == rank) {
+        node_ids = malloc(nprocs * sizeof(int));
+        OMB_CHECK_NULL_AND_EXIT(node_ids, "Unable to allocate memory");
+    }
+    MPI_CHECK(MPI_Gather(&node_id, 1, MPI_INT, node_ids, 1, MPI_INT, 0,
+                MPI_COMM_WORLD));
+
+    if (0 != rank) {
+        return;
+    }
+
+    for (i = 0; i < pairs; i++) {
+        if (node_ids[i] == node_ids[i + pairs]) {
+            if (i < probe_pairs) {
+                probe_intra++;
+            } else {
+                load_intra++;
+            }
+        }
+    }
+    free(node_ids);
+
+    fprintf(stdout, HEADER);
+    fprintf(stdout, "# Probe pairs: %d (%d intranode, %d internode)\n",
+            probe_pairs, probe_intra, probe_pairs - probe_intra);
+    fprintf(stdout, "# Load pairs: %d (%d intranode, %d internode), "
+            "%zu bytes x %d per burst, %d%% duty\n", pairs - probe_pairs,
+            load_intra, pairs - probe_pairs - load_intra, options.load_size,
+            options.load_window, options.load_duty);
+    fprintf(stdout, "%-*s%*s%*s%*s%*s%*s%*s\n", 10, "# Size", FIELD_WIDTH,
+            "Base P50(us)", FIELD_WIDTH, "Base P99(us)", FIELD_WIDTH,
+            "Load P50(us)", FIELD_WIDTH, "Load P99(us)", FIELD_WIDTH,
+            "Load Max(us)", FIELD_WIDTH, "Load BW(MB/s)");
+    fflush(stdout);
+}
+
+/* vi: set sw=4 sts=4 tw=80: */
@@ -0,0 +1,184 @@
+#define BENCHMARK "OSU MPI%s Latency Overlap Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+/*
+ * Both ranks post MPI_Irecv and MPI_Isend, compute for as long as the pure
+ * exchange takes and then wait. Large messages only overlap with the compute
+ * if the library progresses the rendezvous handshake while the application
+ * is busy, optionally helped along by the -t MPI_Test calls.
+ */
+int main(int argc, char *argv[])
+{
+    int myid, numprocs, i, size, peer;
+    char *s_buf, *r_buf;
+    double latency = 0.0, t_start = 0.0, t_stop = 0.0;
+    double test_time = 0.0, test_total = 0.0;
+    double tcomp = 0.0, tcomp_total = 0.0, latency_in_secs = 0.0;
+    double wait_time = 0.0, init_time = 0.0;
+    double init_total = 0.0, wait_total = 0.0;
+    double timer = 0.0;
+    MPI_Request request[2];
+    MPI_Status status[2];
+    int po_ret = 0;
+
+    options.bench = PT2PT;
+    options.subtype = LAT_OVERLAP;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_latency_overlap");
+
+    po_ret = process_options(argc, argv);
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &myid));
+
+    if (0 == myid) {
+        switch (po_ret) {
+            case PO_BAD_USAGE:
+                print_bad_usage_message(myid);
+                break;
+            case PO_HELP_MESSAGE:
+                print_help_message(myid);
+                break;
+            case PO_VERSION_MESSAGE:
+                print_version_message(myid);
+                MPI_CHECK(MPI_Finalize());
+                exit(EXIT_SUCCESS);
+            case PO_OKAY:
+                break;
+        }
+    }
+
+    switch (po_ret) {
+        case PO_BAD_USAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+        case PO_VERSION_MESSAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    if (numprocs != 2) {
+        if (myid == 0) {
+            fprintf(stderr, "This test requires exactly two processes\n");
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    if (allocate_memory_pt2pt(&s_buf, &r_buf, myid)) {
+        /* Error allocating memory */
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    /* Host arrays for the dummy compute */
+    allocate_host_arrays();
+
+    peer = 1 - myid;
+    print_preamble_nbc(myid);
+
+    for (size = options.min_message_size; size <= options.max_message_size;
+            size = (size ? size * 2 : 1)) {
+        set_buffer_pt2pt(s_buf, myid, options.accel, 'a', size);
+        set_buffer_pt2pt(r_buf, myid, options.accel, 'b', size);
+
+        if (size > LARGE_MESSAGE_SIZE) {
+            options.iterations = options.iterations_large;
+            options.skip = options.skip_large;
+        }
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+        timer = 0.0;
+
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            t_start = MPI_Wtime();
+            MPI_CHECK(MPI_Irecv(r_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD, &request[0]));
+            MPI_CHECK(MPI_Isend(s_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD, &request[1]));
+            MPI_CHECK(MPI_Waitall(2, request, status));
+            t_stop = MPI_Wtime();
+
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+            if (i >= options.skip) {
+                timer += t_stop - t_start;
+            }
+        }
+
+        /* This is the pure comm. time */
+        latency = (timer * 1e6) / options.iterations;
+
+        /* Comm. latency in seconds, fed to dummy_compute */
+        latency_in_secs = timer / options.iterations;
+
+        init_arrays(latency_in_secs);
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+        timer = 0.0; tcomp_total = 0.0; tcomp = 0.0;
+        init_total = 0.0; wait_total = 0.0;
+        test_time = 0.0, test_total = 0.0;
+
+        for (i = 0; i < options.iterations + options.skip; i++) {
+            t_start = MPI_Wtime();
+
+            init_time = MPI_Wtime();
+            MPI_CHECK(MPI_Irecv(r_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD, &request[0]));
+            MPI_CHECK(MPI_Isend(s_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD, &request[1]));
+            init_time = MPI_Wtime() - init_time;
+
+            /* Test the receive, it is the side a rendezvous stalls on */
+            tcomp = MPI_Wtime();
+            test_time = dummy_compute(latency_in_secs, &request[0]);
+            tcomp = MPI_Wtime() - tcomp;
+
+            wait_time = MPI_Wtime();
+            MPI_CHECK(MPI_Waitall(2, request, status));
+            wait_time = MPI_Wtime() - wait_time;
+
+            t_stop = MPI_Wtime();
+
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+            if (i >= options.skip) {
+                timer += t_stop - t_start;
+                tcomp_total += tcomp;
+                init_total += init_time;
+                test_total += test_time;
+                wait_total += wait_time;
+            }
+        }
+
+        MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+        calculate_and_print_stats(myid, size, numprocs, timer, latency,
+                                  test_total, tcomp_total, wait_total,
+                                  init_total, 0);
+    }
+
+    free_host_arrays();
+    free_memory(s_buf, r_buf, myid);
+    MPI_CHECK(MPI_Finalize());
+
+    return EXIT_SUCCESS;
+}
+
+/* vi: set sw=4 sts=4 tw=80: */
@@ -0,0 +1,317 @@
+#define BENCHMARK "OSU MPI%s Probe Latency Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+/*
+ * Receive paths timed by this benchmark. Every mode is a ping-pong in which
+ * both sides receive through the same path, so the reported number is the
+ * one-way latency including the extra trips through the matching engine.
+ */
+enum omb_probe_mode {
+    OMB_PROBE_RECV,
+    OMB_PROBE_PROBE,
+    OMB_PROBE_IPROBE,
+#if MPI_VERSION >= 3
+    OMB_PROBE_MPROBE,
+    OMB_PROBE_IMPROBE,
+#endif
+    OMB_PROBE_NUM_MODES
+};
+
+static char const *omb_probe_mode_names[OMB_PROBE_NUM_MODES] = {
+    "MPI_Recv(us)",
+    "Probe+Recv(us)",
+    "Iprobe+Recv(us)",
+#if MPI_VERSION >= 3
+    "Mprobe+Mrecv(us)",
+    "Improbe+Mrecv(us)",
+#endif
+};
+
+static void print_probe_header(int rank);
+static void probe_recv(enum omb_probe_mode mode, char *buf, int size,
+                       int source);
+
+int
+main (int argc, char *argv[])
+{
+    int myid, numprocs, i, mode;
+    int size, peer, source;
+    char *s_buf, *r_buf;
+    double t_start = 0.0, t_end = 0.0, t_total = 0.0;
+    double latency[OMB_PROBE_NUM_MODES];
+    int po_ret = 0;
+    int errors = 0, local_errors = 0;
+    int papi_eventset = OMB_PAPI_NULL;
+
+    options.bench = PT2PT;
+    options.subtype = LAT_PROBE;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_latency_probe");
+
+    po_ret = process_options(argc, argv);
+
+    if (PO_OKAY == po_ret && NONE != options.accel) {
+        if (init_accel()) {
+            fprintf(stderr, "Error initializing device\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &myid));
+
+    if (0 == myid) {
+        switch (po_ret) {
+            case PO_CUDA_NOT_AVAIL:
+                fprintf(stderr, "CUDA support not enabled.  Please recompile "
+                        "benchmark with CUDA support.\n");
+                break;
+            case PO_OPENACC_NOT_AVAIL:
+                fprintf(stderr, "OPENACC support not enabled.  Please "
+                        "recompile benchmark with OPENACC support.\n");
+                break;
+            case PO_BAD_USAGE:
+                print_bad_usage_message(myid);
+                break;
+            case PO_HELP_MESSAGE:
+                print_help_message(myid);
+                break;
+            case PO_VERSION_MESSAGE:
+                print_version_message(myid);
+                MPI_CHECK(MPI_Finalize());
+                exit(EXIT_SUCCESS);
+            case PO_OKAY:
+                break;
+        }
+    }
+
+    switch (po_ret) {
+        case PO_CUDA_NOT_AVAIL:
+        case PO_OPENACC_NOT_AVAIL:
+        case PO_BAD_USAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+        case PO_VERSION_MESSAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    if (numprocs != 2) {
+        if (myid == 0) {
+            fprintf(stderr, "This test requires exactly two processes\n");
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    if (allocate_memory_pt2pt(&s_buf, &r_buf, myid)) {
+        /* Error allocating memory */
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    peer = 1 - myid;
+    source = options.any_source ? MPI_ANY_SOURCE : peer;
+
+    print_probe_header(myid);
+    omb_papi_init(&papi_eventset);
+
+    /* Latency test */
+    for (size = options.min_message_size; size <= options.max_message_size;
+            size = (size ? size * 2 : 1)) {
+        set_buffer_pt2pt(s_buf, myid, options.accel, 'a', size);
+        set_buffer_pt2pt(r_buf, myid, options.accel, 'b', size);
+
+        if (size > LARGE_MESSAGE_SIZE) {
+            options.iterations = options.iterations_large;
+            options.skip = options.skip_large;
+        }
+
+        /* One PAPI/pvar report per mode, in the order of the columns */
+        for (mode = 0; mode < OMB_PROBE_NUM_MODES; mode++) {
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+            t_total = 0.0;
+
+            for (i = 0; i < options.iterations + options.skip; i++) {
+                if (i == options.skip) {
+                    omb_papi_start(&papi_eventset);
+                }
+                if (options.validate) {
+                    set_buffer_validation(s_buf, r_buf, size, options.accel,
+                            i);
+                    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+                }
+                if (myid == 0) {
+                    t_start = MPI_Wtime();
+                    MPI_CHECK(MPI_Send(s_buf, size, MPI_CHAR, peer, 1,
+                                MPI_COMM_WORLD));
+                    probe_recv(mode, r_buf, size, source);
+                    t_end = MPI_Wtime();
+
+                    if (i >= options.skip) {
+                        t_total += t_end - t_start;
+                    }
+                } else {
+                    probe_recv(mode, r_buf, size, source);
+                    MPI_CHECK(MPI_Send(s_buf, size, MPI_CHAR, peer, 1,
+                                MPI_COMM_WORLD));
+                    if (options.validate) {
+                        local_errors += validate_data(r_buf, size, 1,
+                                options.accel, i);
+                    }
+                }
+            }
+            latency[mode] = (t_total * 1e6) / (2.0 * options.iterations);
+            omb_papi_stop_and_print(&papi_eventset, size);
+        }
+
+        if (options.validate) {
+            MPI_CHECK(MPI_Allreduce(&local_errors, &errors, 1, MPI_INT,
+                        MPI_SUM, MPI_COMM_WORLD));
+        }
+
+        if (myid == 0) {
+            fprintf(stdout, "%-*d", 10, size);
+            for (mode = 0; mode < OMB_PROBE_NUM_MODES; mode++) {
+                fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                        latency[mode]);
+            }
+            if (options.validate) {
+                fprintf(stdout, "%*s", FIELD_WIDTH, VALIDATION_STATUS(errors));
+            }
+            fprintf(stdout, "\n");
+            fflush(stdout);
+        }
+
+        if (0 != errors) {
+            break;
+        }
+    }
+    omb_papi_free(&papi_eventset);
+    free_memory(s_buf, r_buf, myid);
+
+    MPI_CHECK(MPI_Finalize());
+
+    if (NONE != options.accel) {
+        if (cleanup_accel()) {
+            fprintf(stderr, "Error cleaning up device\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (errors != 0 && options.validate && myid == 0) {
+        fprintf(stdout, "DATA VALIDATION ERROR: %s exited with status %d on"
+                " message size %d.\n", argv[0], EXIT_FAILURE, size);
+        exit(EXIT_FAILURE);
+    }
+    return EXIT_SUCCESS;
+}
+
+static void print_probe_header(int rank)
+{
+    int mode;
+
+    if (rank) {
+        return;
+    }
+
+    switch (options.accel) {
+        case CUDA:
+            printf(benchmark_header, "-CUDA");
+            break;
+        case OPENACC:
+            printf(benchmark_header, "-OPENACC");
+            break;
+        case ROCM:
+            printf(benchmark_header, "-ROCM");
+            break;
+        default:
+            printf(benchmark_header, "");
+            break;
+    }
+
+    fprintf(stdout, "# Receive source: %s\n", options.any_source ?
+            "MPI_ANY_SOURCE" : "peer rank");
+    fprintf(stdout, "%-*s", 10, "# Size");
+    for (mode = 0; mode < OMB_PROBE_NUM_MODES; mode++) {
+        fprintf(stdout, "%*s", FIELD_WIDTH, omb_probe_mode_names[mode]);
+    }
+    if (options.validate) {
+        fprintf(stdout, "%*s", FIELD_WIDTH, "Validation");
+    }
+    fprintf(stdout, "\n");
+    fflush(stdout);
+}
+
+/*
+ * Receive a message of unknown length through the matching path selected by
+ * mode. MPI_Recv posts the known size; the probe modes take the count from
+ * the probed status, so they pay for MPI_Get_count just like an application
+ * sizing its buffer would.
+ */
+static void probe_recv(enum omb_probe_mode mode, char *buf, int size,
+                       int source)
+{
+    MPI_Status status;
+    int count = size, flag = 0;
+#if MPI_VERSION >= 3
+    MPI_Message message;
+#endif
+
+    switch (mode) {
+        case OMB_PROBE_RECV:
+            MPI_CHECK(MPI_Recv(buf, count, MPI_CHAR, source, 1,
+                        MPI_COMM_WORLD, &status));
+            break;
+        case OMB_PROBE_PROBE:
+            MPI_CHECK(MPI_Probe(source, 1, MPI_COMM_WORLD, &status));
+            MPI_CHECK(MPI_Get_count(&status, MPI_CHAR, &count));
+            MPI_CHECK(MPI_Recv(buf, count, MPI_CHAR, status.MPI_SOURCE,
+                        status.MPI_TAG, MPI_COMM_WORLD, &status));
+            break;
+        case OMB_PROBE_IPROBE:
+            while (!flag) {
+                MPI_CHECK(MPI_Iprobe(source, 1, MPI_COMM_WORLD, &flag,
+                            &status));
+            }
+            MPI_CHECK(MPI_Get_count(&status, MPI_CHAR, &count));
+            MPI_CHECK(MPI_Recv(buf, count, MPI_CHAR, status.MPI_SOURCE,
+                        status.MPI_TAG, MPI_COMM_WORLD, &status));
+            break;
+#if MPI_VERSION >= 3
+        case OMB_PROBE_MPROBE:
+            MPI_CHECK(MPI_Mprobe(source, 1, MPI_COMM_WORLD, &message,
+                        &status));
+            MPI_CHECK(MPI_Get_count(&status, MPI_CHAR, &count));
+            MPI_CHECK(MPI_Mrecv(buf, count, MPI_CHAR, &message, &status));
+            break;
+        case OMB_PROBE_IMPROBE:
+            while (!flag) {
+                MPI_CHECK(MPI_Improbe(source, 1, MPI_COMM_WORLD, &flag,
+                            &message, &status));
+            }
+            MPI_CHECK(MPI_Get_count(&status, MPI_CHAR, &count));
+            MPI_CHECK(MPI_Mrecv(buf, count, MPI_CHAR, &message, &status));
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+/* vi: set sw=4 sts=4 tw=80: */
@@ -0,0 +1,350 @@
+#define BENCHMARK "OSU MPI%s Protocol Switch Detection Test"
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+#include <osu_util_mpi.h>
+
+/*
+ * The benchmark runs a power-of-two ping-pong sweep, flags every interval in
+ * which the latency exceeds the linear extrapolation of the two preceding
+ * sizes by more than the jump threshold, and then bisects each flagged
+ * interval down to a single byte. A bisection point belongs to the lower
+ * regime when its latency is closer to the line fitted below the jump than
+ * to the line fitted above it.
+ */
+#define OMB_SWITCH_MAX_POINTS 64
+
+struct omb_switch_line {
+    double intercept;
+    double slope;
+};
+
+struct omb_switch_transition {
+    int below;
+    int above;
+    double lat_below;
+    double lat_above;
+};
+
+static double measure_latency(int myid, int peer, char *s_buf, char *r_buf,
+                              int size);
+static struct omb_switch_line fit_line(int s0, double l0, int s1, double l1);
+static double line_at(struct omb_switch_line line, int size);
+static void print_switch_header(int myid, int peer);
+
+int
+main (int argc, char *argv[])
+{
+    int myid, numprocs, peer, i, k;
+    int size, mid, num_points = 0, num_transitions = 0, skip_next = 0;
+    int sizes[OMB_SWITCH_MAX_POINTS];
+    double latency[OMB_SWITCH_MAX_POINTS];
+    struct omb_switch_transition transitions[OMB_SWITCH_MAX_POINTS];
+    struct omb_switch_line below, above;
+    double predicted, lat_mid;
+    char *s_buf, *r_buf;
+    int po_ret = 0;
+
+    options.bench = PT2PT;
+    options.subtype = LAT_SWITCH;
+
+    set_header(HEADER);
+    set_benchmark_name("osu_latency_switch");
+
+    po_ret = process_options(argc, argv);
+
+    if (PO_OKAY == po_ret && NONE != options.accel) {
+        if (init_accel()) {
+            fprintf(stderr, "Error initializing device\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    MPI_CHECK(MPI_Init(&argc, &argv));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &myid));
+
+    if (0 == myid) {
+        switch (po_ret) {
+            case PO_CUDA_NOT_AVAIL:
+                fprintf(stderr, "CUDA support not enabled.  Please recompile "
+                        "benchmark with CUDA support.\n");
+                break;
+            case PO_OPENACC_NOT_AVAIL:
+                fprintf(stderr, "OPENACC support not enabled.  Please "
+                        "recompile benchmark with OPENACC support.\n");
+                break;
+            case PO_BAD_USAGE:
+                print_bad_usage_message(myid);
+                break;
+            case PO_HELP_MESSAGE:
+                print_help_message(myid);
+                break;
+            case PO_VERSION_MESSAGE:
+                print_version_message(myid);
+                MPI_CHECK(MPI_Finalize());
+                exit(EXIT_SUCCESS);
+            case PO_OKAY:
+                break;
+        }
+    }
+
+    switch (po_ret) {
+        case PO_CUDA_NOT_AVAIL:
+        case PO_OPENACC_NOT_AVAIL:
+        case PO_BAD_USAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_FAILURE);
+        case PO_HELP_MESSAGE:
+        case PO_VERSION_MESSAGE:
+            MPI_CHECK(MPI_Finalize());
+            exit(EXIT_SUCCESS);
+        case PO_OKAY:
+            break;
+    }
+
+    if (numprocs != 2) {
+        if (myid == 0) {
+            fprintf(stderr, "This test requires exactly two processes\n");
+        }
+
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    if (allocate_memory_pt2pt(&s_buf, &r_buf, myid)) {
+        /* Error allocating memory */
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    peer = 1 - myid;
+    print_switch_header(myid, peer);
+
+    set_buffer_pt2pt(s_buf, myid, options.accel, 'a', options.max_message_size);
+    set_buffer_pt2pt(r_buf, myid, options.accel, 'b', options.max_message_size);
+
+    /* Coarse sweep */
+    for (size = options.min_message_size; size <= options.max_message_size &&
+            num_points < OMB_SWITCH_MAX_POINTS; size = (size ? size * 2 : 1)) {
+        sizes[num_points] = size;
+        latency[num_points] = measure_latency(myid, peer, s_buf, r_buf, size);
+
+        if (myid == 0) {
+            fprintf(stdout, "%-*d%*.*f%*.*f\n", 10, size, FIELD_WIDTH,
+                    FLOAT_PRECISION, latency[num_points], FIELD_WIDTH,
+                    FLOAT_PRECISION, size / latency[num_points]);
+            fflush(stdout);
+        }
+        num_points++;
+    }
+
+    /*
+     * Every rank holds the same latencies (see measure_latency), so both
+     * sides take the same bisection decisions without extra messages.
+     */
+    for (k = 2; k < num_points; k++) {
+        if (skip_next) {
+            /* The model for this interval straddles the previous jump */
+            skip_next = 0;
+            continue;
+        }
+
+        below = fit_line(sizes[k - 2], latency[k - 2], sizes[k - 1],
+                latency[k - 1]);
+        predicted = line_at(below, sizes[k]);
+        if (latency[k] <= predicted * (1.0 + options.jump_threshold / 100.0)) {
+            continue;
+        }
+
+        if (k + 1 < num_points) {
+            above = fit_line(sizes[k], latency[k], sizes[k + 1],
+                    latency[k + 1]);
+        } else {
+            above.slope = below.slope;
+            above.intercept = latency[k] - below.slope * sizes[k];
+        }
+
+        transitions[num_transitions].below = sizes[k - 1];
+        transitions[num_transitions].lat_below = latency[k - 1];
+        transitions[num_transitions].above = sizes[k];
+        transitions[num_transitions].lat_above = latency[k];
+
+        while (transitions[num_transitions].above -
+                transitions[num_transitions].below > 1) {
+            mid = transitions[num_transitions].below +
+                (transitions[num_transitions].above -
+                 transitions[num_transitions].below) / 2;
+            lat_mid = measure_latency(myid, peer, s_buf, r_buf, mid);
+
+            if (fabs(lat_mid - line_at(below, mid)) <=
+                    fabs(lat_mid - line_at(above, mid))) {
+                transitions[num_transitions].below = mid;
+                transitions[num_transitions].lat_below = lat_mid;
+            } else {
+                transitions[num_transitions].above = mid;
+                transitions[num_transitions].lat_above = lat_mid;
+            }
+        }
+
+        num_transitions++;
+        skip_next = 1;
+    }
+
+    if (myid == 0) {
+        fprintf(stdout, "# Protocol transitions (jump threshold %.2f%%)\n",
+                options.jump_threshold);
+        if (0 == num_transitions) {
+            fprintf(stdout, "# None detected\n");
+        } else {
+            fprintf(stdout, "%-*s%*s%*s%*s%*s%*s%*s\n", 10, "# Below(B)",
+                    FIELD_WIDTH, "Above(B)", FIELD_WIDTH, "Lat below(us)",
+                    FIELD_WIDTH, "Lat above(us)", FIELD_WIDTH, "Jump(us)",
+                    FIELD_WIDTH, "BW below(MB/s)", FIELD_WIDTH,
+                    "BW above(MB/s)");
+        }
+        for (i = 0; i < num_transitions; i++) {
+            fprintf(stdout, "%-*d%*d%*.*f%*.*f%*.*f%*.*f%*.*f\n", 10,
+                    transitions[i].below, FIELD_WIDTH, transitions[i].above,
+                    FIELD_WIDTH, FLOAT_PRECISION, transitions[i].lat_below,
+                    FIELD_WIDTH, FLOAT_PRECISION, transitions[i].lat_above,
+                    FIELD_WIDTH, FLOAT_PRECISION,
+                    transitions[i].lat_above - transitions[i].lat_below,
+                    FIELD_WIDTH, FLOAT_PRECISION,
+                    transitions[i].below / transitions[i].lat_below,
+                    FIELD_WIDTH, FLOAT_PRECISION,
+                    transitions[i].above / transitions[i].lat_above);
+        }
+        fflush(stdout);
+    }
+
+    free_memory(s_buf, r_buf, myid);
+
+    MPI_CHECK(MPI_Finalize());
+
+    if (NONE != options.accel) {
+        if (cleanup_accel()) {
+            fprintf(stderr, "Error cleaning up device\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Ping-pong latency for one message size. The result is broadcast from rank
+ * 0 so that all ranks see identical numbers.
+ */
+static double measure_latency(int myid, int peer, char *s_buf, char *r_buf,
+                              int size)
+{
+    MPI_Status reqstat;
+    double t_start = 0.0, t_end = 0.0, latency = 0.0;
+    int i, iterations, skip;
+
+    if (size > LARGE_MESSAGE_SIZE) {
+        iterations = options.iterations_large;
+        skip = options.skip_large;
+    } else {
+        iterations = options.iterations;
+        skip = options.skip;
+    }
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+    for (i = 0; i < iterations + skip; i++) {
+        if (i == skip) {
+            t_start = MPI_Wtime();
+        }
+
+        if (myid == 0) {
+            MPI_CHECK(MPI_Send(s_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD));
+            MPI_CHECK(MPI_Recv(r_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD, &reqstat));
+        } else {
+            MPI_CHECK(MPI_Recv(r_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD, &reqstat));
+            MPI_CHECK(MPI_Send(s_buf, size, MPI_CHAR, peer, 1,
+                        MPI_COMM_WORLD));
+        }
+    }
+    t_end = MPI_Wtime();
+
+    latency = (t_end - t_start) * 1e6 / (2.0 * iterations);
+    MPI_CHECK(MPI_Bcast(&latency, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD));
+
+    return latency;
+}
+
+/*
+ * Line through two (size, latency) points. The slope is clamped at zero so
+ * that timer noise between two small sizes cannot predict a latency drop.
+ */
+static struct omb_switch_line fit_line(int s0, double l0, int s1, double l1)
+{
+    struct omb_switch_line line;
+
+    line.slope = (s1 != s0) ? (l1 - l0) / (s1 - s0) : 0.0;
+    if (line.slope < 0.0) {
+        line.slope = 0.0;
+    }
+    line.intercept = l1 - line.slope * s1;
+
+    return line;
+}
+
+static double line_at(struct omb_switch_line line, int size)
+{
+    return line.intercept + line.slope * size;
+}
+
+static void print_switch_header(int myid, int peer)
+{
+    char name[MPI_MAX_PROCESSOR_NAME], peer_name[MPI_MAX_PROCESSOR_NAME];
+    int len = 0;
+
+    MPI_CHECK(MPI_Get_processor_name(name, &len));
+
+    if (myid == 0) {
+        MPI_CHECK(MPI_Recv(peer_name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, peer,
+                    1, MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+    } else {
+        MPI_CHECK(MPI_Send(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, peer, 1,
+                    MPI_COMM_WORLD));
+        return;
+    }
+
+    switch (options.accel) {
+        case CUDA:
+            printf(benchmark_header, "-CUDA");
+            break;
+        case OPENACC:
+            printf(benchmark_header, "-OPENACC");
+            break;
+        case ROCM:
+            printf(benchmark_header, "-ROCM");
+            break;
+        default:
+            printf(benchmark_header, "");
+            break;
+    }
+
+    if (0 == strncmp(name, peer_name, MPI_MAX_PROCESSOR_NAME)) {
+        fprintf(stdout, "# Placement: intranode (%s)\n", name);
+    } else {
+        fprintf(stdout, "# Placement: internode (%s, %s)\n", name, peer_name);
+    }
+    fprintf(stdout, "%-*s%*s%*s\n", 10, "# Size", FIELD_WIDTH, "Latency(us)",
+            FIELD_WIDTH, "Bandwidth(MB/s)");
+    fflush(stdout);
+}
+
+/* vi: set sw=4 sts=4 tw=80: */
@@ -43,8 +43,11 @@ int main(int argc, char *argv[])
     set_header(HEADER);
     set_benchmark_name("osu_mbw_mr");
     double message_rate = 0.0;
+    omb_ipc_t ipc;
+    int ipc_peer = MPI_PROC_NULL;
     options.bench = MBW_MR;
     options.subtype = BW;
+    options.show_ipc_floor = 1;
 
     MPI_CHECK(MPI_Init(&argc, &argv));
 
@@ -139,6 +142,30 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (options.ipc_floor && options.window_varied) {
+        if (rank == 0) {
+            fprintf(stderr, "IPC floor skipped: not available with varied"
+                    " window sizes\n");
+        }
+        options.ipc_floor = 0;
+    }
+    if (options.ipc_floor) {
+        if (rank < options.pairs) {
+            ipc_peer = rank + options.pairs;
+        } else if (rank < options.pairs * 2) {
+            ipc_peer = rank - options.pairs;
+        }
+        if (omb_ipc_init(&ipc, ipc_peer, options.max_message_size,
+                    MPI_COMM_WORLD)) {
+            if (rank == 0) {
+                fprintf(stderr, "IPC floor skipped: not every pair shares a"
+                        " node or the shared segment could not be mapped\n");
+            }
+            omb_ipc_free(&ipc);
+            options.ipc_floor = 0;
+        }
+    }
+
     if (rank == 0) {
         fprintf(stdout, HEADER);
         print_header(rank, BW);
@@ -167,6 +194,10 @@ int main(int argc, char *argv[])
             if (options.omb_enable_ddt) {
                 fprintf(stdout, "%*s", FIELD_WIDTH, "Transmit Size");
             }
+            if (options.ipc_floor) {
+                fprintf(stdout, "%*s%*s", FIELD_WIDTH, "SHM Floor(MB/s)",
+                        FIELD_WIDTH, "CMA Floor(MB/s)");
+            }
             fprintf(stdout, "\n");
         }
 
@@ -294,10 +325,27 @@ int main(int argc, char *argv[])
        for (curr_size = options.min_message_size; curr_size <=
                options.max_message_size; curr_size *= 2) {
            double bw, rate;
+           double floor_bw[2] = {0.0, 0.0}, floor_sum[2] = {0.0, 0.0};
 
            bw = calc_bw(rank, curr_size, options.pairs, options.window_size,
                    s_buf, r_buf);
 
+           if (options.ipc_floor) {
+               /* All pairs stream at once, as in calc_bw */
+               MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+               if (ipc.enabled) {
+                   floor_bw[0] = omb_ipc_bandwidth(&ipc, OMB_IPC_SHM,
+                           curr_size, options.window_size);
+               }
+               MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+               if (ipc.enabled && ipc.cma) {
+                   floor_bw[1] = omb_ipc_bandwidth(&ipc, OMB_IPC_CMA,
+                           curr_size, options.window_size);
+               }
+               MPI_CHECK(MPI_Reduce(floor_bw, floor_sum, 2, MPI_DOUBLE,
+                           MPI_SUM, 0, MPI_COMM_WORLD));
+           }
+
            if (rank == 0) {
                if (options.omb_enable_ddt) {
                    rate = 1e6 * bw / omb_ddt_transmit_size;
@@ -331,6 +379,16 @@ int main(int argc, char *argv[])
                if (options.omb_enable_ddt) {
                    fprintf(stdout, "%*zu", FIELD_WIDTH, omb_ddt_transmit_size);
                }
+               if (options.ipc_floor) {
+                   fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                           floor_sum[0]);
+                   if (ipc.cma) {
+                       fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                               floor_sum[1]);
+                   } else {
+                       fprintf(stdout, "%*s", FIELD_WIDTH, "N/A");
+                   }
+               }
                fprintf(stdout, "\n");
            }
 
@@ -354,6 +412,9 @@ int main(int argc, char *argv[])
    omb_graph_combined_plot(&omb_graph_op, benchmark_name);
    omb_graph_free_data_buffers(&omb_graph_op);
    omb_papi_free(&papi_eventset);
+   if (options.ipc_floor) {
+       omb_ipc_free(&ipc);
+   }
    if (options.buf_num == SINGLE) {
        free_memory_pt2pt_mul(s_buf[0], r_buf[0], rank, options.pairs);
        free(s_buf);
@@ -13,7 +13,28 @@
 
 char *s_buf, *r_buf;
 
-static int multi_latency(int rank, int pairs);
+/*
+ * Pair k times the ping-pong between pair_leader[k] and pair_follower[k].
+ * Every rank builds the same table from the gathered host names, ranks left
+ * out by the pairing strategy only take part in the barriers.
+ */
+static int num_pairs = 0;
+static int *pair_leader = NULL, *pair_follower = NULL;
+static char *hostnames = NULL;
+
+static char const *pairing_names[] = {
+    "block",
+    "intranode",
+    "internode",
+    "nearest",
+    "farthest",
+    "random"
+};
+
+static int multi_latency(int rank, int nprocs);
+static int create_pairs(int rank, int nprocs);
+static void free_pairs(void);
+static void print_multi_lat_header(int rank);
 
 #ifdef _ENABLE_CUDA_KERNEL_
 double measure_kernel_lo(char *, int);
@@ -29,10 +50,10 @@ int main(int argc, char* argv[])
 {
     int rank, nprocs;
     int message_size;
-    int pairs;
     int po_ret = 0;
     options.bench = PT2PT;
     options.subtype = LAT;
+    options.show_pairing = 1;
 
     set_header(HEADER);
     set_benchmark_name("osu_multi_lat");
@@ -50,8 +71,6 @@ int main(int argc, char* argv[])
     MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
     MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &nprocs));
 
-    pairs = nprocs/2;
-
     if (0 == rank) {
         switch (po_ret) {
             case PO_CUDA_NOT_AVAIL:
@@ -92,16 +111,19 @@ int main(int argc, char* argv[])
             break;
     }
 
-    if (rank == 0) {
-        print_header(rank, LAT);
-        fflush(stdout);
+    if (create_pairs(rank, nprocs)) {
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
     }
 
+    print_multi_lat_header(rank);
+
     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 
-    message_size = multi_latency(rank, pairs);
+    message_size = multi_latency(rank, nprocs);
 
     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+    free_pairs();
 
     MPI_CHECK(MPI_Finalize());
 
@@ -120,12 +142,15 @@ int main(int argc, char* argv[])
     return EXIT_SUCCESS;
 }
 
-static int multi_latency(int rank, int pairs)
+static int multi_latency(int rank, int nprocs)
 {
-    int size, partner;
-    int i, j;
+    int size, partner = -1, leader = 0, buf_rank, graph_rank;
+    int i, j, k, slowest;
     double t_start = 0.0, t_end = 0.0,
            t_total = 0.0;
+    double latency, sum;
+    double *all_latency = NULL, *pair_latency = NULL, *sorted = NULL;
+    double *graph_samples = NULL;
 
     /*needed for the kernel loss calculations*/
     double t_lo=0.0;
@@ -137,21 +162,52 @@ static int multi_latency(int rank, int pairs)
     int papi_eventset = OMB_PAPI_NULL;
     MPI_Status reqstat;
 
+    for (k = 0; k < num_pairs; k++) {
+        if (pair_leader[k] == rank) {
+            partner = pair_follower[k];
+            leader = 1;
+        } else if (pair_follower[k] == rank) {
+            partner = pair_leader[k];
+        }
+    }
+    /* The *_mul buffer helpers use SRC buffers for ranks below pairs */
+    buf_rank = leader ? 0 : 1;
+    /*
+     * -G plots the samples of rank 0's pair, or of pair 0 if rank 0 is left
+     * out; its leader measures them and rank 0, which holds the graph, plots
+     */
+    graph_rank = pair_leader[0];
+    for (k = 0; k < num_pairs; k++) {
+        if (0 == pair_leader[k] || 0 == pair_follower[k]) {
+            graph_rank = pair_leader[k];
+        }
+    }
+
+    if (0 == rank) {
+        all_latency = malloc(nprocs * sizeof(double));
+        pair_latency = malloc(num_pairs * sizeof(double));
+        sorted = malloc(num_pairs * sizeof(double));
+        OMB_CHECK_NULL_AND_EXIT(all_latency, "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(pair_latency, "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(sorted, "Unable to allocate memory");
+    }
+
     omb_graph_options_init(&omb_graph_options);
     omb_papi_init(&papi_eventset);
     for (size = options.min_message_size; size <= options.max_message_size;
             size = (size ? size * 2 : 1)) {
 
         omb_ddt_size = omb_ddt_get_size(size);
-        if (allocate_memory_pt2pt_mul_size(&s_buf, &r_buf, rank, pairs, size)) {
+        if (allocate_memory_pt2pt_mul_size(&s_buf, &r_buf, buf_rank, 1,
+                    size)) {
             /* Error allocating memory */
             MPI_CHECK(MPI_Finalize());
             exit(EXIT_FAILURE);
         }
 
         omb_ddt_transmit_size = omb_ddt_assign(&omb_ddt_datatype, MPI_CHAR, size);
-        set_buffer_pt2pt_mul(s_buf, rank, options.accel, 'a', size, pairs);
-        set_buffer_pt2pt_mul(r_buf, rank, options.accel, 'b', size, pairs);
+        set_buffer_pt2pt_mul(s_buf, buf_rank, options.accel, 'a', size, 1);
+        set_buffer_pt2pt_mul(r_buf, buf_rank, options.accel, 'b', size, 1);
 
         if (size > LARGE_MESSAGE_SIZE) {
             options.iterations = options.iterations_large;
@@ -170,6 +226,12 @@ static int multi_latency(int rank, int pairs)
 
         omb_graph_allocate_and_get_data_buffer(&omb_graph_data,
                 &omb_graph_options, size, options.iterations);
+        if (options.graph && rank == graph_rank) {
+            graph_samples = 0 == rank ? omb_graph_data->data :
+                malloc(options.iterations * sizeof(double));
+            OMB_CHECK_NULL_AND_EXIT(graph_samples,
+                    "Unable to allocate memory");
+        }
         MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
         t_total = 0.0;
 
@@ -182,8 +244,7 @@ static int multi_latency(int rank, int pairs)
             }
             for (j = 0; j <= options.warmup_validation; j++) {
                 MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
-                if (rank < pairs) {
-                    partner = rank + pairs;
+                if (leader) {
                     if (i >= options.skip && j == options.warmup_validation) {
                         t_start = MPI_Wtime();
                     }
@@ -207,15 +268,13 @@ static int multi_latency(int rank, int pairs)
                     if (i >= options.skip && j == options.warmup_validation) {
                         t_end = MPI_Wtime();
                         t_total += calculate_total(t_start, t_end, t_lo);
-                        if (options.graph) {
-                            omb_graph_data->data[i - options.skip] =
+                        if (options.graph && rank == graph_rank) {
+                            graph_samples[i - options.skip] =
                                 calculate_total(t_start, t_end, t_lo) * 1e6 /
                                 2.0;
                         }
                     }
-                } else {
-                    partner = rank - pairs;
-
+                } else if (0 <= partner) {
 #ifdef _ENABLE_CUDA_KERNEL_
                     if (options.dst == 'M') {
                         touch_managed_dst(s_buf, size);
@@ -236,29 +295,67 @@ static int multi_latency(int rank, int pairs)
             }
             if (options.validate) {
                 int error = 0, error_temp = 0;
-                error = validate_data(r_buf, size, 1, options.accel, i);
+                if (0 <= partner) {
+                    error = validate_data(r_buf, size, 1, options.accel, i);
+                }
                 MPI_CHECK(MPI_Reduce(&error, &error_temp, 1, MPI_INT, MPI_SUM,
                             0, MPI_COMM_WORLD));
                 errors_reduced += error_temp;
             }
         }
         omb_papi_stop_and_print(&papi_eventset, size);
+        if (options.graph && 0 != graph_rank) {
+            if (rank == graph_rank) {
+                MPI_CHECK(MPI_Send(graph_samples, options.iterations,
+                            MPI_DOUBLE, 0, 2, MPI_COMM_WORLD));
+                free(graph_samples);
+            } else if (0 == rank) {
+                MPI_CHECK(MPI_Recv(omb_graph_data->data, options.iterations,
+                            MPI_DOUBLE, graph_rank, 2, MPI_COMM_WORLD,
+                            MPI_STATUS_IGNORE));
+            }
+        }
+
+        latency = leader ? (t_total * 1e6) / (2.0 * options.iterations) : 0.0;
+        MPI_CHECK(MPI_Gather(&latency, 1, MPI_DOUBLE, all_latency, 1,
+                    MPI_DOUBLE, 0, MPI_COMM_WORLD));
 
         if (0 == rank) {
-            double latency = (t_total * 1e6) / (2.0 * options.iterations);
+            sum = 0.0;
+            slowest = 0;
+            for (k = 0; k < num_pairs; k++) {
+                pair_latency[k] = sorted[k] = all_latency[pair_leader[k]];
+                sum += pair_latency[k];
+                if (pair_latency[k] > pair_latency[slowest]) {
+                    slowest = k;
+                }
+            }
+            qsort(sorted, num_pairs, sizeof(double), omb_compare_double);
+            latency = sum / num_pairs;
+
             fprintf(stdout, "%-*d", 10, size);
+            fprintf(stdout, "%*.*f%*.*f%*.*f%*.*f%*d", FIELD_WIDTH,
+                    FLOAT_PRECISION, latency, FIELD_WIDTH, FLOAT_PRECISION,
+                    sorted[0], FIELD_WIDTH, FLOAT_PRECISION,
+                    omb_percentile(sorted, num_pairs, 50), FIELD_WIDTH,
+                    FLOAT_PRECISION, sorted[num_pairs - 1], FIELD_WIDTH,
+                    slowest);
             if (options.validate) {
-                fprintf(stdout, "%*.*f%*s", FIELD_WIDTH, FLOAT_PRECISION,
-                        latency, FIELD_WIDTH,
+                fprintf(stdout, "%*s", FIELD_WIDTH,
                         VALIDATION_STATUS(errors_reduced));
-            } else {
-                fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
-                        latency);
             }
             if (options.omb_enable_ddt) {
                 fprintf(stdout, "%*zu", FIELD_WIDTH, omb_ddt_transmit_size);
             }
             fprintf(stdout, "\n");
+
+            /* One comment line per size with the latency of every pair */
+            fprintf(stdout, "%-*s", 10, "#");
+            for (k = 0; k < num_pairs; k++) {
+                fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                        pair_latency[k]);
+            }
+            fprintf(stdout, "\n");
             fflush(stdout);
             if (options.graph && 0 == rank) {
                 omb_graph_data->avg = latency;
@@ -266,7 +363,7 @@ static int multi_latency(int rank, int pairs)
         }
 
         omb_ddt_free(&omb_ddt_datatype);
-        free_memory_pt2pt_mul(s_buf, r_buf, rank, pairs);
+        free_memory_pt2pt_mul(s_buf, r_buf, buf_rank, 1);
 
         if (options.validate) {
             MPI_CHECK(MPI_Bcast(&errors_reduced, 1, MPI_INT, 0,
@@ -282,9 +379,245 @@ static int multi_latency(int rank, int pairs)
     omb_graph_combined_plot(&omb_graph_options, benchmark_name);
     omb_graph_free_data_buffers(&omb_graph_options);
     omb_papi_free(&papi_eventset);
+    free(all_latency);
+    free(pair_latency);
+    free(sorted);
     return size;
 }
 
+static unsigned long hostname_hash(char const *name)
+{
+    unsigned long hash = 5381;
+
+    while (*name) {
+        hash = hash * 33 + (unsigned char)*name++;
+    }
+
+    return hash;
+}
+
+static char const *hostname(int rank)
+{
+    return &hostnames[rank * MPI_MAX_PROCESSOR_NAME];
+}
+
+/* Order ranks by host name so the ranks of a node are adjacent */
+static int compare_by_host(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    int ret = strcmp(hostname(x), hostname(y));
+
+    return ret ? ret : x - y;
+}
+
+/* Order ranks by host name hash, ties broken by name and rank */
+static int compare_by_hash(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    unsigned long hx = hostname_hash(hostname(x));
+    unsigned long hy = hostname_hash(hostname(y));
+
+    if (hx != hy) {
+        return (hx > hy) - (hx < hy);
+    }
+
+    return compare_by_host(a, b);
+}
+
+static void add_pair(int leader, int follower)
+{
+    pair_leader[num_pairs] = leader;
+    pair_follower[num_pairs] = follower;
+    num_pairs++;
+}
+
+/*
+ * Build the pair table for the strategy selected with -S:
+ *   block     rank i with rank i + N/2 (the historical behavior)
+ *   intranode consecutive ranks that share a host
+ *   internode local rank j of host 2m with local rank j of host 2m + 1
+ *   nearest   ranks sorted by host, position 2i with 2i + 1, so pairs cross
+ *             hosts only where a host has an odd number of ranks
+ *   farthest  ranks sorted by host name hash, position i with i + N/2
+ *   random    a fixed-seed shuffle of all ranks, paired consecutively
+ */
+static int create_pairs(int rank, int nprocs)
+{
+    char name[MPI_MAX_PROCESSOR_NAME];
+    int *order = NULL, *node_start = NULL;
+    int i, j, m, len, tmp, num_nodes = 0, count;
+
+    hostnames = malloc(nprocs * MPI_MAX_PROCESSOR_NAME);
+    pair_leader = malloc((nprocs / 2 + 1) * sizeof(int));
+    pair_follower = malloc((nprocs / 2 + 1) * sizeof(int));
+    order = malloc(nprocs * sizeof(int));
+    node_start = malloc((nprocs + 1) * sizeof(int));
+    OMB_CHECK_NULL_AND_EXIT(hostnames, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(pair_leader, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(pair_follower, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(order, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(node_start, "Unable to allocate memory");
+
+    memset(name, 0, MPI_MAX_PROCESSOR_NAME);
+    MPI_CHECK(MPI_Get_processor_name(name, &len));
+    MPI_CHECK(MPI_Allgather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                hostnames, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, MPI_COMM_WORLD));
+
+    for (i = 0; i < nprocs; i++) {
+        order[i] = i;
+    }
+
+    switch (options.pairing) {
+        case OMB_PAIRING_INTRANODE:
+            qsort(order, nprocs, sizeof(int), compare_by_host);
+            for (i = 0; i + 1 < nprocs; i++) {
+                if (0 == strcmp(hostname(order[i]), hostname(order[i + 1]))) {
+                    add_pair(order[i], order[i + 1]);
+                    i++;
+                }
+            }
+            break;
+        case OMB_PAIRING_INTERNODE:
+            qsort(order, nprocs, sizeof(int), compare_by_host);
+            for (i = 0; i < nprocs; i++) {
+                if (0 == i || strcmp(hostname(order[i - 1]),
+                            hostname(order[i]))) {
+                    node_start[num_nodes++] = i;
+                }
+            }
+            node_start[num_nodes] = nprocs;
+            for (m = 0; m + 1 < num_nodes; m += 2) {
+                count = MIN(node_start[m + 1] - node_start[m],
+                        node_start[m + 2] - node_start[m + 1]);
+                for (j = 0; j < count; j++) {
+                    add_pair(order[node_start[m] + j],
+                            order[node_start[m + 1] + j]);
+                }
+            }
+            break;
+        case OMB_PAIRING_NEAREST:
+            qsort(order, nprocs, sizeof(int), compare_by_host);
+            for (i = 0; i + 1 < nprocs; i += 2) {
+                add_pair(order[i], order[i + 1]);
+            }
+            break;
+        case OMB_PAIRING_FARTHEST:
+            qsort(order, nprocs, sizeof(int), compare_by_hash);
+            for (i = 0; i < nprocs / 2; i++) {
+                add_pair(order[i], order[i + nprocs / 2]);
+            }
+            break;
+        case OMB_PAIRING_RANDOM:
+            if (0 == rank) {
+                srand(1);
+                for (i = nprocs - 1; i > 0; i--) {
+                    j = rand() % (i + 1);
+                    tmp = order[i];
+                    order[i] = order[j];
+                    order[j] = tmp;
+                }
+            }
+            MPI_CHECK(MPI_Bcast(order, nprocs, MPI_INT, 0, MPI_COMM_WORLD));
+            for (i = 0; i + 1 < nprocs; i += 2) {
+                add_pair(order[i], order[i + 1]);
+            }
+            break;
+        case OMB_PAIRING_BLOCK:
+        default:
+            for (i = 0; i < nprocs / 2; i++) {
+                add_pair(i, i + nprocs / 2);
+            }
+            break;
+    }
+
+    free(order);
+    free(node_start);
+
+    if (0 == num_pairs) {
+        if (0 == rank) {
+            fprintf(stderr, "Pairing strategy %s found no pairs among %d"
+                    " processes\n", pairing_names[options.pairing], nprocs);
+        }
+        free_pairs();
+        return 1;
+    }
+
+    return 0;
+}
+
+static void free_pairs(void)
+{
+    free(hostnames);
+    free(pair_leader);
+    free(pair_follower);
+    hostnames = NULL;
+    pair_leader = pair_follower = NULL;
+}
+
+static void print_multi_lat_header(int rank)
+{
+    int k;
+
+    if (rank) {
+        return;
+    }
+
+    if (options.omb_enable_ddt) {
+        fprintf(stdout, "# Set Derived DataTypes block_length to %zu, stride"
+                " to %zu\n", options.ddt_type_parameters.block_length,
+                options.ddt_type_parameters.stride);
+    }
+    switch (options.accel) {
+        case CUDA:
+            printf(benchmark_header, "-CUDA");
+            break;
+        case OPENACC:
+            printf(benchmark_header, "-OPENACC");
+            break;
+        case ROCM:
+            printf(benchmark_header, "-ROCM");
+            break;
+        default:
+            printf(benchmark_header, "");
+            break;
+    }
+
+    if (NONE != options.accel) {
+        fprintf(stdout, "# Send Buffer on %s and Receive Buffer on %s\n",
+                'M' == options.src ? ('D' == options.MMsrc ? "MANAGED (MD)" :
+                    "MANAGED (MH)") : ('D' == options.src ? "DEVICE (D)" :
+                    "HOST (H)"),
+                'M' == options.dst ? ('D' == options.MMdst ? "MANAGED (MD)" :
+                    "MANAGED (MH)") : ('D' == options.dst ? "DEVICE (D)" :
+                    "HOST (H)"));
+    }
+
+    fprintf(stdout, "# Pairing: %s, %d pairs\n", pairing_names[options.pairing],
+            num_pairs);
+    for (k = 0; k < num_pairs; k++) {
+        fprintf(stdout, "# Pair %d: rank %d (%s) <-> rank %d (%s)\n", k,
+                pair_leader[k], hostname(pair_leader[k]), pair_follower[k],
+                hostname(pair_follower[k]));
+    }
+    fprintf(stdout, "# The line after each size lists the latency of every"
+            " pair in order\n");
+
+    fprintf(stdout, "%-*s", 10, "# Size");
+    fprintf(stdout, "%*s", FIELD_WIDTH, "Avg Latency(us)");
+    fprintf(stdout, "%*s", FIELD_WIDTH, "Min Latency(us)");
+    fprintf(stdout, "%*s", FIELD_WIDTH, "Median(us)");
+    fprintf(stdout, "%*s", FIELD_WIDTH, "Max Latency(us)");
+    fprintf(stdout, "%*s", FIELD_WIDTH, "Slowest Pair");
+    if (options.validate) {
+        fprintf(stdout, "%*s", FIELD_WIDTH, "Validation");
+    }
+    if (options.omb_enable_ddt) {
+        fprintf(stdout, "%*s", FIELD_WIDTH, "Transmit Size");
+    }
+    fprintf(stdout, "\n");
+    fflush(stdout);
+}
+
 #ifdef _ENABLE_CUDA_KERNEL_
 double measure_kernel_lo(char *buf, int size)
 {
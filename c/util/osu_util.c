@@ -77,6 +77,22 @@ void print_header(int rank, int full)
                                     options.bench == MBW_MR)) {
                             fprintf(stdout, "%*s", FIELD_WIDTH, "Transmit Size");
                         }
+                        if (options.touch_data) {
+                            fprintf(stdout, "%*s", FIELD_WIDTH,
+                                    options.subtype == BW ? "E2E BW(MB/s)" :
+                                    "E2E Latency(us)");
+                        }
+                        if (options.ipc_floor && options.bench == PT2PT) {
+                            if (options.subtype == BW) {
+                                fprintf(stdout, "%*s%*s", FIELD_WIDTH,
+                                        "SHM Floor(MB/s)", FIELD_WIDTH,
+                                        "CMA Floor(MB/s)");
+                            } else {
+                                fprintf(stdout, "%*s%*s", FIELD_WIDTH,
+                                        "SHM Floor(us)", FIELD_WIDTH,
+                                        "CMA Floor(us)");
+                            }
+                        }
                         fprintf(stdout, "\n");
                         fflush(stdout);
                 }
@@ -309,6 +325,615 @@ static int set_processes (char *val_str)
     return retval;
 }
 
+/*
+ * Parse SIZE[:WINDOW[:DUTY]] for the background traffic of osu_latency_load.
+ * Omitted fields keep their defaults.
+ */
+static int set_load (char *val_str)
+{
+    char *val;
+
+    val = strtok(val_str, ":");
+    if (NULL == val || 0 >= atoll(val)) {
+        return -1;
+    }
+    options.load_size = atoll(val);
+
+    val = strtok(NULL, ":");
+    if (NULL == val) {
+        return 0;
+    }
+    options.load_window = atoi(val);
+    if (1 > options.load_window || MAX_REQ_NUM < options.load_window) {
+        return -1;
+    }
+
+    val = strtok(NULL, ":");
+    if (NULL == val) {
+        return 0;
+    }
+    options.load_duty = atoi(val);
+    if (1 > options.load_duty || 100 < options.load_duty) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Parse a comma separated list of traffic patterns for osu_congestion.
+ * shift takes an optional distance, e.g. shift:4.
+ */
+static int set_patterns (char *val_str)
+{
+    char *pattern, *save = NULL;
+
+    options.patterns = 0;
+    for (pattern = strtok_r(val_str, ",", &save); NULL != pattern;
+            pattern = strtok_r(NULL, ",", &save)) {
+        if (0 == strcasecmp(pattern, "random")) {
+            options.patterns |= OMB_PATTERN_RANDOM;
+        } else if (0 == strncasecmp(pattern, "shift", 5)) {
+            options.patterns |= OMB_PATTERN_SHIFT;
+            if (':' == pattern[5]) {
+                options.pattern_shift = atoi(&pattern[6]);
+                if (1 > options.pattern_shift) {
+                    return -1;
+                }
+            } else if ('\0' != pattern[5]) {
+                return -1;
+            }
+        } else if (0 == strcasecmp(pattern, "bitcomp")) {
+            options.patterns |= OMB_PATTERN_BITCOMP;
+        } else if (0 == strcasecmp(pattern, "tornado")) {
+            options.patterns |= OMB_PATTERN_TORNADO;
+        } else if (0 == strcasecmp(pattern, "allpairs")) {
+            options.patterns |= OMB_PATTERN_ALLPAIRS;
+        } else if (0 == strcasecmp(pattern, "all")) {
+            options.patterns |= OMB_PATTERN_ALL;
+        } else {
+            return -1;
+        }
+    }
+
+    return options.patterns ? 0 : -1;
+}
+
+typedef struct omb_reduce_name {
+    char const *name;
+    int value;
+} omb_reduce_name_t;
+
+static omb_reduce_name_t const omb_reduce_dtype_table[] = {
+    {"float", OMB_DTYPE_FLOAT},
+    {"double", OMB_DTYPE_DOUBLE},
+    {"int", OMB_DTYPE_INT},
+    {"int64", OMB_DTYPE_INT64},
+    {"complex", OMB_DTYPE_COMPLEX},
+    {"float_int", OMB_DTYPE_FLOAT_INT},
+    {"bfloat16", OMB_DTYPE_BFLOAT16},
+    {"all", OMB_DTYPE_ALL},
+    {NULL, 0}
+};
+
+static omb_reduce_name_t const omb_reduce_op_table[] = {
+    {"sum", OMB_OP_SUM},
+    {"max", OMB_OP_MAX},
+    {"min", OMB_OP_MIN},
+    {"maxloc", OMB_OP_MAXLOC},
+    {"minloc", OMB_OP_MINLOC},
+    {"all", OMB_OP_ALL},
+    {NULL, 0}
+};
+
+static omb_reduce_name_t const omb_ref_algo_table[] = {
+    {"hier", OMB_REF_HIER},
+    {"ring", OMB_REF_RING},
+    {"rd", OMB_REF_RD},
+    {"rabenseifner", OMB_REF_RABENSEIFNER},
+    {"binomial", OMB_REF_BINOMIAL},
+    {"chain", OMB_REF_CHAIN},
+    {"bruck", OMB_REF_BRUCK},
+    {"pairwise", OMB_REF_PAIRWISE},
+    {NULL, 0}
+};
+
+static omb_reduce_name_t const omb_throughput_table[] = {
+    {"indep", OMB_THROUGHPUT_INDEP},
+    {"chain", OMB_THROUGHPUT_CHAIN},
+    {NULL, 0}
+};
+
+/* Parse a comma separated list of names from table into a bit mask */
+static int set_reduce_list (char *val_str, omb_reduce_name_t const *table,
+                            int *mask)
+{
+    char *name, *save = NULL;
+    int i;
+
+    *mask = 0;
+    for (name = strtok_r(val_str, ",", &save); NULL != name;
+            name = strtok_r(NULL, ",", &save)) {
+        for (i = 0; NULL != table[i].name &&
+                strcasecmp(name, table[i].name); i++);
+        if (NULL == table[i].name) {
+            return -1;
+        }
+        *mask |= table[i].value;
+    }
+
+    return *mask ? 0 : -1;
+}
+
+/* world, node, leaders, row, col or groups:K */
+static int set_comm_shape (char *val_str)
+{
+    char *end = NULL;
+    long groups;
+
+    if (0 == strncasecmp(val_str, "groups:", 7)) {
+        groups = strtol(val_str + 7, &end, 10);
+        if (end == val_str + 7 || '\0' != *end || groups < 1 ||
+                groups > INT_MAX) {
+            return -1;
+        }
+        options.comm_shape = OMB_SHAPE_GROUPS;
+        options.comm_groups = groups;
+    } else if (0 == strcasecmp(val_str, "world")) {
+        options.comm_shape = OMB_SHAPE_WORLD;
+    } else if (0 == strcasecmp(val_str, "node")) {
+        options.comm_shape = OMB_SHAPE_NODE;
+    } else if (0 == strcasecmp(val_str, "leaders")) {
+        options.comm_shape = OMB_SHAPE_LEADERS;
+    } else if (0 == strcasecmp(val_str, "row")) {
+        options.comm_shape = OMB_SHAPE_ROW;
+    } else if (0 == strcasecmp(val_str, "col")) {
+        options.comm_shape = OMB_SHAPE_COL;
+    } else {
+        return -1;
+    }
+
+    return 0;
+}
+
+/* late:US, ramp:US, uniform:US, exp:US or normal:US:SD */
+static int set_skew (char *val_str)
+{
+    static struct {
+        char const *name;
+        enum omb_skew_types_t skew;
+    } const patterns[] = {
+        {"late:", OMB_SKEW_LATE},
+        {"ramp:", OMB_SKEW_RAMP},
+        {"uniform:", OMB_SKEW_UNIFORM},
+        {"exp:", OMB_SKEW_EXP},
+        {"normal:", OMB_SKEW_NORMAL}
+    };
+    char *end = NULL;
+    size_t i, len = 0;
+
+    for (i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+        len = strlen(patterns[i].name);
+        if (0 == strncasecmp(val_str, patterns[i].name, len)) {
+            break;
+        }
+    }
+    if (i == sizeof(patterns) / sizeof(patterns[0])) {
+        return -1;
+    }
+    options.skew = patterns[i].skew;
+    options.skew_us = strtod(val_str + len, &end);
+    if (end == val_str + len || options.skew_us < 0.0) {
+        return -1;
+    }
+    if (OMB_SKEW_NORMAL == options.skew) {
+        if (':' != *end) {
+            return -1;
+        }
+        val_str = end + 1;
+        options.skew_sd = strtod(val_str, &end);
+        if (end == val_str || options.skew_sd < 0.0) {
+            return -1;
+        }
+    }
+
+    return '\0' == *end ? 0 : -1;
+}
+
+/* K[:FILE] */
+static int set_per_rank (char *val_str)
+{
+    char *end = NULL;
+    long value;
+
+    value = strtol(val_str, &end, 10);
+    if (end == val_str || value < 1 || value > INT_MAX ||
+            (':' != *end && '\0' != *end)) {
+        return -1;
+    }
+    options.per_rank = value;
+    if (':' == *end) {
+        if ('\0' == end[1] || strlen(end + 1) >= OMB_FILE_PATH_MAX_LENGTH) {
+            return -1;
+        }
+        strcpy(options.per_rank_file, end + 1);
+    }
+
+    return 0;
+}
+
+/* uniform, zipf:S, sparse:F, heavy:F or file:PATH */
+static int set_vcounts (char *val_str)
+{
+    char *end = NULL;
+
+    if (0 == strcasecmp(val_str, "uniform")) {
+        options.vcounts = OMB_VCOUNTS_UNIFORM;
+        return 0;
+    }
+    if (0 == strncasecmp(val_str, "file:", 5)) {
+        if ('\0' == val_str[5] ||
+                strlen(val_str + 5) >= OMB_FILE_PATH_MAX_LENGTH) {
+            return -1;
+        }
+        options.vcounts = OMB_VCOUNTS_FILE;
+        strcpy(options.vcounts_file, val_str + 5);
+        return 0;
+    }
+    if (0 == strncasecmp(val_str, "zipf:", 5)) {
+        options.vcounts = OMB_VCOUNTS_ZIPF;
+    } else if (0 == strncasecmp(val_str, "sparse:", 7)) {
+        options.vcounts = OMB_VCOUNTS_SPARSE;
+    } else if (0 == strncasecmp(val_str, "heavy:", 6)) {
+        options.vcounts = OMB_VCOUNTS_HEAVY;
+    } else {
+        return -1;
+    }
+    val_str = strchr(val_str, ':') + 1;
+    options.vcounts_param = strtod(val_str, &end);
+    if (end == val_str || '\0' != *end) {
+        return -1;
+    }
+    switch (options.vcounts) {
+        case OMB_VCOUNTS_ZIPF:
+            return options.vcounts_param > 0.0 ? 0 : -1;
+        case OMB_VCOUNTS_SPARSE:
+            return options.vcounts_param >= 0.0 &&
+                options.vcounts_param < 1.0 ? 0 : -1;
+        default:
+            return options.vcounts_param >= 1.0 ? 0 : -1;
+    }
+}
+
+/* K or SIZE,SIZE[,...], then optionally :COMMS and :waitall or :testany */
+static int set_in_flight (char *val_str)
+{
+    char *field, *size, *save = NULL, *size_save = NULL, *end = NULL;
+    long value;
+
+    field = strtok_r(val_str, ":", &save);
+    if (NULL == field) {
+        return -1;
+    }
+    if (NULL != strchr(field, ',')) {
+        options.in_flight = 0;
+        for (size = strtok_r(field, ",", &size_save); NULL != size;
+                size = strtok_r(NULL, ",", &size_save)) {
+            value = strtol(size, &end, 10);
+            if (end == size || '\0' != *end || value < 1 ||
+                    OMB_INFLIGHT_MAX_OPS == options.in_flight) {
+                return -1;
+            }
+            options.in_flight_sizes[options.in_flight++] = value;
+        }
+        options.in_flight_fixed = 1;
+    } else {
+        value = strtol(field, &end, 10);
+        if (end == field || '\0' != *end || value < 1 ||
+                value > OMB_INFLIGHT_MAX_OPS) {
+            return -1;
+        }
+        options.in_flight = value;
+    }
+
+    field = strtok_r(NULL, ":", &save);
+    if (NULL != field) {
+        value = strtol(field, &end, 10);
+        if (end == field || '\0' != *end || value < 1 ||
+                value > OMB_INFLIGHT_MAX_OPS) {
+            return -1;
+        }
+        options.in_flight_comms = value;
+        field = strtok_r(NULL, ":", &save);
+    }
+    if (NULL != field) {
+        if (0 == strcasecmp(field, "testany")) {
+            options.in_flight_testany = 1;
+        } else if (strcasecmp(field, "waitall")) {
+            return -1;
+        }
+    }
+
+    return options.in_flight && NULL == strtok_r(NULL, ":", &save) ? 0 : -1;
+}
+
+/*
+ * MAXLOC and MINLOC need value-index pairs and pairs only support them;
+ * complex numbers have no ordering.
+ */
+int omb_reduce_valid (int dtype, int op)
+{
+    if (OMB_DTYPE_FLOAT_INT == dtype) {
+        return OMB_OP_MAXLOC == op || OMB_OP_MINLOC == op;
+    }
+    if (OMB_OP_MAXLOC == op || OMB_OP_MINLOC == op) {
+        return 0;
+    }
+    if (OMB_DTYPE_COMPLEX == dtype) {
+        return OMB_OP_SUM == op;
+    }
+
+    return 1;
+}
+
+static char const *omb_reduce_name (omb_reduce_name_t const *table, int value)
+{
+    int i;
+
+    for (i = 0; NULL != table[i].name && value != table[i].value; i++);
+
+    return NULL != table[i].name ? table[i].name : "unknown";
+}
+
+char const *omb_reduce_dtype_name (int dtype)
+{
+    return omb_reduce_name(omb_reduce_dtype_table, dtype);
+}
+
+char const *omb_reduce_op_name (int op)
+{
+    return omb_reduce_name(omb_reduce_op_table, op);
+}
+
+char const *omb_ref_algo_name (int algo)
+{
+    return omb_reduce_name(omb_ref_algo_table, algo);
+}
+
+/* One of the reference algorithms the benchmark offers in show_ref_algo */
+static int set_ref_algo (char *val_str)
+{
+    int i;
+
+    for (i = 0; NULL != omb_ref_algo_table[i].name &&
+            strcasecmp(val_str, omb_ref_algo_table[i].name); i++);
+    if (NULL == omb_ref_algo_table[i].name ||
+            !(options.show_ref_algo & omb_ref_algo_table[i].value)) {
+        return -1;
+    }
+    options.ref_algo = omb_ref_algo_table[i].value;
+
+    return 0;
+}
+
+char const *omb_throughput_name (int throughput)
+{
+    return omb_reduce_name(omb_throughput_table, throughput);
+}
+
+/* indep, or chain where the benchmark offers it in show_throughput */
+static int set_throughput (char *val_str)
+{
+    int i;
+
+    for (i = 0; NULL != omb_throughput_table[i].name &&
+            strcasecmp(val_str, omb_throughput_table[i].name); i++);
+    if (NULL == omb_throughput_table[i].name ||
+            !(options.show_throughput & omb_throughput_table[i].value)) {
+        return -1;
+    }
+    options.throughput = omb_throughput_table[i].value;
+
+    return 0;
+}
+
+/*
+ * Pick the first valid datatype and op from the -B and -O masks. More than
+ * one datatype or op selects the sweep, which prints latency only.
+ */
+static int set_reduce_selection (void)
+{
+    int dtype, op;
+
+    bad_usage.optarg = NULL;
+    options.reduce_sweep = (options.reduce_dtypes & (options.reduce_dtypes -
+                1)) || (options.reduce_ops & (options.reduce_ops - 1));
+    options.reduce_dtype = 0;
+    for (dtype = 1; dtype <= OMB_DTYPE_ALL && !options.reduce_dtype;
+            dtype <<= 1) {
+        for (op = 1; op <= OMB_OP_ALL; op <<= 1) {
+            if ((options.reduce_dtypes & dtype) &&
+                    (options.reduce_ops & op) && omb_reduce_valid(dtype, op)) {
+                options.reduce_dtype = dtype;
+                options.reduce_op = op;
+                break;
+            }
+        }
+    }
+    if (!options.reduce_dtype) {
+        bad_usage.message = "No valid datatype and op combination";
+        return -1;
+    }
+    if ((OMB_DTYPE_FLOAT != options.reduce_dtype ||
+                OMB_OP_SUM != options.reduce_op || options.reduce_sweep) &&
+            NONE != options.accel) {
+        bad_usage.message = "Datatype and op selection requires host buffers";
+        return -1;
+    }
+    if (options.reduce_sweep && (options.validate || options.persistent ||
+                options.algo_sweep || options.soak_duration > 0 ||
+                (options.subtype != REDUCE &&
+                 options.subtype != REDUCE_SCATTER))) {
+        bad_usage.message = "The datatype and op sweep runs alone and only in "
+            "the blocking reduction benchmarks";
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Parse DURATION[:INTERVAL[:THRESHOLD]] for soak mode. Durations are in
+ * seconds, the threshold is a percentage.
+ */
+static int set_soak (char *val_str)
+{
+    char *val;
+
+    val = strtok(val_str, ":");
+    if (NULL == val || 0 >= atof(val)) {
+        return -1;
+    }
+    options.soak_duration = atof(val);
+
+    val = strtok(NULL, ":");
+    if (NULL == val) {
+        return 0;
+    }
+    options.soak_interval = atof(val);
+    if (0 >= options.soak_interval) {
+        return -1;
+    }
+
+    val = strtok(NULL, ":");
+    if (NULL == val) {
+        return 0;
+    }
+    options.soak_threshold = atof(val);
+    if (0 >= options.soak_threshold) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Parse DIMS[:PERIODIC] for osu_halo. DIMS is either the number of
+ * dimensions (2 or 3), leaving the decomposition to MPI_Dims_create, or an
+ * explicit decomposition such as 4x2 or 2x0x2 where 0 is filled in by MPI.
+ */
+static int set_grid (char *val_str)
+{
+    char *dims, *periodic, *dim, *save = NULL;
+    int ndims = 0;
+
+    dims = strtok_r(val_str, ":", &save);
+    periodic = strtok_r(NULL, ":", &save);
+    if (NULL == dims) {
+        return -1;
+    }
+
+    options.grid_dims[0] = options.grid_dims[1] = options.grid_dims[2] = 0;
+    if (NULL == strchr(dims, 'x')) {
+        ndims = atoi(dims);
+    } else {
+        for (dim = strtok_r(dims, "x", &save); NULL != dim;
+                dim = strtok_r(NULL, "x", &save)) {
+            if (3 == ndims || 0 > atoi(dim)) {
+                return -1;
+            }
+            options.grid_dims[ndims++] = atoi(dim);
+        }
+    }
+    if (2 != ndims && 3 != ndims) {
+        return -1;
+    }
+    options.grid_ndims = ndims;
+
+    if (NULL != periodic) {
+        options.grid_periodic = atoi(periodic);
+        if (0 != options.grid_periodic && 1 != options.grid_periodic) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Parse the graph used by the neighborhood collective benchmarks:
+ * ring, kreg[:K], stencil2d, stencil3d or file:PATH.
+ */
+static int set_topology (char *val_str)
+{
+    char *arg = strchr(val_str, ':');
+
+    if (NULL != arg) {
+        *arg++ = '\0';
+    }
+
+    if (0 == strcasecmp(val_str, "ring")) {
+        options.topology = OMB_TOPOLOGY_RING;
+    } else if (0 == strcasecmp(val_str, "kreg")) {
+        options.topology = OMB_TOPOLOGY_KREG;
+        if (NULL != arg) {
+            options.topology_degree = atoi(arg);
+            if (1 > options.topology_degree) {
+                return -1;
+            }
+        }
+        return 0;
+    } else if (0 == strcasecmp(val_str, "stencil2d")) {
+        options.topology = OMB_TOPOLOGY_STENCIL2D;
+    } else if (0 == strcasecmp(val_str, "stencil3d")) {
+        options.topology = OMB_TOPOLOGY_STENCIL3D;
+    } else if (0 == strcasecmp(val_str, "file")) {
+        if (NULL == arg || '\0' == *arg) {
+            return -1;
+        }
+        if (OMB_TOPOLOGY_FILE_PATH_MAX_LENGTH <= strlen(arg)) {
+            fprintf(stderr, "ERROR: Max allowed size for filepath is:%d\n"
+                    "To increase the max allowed filepath limit, update"
+                    " OMB_TOPOLOGY_FILE_PATH_MAX_LENGTH in"
+                    " c/util/osu_util.h.\n",
+                    OMB_TOPOLOGY_FILE_PATH_MAX_LENGTH);
+            fflush(stderr);
+            return -1;
+        }
+        options.topology = OMB_TOPOLOGY_FILE;
+        strcpy(options.topology_file, arg);
+        return 0;
+    } else {
+        return -1;
+    }
+
+    return (NULL == arg) ? 0 : -1;
+}
+
+/* Parse a comma separated list of halo exchange methods for osu_halo */
+static int set_exchange_types (char *val_str)
+{
+    char *type, *save = NULL;
+
+    options.exchange_types = 0;
+    for (type = strtok_r(val_str, ",", &save); NULL != type;
+            type = strtok_r(NULL, ",", &save)) {
+        if (0 == strcasecmp(type, "isend")) {
+            options.exchange_types |= OMB_EXCHANGE_ISEND;
+        } else if (0 == strcasecmp(type, "persistent")) {
+            options.exchange_types |= OMB_EXCHANGE_PERSISTENT;
+        } else if (0 == strcasecmp(type, "neighbor")) {
+            options.exchange_types |= OMB_EXCHANGE_NEIGHBOR;
+        } else if (0 == strcasecmp(type, "all")) {
+            options.exchange_types |= OMB_EXCHANGE_ALL;
+        } else {
+            return -1;
+        }
+    }
+
+    return options.exchange_types ? 0 : -1;
+}
+
 static int set_num_warmup (int value)
 {
     if (0 > value) {
@@ -403,7 +1028,14 @@ void set_benchmark_name (const char * name)
 void enable_accel_support (void)
 {
     accel_enabled = ((CUDA_ENABLED || OPENACC_ENABLED || ROCM_ENABLED) &&
-                     !(options.subtype == LAT_MP));
+                     !(options.subtype == LAT_MP ||
+                       options.subtype == LAT_LOAD ||
+                       options.subtype == CONGESTION ||
+                       options.subtype == HALO ||
+                       options.subtype == NEIGHBOR ||
+                       options.subtype == NBC_NEIGHBOR ||
+                       options.subtype == LAT_OVERLAP ||
+                       options.subtype == BW_OVERLAP));
 }
 
 int process_options (int argc, char *argv[])
@@ -413,11 +1045,13 @@ int process_options (int argc, char *argv[])
 
     char const * optstring = NULL;
     char optstring_buf[80];
+    char optstring_ext[128];
     int c, ret = PO_OKAY;
 
     int option_index = 0;
     char *graph_term_type = NULL;
-    int omb_long_options_itr = OMB_LONG_OPTIONS_ARRAY_SIZE - 1;
+    /* Last slot is the terminating zero entry, the one before it is DDT */
+    int omb_long_options_itr = OMB_LONG_OPTIONS_ARRAY_SIZE - 2;
     static struct option long_options[OMB_LONG_OPTIONS_ARRAY_SIZE] = {
             {"help",                no_argument,        0,  'h'},
             {"version",             no_argument,        0,  'v'},
@@ -440,7 +1074,33 @@ int process_options (int argc, char *argv[])
             {"buffer-num",          required_argument,  0,  'b'},
             {"validation-warmup",   required_argument,  0,  'u'},
             {"graph",               required_argument,  0,  'G'},
-            {"papi",                required_argument,  0,  'P'}
+            {"papi",                required_argument,  0,  'P'},
+            {"any-source",          no_argument,        0,  'A'},
+            {"jump-threshold",      required_argument,  0,  'j'},
+            {"load",                required_argument,  0,  'L'},
+            {"pattern",             required_argument,  0,  'T'},
+            {"num-trials",          required_argument,  0,  'n'},
+            {"grid",                required_argument,  0,  'g'},
+            {"halo",                required_argument,  0,  'k'},
+            {"exchange",            required_argument,  0,  'e'},
+            {"topology",            required_argument,  0,  'o'},
+            {"pairing",             required_argument,  0,  'S'},
+            {"soak",                required_argument,  0,  'Z'},
+            {"ipc-floor",           no_argument,        0,  'F'},
+            {"touch-data",          no_argument,        0,  'X'},
+            {"algo-sweep",          optional_argument,  0,  'C'},
+            {"pvars",               required_argument,  0,  'Q'},
+            {"persistent",          no_argument,        0,  'N'},
+            {"datatype",            required_argument,  0,  'B'},
+            {"op",                  required_argument,  0,  'O'},
+            {"in-place",            no_argument,        0,  'I'},
+            {"comm-shape",          required_argument,  0,  'K'},
+            {"ref-algo",            required_argument,  0,  'E'},
+            {"skew",                required_argument,  0,  'J'},
+            {"throughput",          required_argument,  0,  'q'},
+            {"in-flight",           required_argument,  0,  'z'},
+            {"counts",              required_argument,  0,  'y'},
+            {"per-rank",            required_argument,  0,  'U'}
     };
 
     enable_accel_support();
@@ -448,19 +1108,39 @@ int process_options (int argc, char *argv[])
     if (options.bench == PT2PT) {
         if (accel_enabled) {
             if (options.subtype == BW) {
-                optstring = "+:x:i:t:m:d:W:hvb:cu:G:D:";
+                optstring = "+:x:i:t:m:M:d:W:hvb:cu:G:D:";
+            } else if (options.subtype == LAT_PROBE) {
+                optstring = "+:x:i:m:d:hvcu:A";
+            } else if (options.subtype == LAT_SWITCH) {
+                optstring = "+:x:i:m:d:hvj:";
+            } else if (options.show_pairing) {
+                optstring = "+:x:i:m:d:hvcu:G:D:S:";
             } else {
-                optstring = "+:x:i:m:d:hvcu:G:D:";
+                optstring = "+:x:i:m:M:d:hvcu:G:D:";
             }
         } else{
             if (options.subtype == LAT_MT) {
                 optstring = "+:hvm:x:i:t:d:cu:G:D:";
+            } else if (options.subtype == LAT_PROBE) {
+                optstring = "+:hvm:x:i:cu:AP:";
+            } else if (options.subtype == LAT_SWITCH) {
+                optstring = "+:hvm:x:i:j:";
+            } else if (options.subtype == LAT_LOAD) {
+                optstring = "+:hvm:x:i:p:L:";
+            } else if (options.subtype == CONGESTION) {
+                optstring = "+:hvm:x:i:W:T:n:";
+            } else if (options.subtype == LAT_OVERLAP) {
+                optstring = "+:hvfm:x:i:t:";
+            } else if (options.subtype == BW_OVERLAP) {
+                optstring = "+:hvfm:x:i:t:W:";
             } else if (options.subtype == LAT_MP) {
                 optstring = "+:hvm:x:i:t:cu:G:D:P:";
             } else if (options.subtype == BW) {
-                optstring = "+:hvm:x:i:t:W:b:cu:G:D:P:";
+                optstring = "+:hvm:M:x:i:t:W:b:cu:G:D:P:";
+            } else if (options.show_pairing) {
+                optstring = "+:hvm:x:i:b:cu:G:D:P:S:";
             } else {
-                optstring = "+:hvm:x:i:b:cu:G:D:P:";
+                optstring = "+:hvm:M:x:i:b:cu:G:D:P:";
             }
         }
         long_options[omb_long_options_itr].name = "ddt";
@@ -468,7 +1148,13 @@ int process_options (int argc, char *argv[])
         long_options[omb_long_options_itr].flag = 0;
         long_options[omb_long_options_itr].val = 'D';
     } else if (options.bench == COLLECTIVE) {
-        if (options.subtype == LAT ||
+        if (options.subtype == HALO) {
+            optstring = "+:hvfm:i:x:M:g:k:e:";
+        } else if (options.subtype == NEIGHBOR) {
+            optstring = "+:hvfm:i:x:M:G:P:o:";
+        } else if (options.subtype == NBC_NEIGHBOR) {
+            optstring = "+:hvfm:i:x:M:t:G:P:o:";
+        } else if (options.subtype == LAT ||
                 options.subtype == BARRIER ||
                 options.subtype == ALLTOALL ||
                 options.subtype == GATHER ||
@@ -574,6 +1260,26 @@ int process_options (int argc, char *argv[])
         exit(1);
     }
 
+    /* MPI_T pvars are sampled wherever the PAPI counters are */
+    snprintf(optstring_ext, sizeof(optstring_ext), "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
+            optstring,
+            NULL != strchr(optstring, 'P') ? "Q:" : "",
+            options.show_soak ? "Z:" : "",
+            options.show_ipc_floor ? "F" : "",
+            options.show_touch_data ? "X" : "",
+            options.show_algo_sweep ? "C::" : "",
+            options.show_persistent ? "N" : "",
+            options.show_reduce_types ? "B:O:" : "",
+            options.show_in_place ? "I" : "",
+            options.show_comm_shape ? "K:" : "",
+            options.show_ref_algo ? "E:" : "",
+            options.show_skew ? "J:" : "",
+            options.show_throughput ? "q:" : "",
+            options.show_in_flight ? "z:" : "",
+            options.show_vcounts ? "y:" : "",
+            options.show_per_rank ? "U:" : "");
+    optstring = optstring_ext;
+
     /* Set default options*/
     options.accel = NONE;
     options.show_size = 1;
@@ -594,6 +1300,53 @@ int process_options (int argc, char *argv[])
     options.print_rate = 1;
     options.validate = 0;
     options.papi_enabled = 0;
+    options.pvar_enabled = 0;
+    options.pvars = NULL;
+    options.any_source = 0;
+    options.jump_threshold = OMB_JUMP_THRESHOLD_DEFAULT;
+    options.load_size = OMB_LOAD_SIZE_DEFAULT;
+    options.load_window = OMB_LOAD_WINDOW_DEFAULT;
+    options.load_duty = OMB_LOAD_DUTY_DEFAULT;
+    options.patterns = OMB_PATTERN_ALL;
+    options.pattern_shift = 1;
+    options.num_trials = OMB_NUM_TRIALS_DEFAULT;
+    options.grid_ndims = 3;
+    options.grid_dims[0] = options.grid_dims[1] = options.grid_dims[2] = 0;
+    options.grid_periodic = 1;
+    options.halo_type = OMB_HALO_FACES;
+    options.exchange_types = OMB_EXCHANGE_ALL;
+    options.topology = OMB_TOPOLOGY_RING;
+    options.topology_degree = OMB_TOPOLOGY_DEGREE_DEFAULT;
+    options.topology_file[0] = '\0';
+    options.pairing = OMB_PAIRING_BLOCK;
+    options.soak_duration = 0;
+    options.soak_interval = OMB_SOAK_INTERVAL_DEFAULT;
+    options.soak_threshold = OMB_SOAK_THRESHOLD_DEFAULT;
+    options.ipc_floor = 0;
+    options.touch_data = 0;
+    options.algo_sweep = 0;
+    options.algo_rules = NULL;
+    options.persistent = 0;
+    options.reduce_dtypes = OMB_DTYPE_FLOAT;
+    options.reduce_ops = OMB_OP_SUM;
+    options.reduce_dtype = OMB_DTYPE_FLOAT;
+    options.reduce_op = OMB_OP_SUM;
+    options.in_place = 0;
+    options.comm_shape = OMB_SHAPE_WORLD;
+    options.comm_groups = 1;
+    options.ref_algo = OMB_REF_NONE;
+    options.skew = OMB_SKEW_NONE;
+    options.skew_us = 0.0;
+    options.skew_sd = 0.0;
+    options.throughput = OMB_THROUGHPUT_NONE;
+    options.in_flight = 0;
+    options.in_flight_comms = 1;
+    options.in_flight_testany = 0;
+    options.in_flight_fixed = 0;
+    options.vcounts = OMB_VCOUNTS_REGULAR;
+    options.vcounts_param = 0.0;
+    options.per_rank = 0;
+    options.per_rank_file[0] = '\0';
     options.buf_num = SINGLE;
     options.omb_enable_ddt = 0;
     options.ddt_type_parameters.block_length = OMB_DDT_BLOCK_LENGTH_DEFAULT;
@@ -610,6 +1363,8 @@ int process_options (int argc, char *argv[])
 
     switch (options.subtype) {
         case BW:
+        case CONGESTION:
+        case BW_OVERLAP:
             options.iterations = BW_LOOP_SMALL;
             options.skip = BW_SKIP_SMALL;
             options.iterations_large = BW_LOOP_LARGE;
@@ -625,6 +1380,13 @@ int process_options (int argc, char *argv[])
             options.min_message_size = 0;
             options.sender_processes = DEF_NUM_PROCESSES;
         case LAT:
+        case LAT_PROBE:
+        case LAT_SWITCH:
+        case LAT_LOAD:
+        case LAT_OVERLAP:
+        case HALO:
+        case NEIGHBOR:
+        case NBC_NEIGHBOR:
         case BARRIER:
         case GATHER:
         case ALLTOALL:
@@ -713,6 +1475,14 @@ int process_options (int argc, char *argv[])
                             bad_usage.message = "Invalid Number of Processes";
                             bad_usage.optarg = optarg;
 
+                            return PO_BAD_USAGE;
+                        }
+                    } else if (options.subtype == LAT_OVERLAP ||
+                            options.subtype == BW_OVERLAP) {
+                        if (set_num_probes(atoi(optarg))) {
+                            bad_usage.message = "Invalid Number of Probes";
+                            bad_usage.optarg = optarg;
+
                             return PO_BAD_USAGE;
                         }
                     }
@@ -878,6 +1648,210 @@ int process_options (int argc, char *argv[])
                 return PO_BAD_USAGE;
 #endif
                 break;
+            case 'Q':
+                options.pvar_enabled = 1;
+                options.pvars = optarg;
+                break;
+            case 'A':
+                options.any_source = 1;
+                break;
+            case 'j':
+                options.jump_threshold = atof(optarg);
+                if (options.jump_threshold <= 0) {
+                    bad_usage.message = "Invalid Jump Threshold";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'L':
+                if (set_load(optarg)) {
+                    bad_usage.message = "Invalid Load Specification";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'T':
+                if (set_patterns(optarg)) {
+                    bad_usage.message = "Invalid Traffic Pattern";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'n':
+                options.num_trials = atoi(optarg);
+                if (1 > options.num_trials) {
+                    bad_usage.message = "Invalid Number of Trials";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'g':
+                if (set_grid(optarg)) {
+                    bad_usage.message = "Invalid Grid Specification";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'k':
+                if (0 == strcasecmp(optarg, "faces")) {
+                    options.halo_type = OMB_HALO_FACES;
+                } else if (0 == strcasecmp(optarg, "edges")) {
+                    options.halo_type = OMB_HALO_EDGES;
+                } else if (0 == strcasecmp(optarg, "corners")) {
+                    options.halo_type = OMB_HALO_CORNERS;
+                } else {
+                    bad_usage.message = "Please use faces, edges or corners";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'e':
+                if (set_exchange_types(optarg)) {
+                    bad_usage.message = "Invalid Exchange Type";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'o':
+                if (set_topology(optarg)) {
+                    bad_usage.message = "Invalid Topology";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'S':
+                if (0 == strcasecmp(optarg, "block")) {
+                    options.pairing = OMB_PAIRING_BLOCK;
+                } else if (0 == strcasecmp(optarg, "intranode")) {
+                    options.pairing = OMB_PAIRING_INTRANODE;
+                } else if (0 == strcasecmp(optarg, "internode")) {
+                    options.pairing = OMB_PAIRING_INTERNODE;
+                } else if (0 == strcasecmp(optarg, "nearest")) {
+                    options.pairing = OMB_PAIRING_NEAREST;
+                } else if (0 == strcasecmp(optarg, "farthest")) {
+                    options.pairing = OMB_PAIRING_FARTHEST;
+                } else if (0 == strcasecmp(optarg, "random")) {
+                    options.pairing = OMB_PAIRING_RANDOM;
+                } else {
+                    bad_usage.message = "Please use block, intranode, "
+                        "internode, nearest, farthest or random";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'Z':
+                if (set_soak(optarg)) {
+                    bad_usage.message = "Invalid Soak Specification";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'F':
+                options.ipc_floor = 1;
+                break;
+            case 'X':
+                options.touch_data = 1;
+                break;
+            case 'C':
+                options.algo_sweep = 1;
+                options.algo_rules = optarg;
+                break;
+            case 'N':
+                options.persistent = 1;
+                break;
+            case 'I':
+                options.in_place = 1;
+                break;
+            case 'K':
+                if (set_comm_shape(optarg)) {
+                    bad_usage.message = "Please use world, node, leaders, row, "
+                        "col or groups:K";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'J':
+                if (set_skew(optarg)) {
+                    bad_usage.message = "Please use late:US, ramp:US, "
+                        "uniform:US, exp:US or normal:US:SD";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'q':
+                if (set_throughput(optarg)) {
+                    bad_usage.message = "Throughput variant not available "
+                        "for this benchmark";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'z':
+                if (set_in_flight(optarg)) {
+                    bad_usage.message = "Please use K or a list of sizes, "
+                        "then optionally :COMMS and :waitall or :testany";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'y':
+                if (set_vcounts(optarg)) {
+                    bad_usage.message = "Please use uniform, zipf:S (S > 0), "
+                        "sparse:F (0 <= F < 1), heavy:F (F >= 1) or file:PATH";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'U':
+                if (set_per_rank(optarg)) {
+                    bad_usage.message = "Please use K or K:FILE with K > 0";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'E':
+                if (set_ref_algo(optarg)) {
+                    bad_usage.message = "Reference algorithm not available "
+                        "for this benchmark";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'B':
+                if (set_reduce_list(optarg, omb_reduce_dtype_table,
+                            &options.reduce_dtypes)) {
+                    bad_usage.message = "Invalid Datatype";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
+            case 'O':
+                if (set_reduce_list(optarg, omb_reduce_op_table,
+                            &options.reduce_ops)) {
+                    bad_usage.message = "Invalid Reduction Operation";
+                    bad_usage.optarg = optarg;
+
+                    return PO_BAD_USAGE;
+                }
+                break;
             case 'u':
                 if (set_num_warmup_validation(atoi(optarg))) {
                     bad_usage.message = "Invalid Number of Validation Warmup "
@@ -1019,6 +1993,124 @@ int process_options (int argc, char *argv[])
         }
     }
 
+    if (options.algo_sweep && (options.validate ||
+                options.soak_duration > 0)) {
+        bad_usage.message = "Algorithm sweep cannot be combined with "
+            "validation or soak mode";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.persistent && (options.algo_sweep ||
+                options.soak_duration > 0)) {
+        bad_usage.message = "Persistent collectives cannot be combined with "
+            "an algorithm sweep or soak mode";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.show_reduce_types && set_reduce_selection()) {
+        return PO_BAD_USAGE;
+    }
+
+    if (options.in_place && (options.algo_sweep || options.reduce_sweep ||
+                options.soak_duration > 0 || options.omb_enable_ddt)) {
+        bad_usage.message = "In-place collectives cannot be combined with "
+            "a sweep, soak mode or derived datatypes";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (OMB_SHAPE_WORLD != options.comm_shape && (options.validate ||
+                options.algo_sweep || options.reduce_sweep ||
+                options.soak_duration > 0 || options.in_place)) {
+        bad_usage.message = "Communicator shapes cannot be combined with "
+            "validation, a sweep, soak mode or in-place";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.ref_algo && (NONE != options.accel || options.omb_enable_ddt ||
+                options.in_place || OMB_SHAPE_WORLD != options.comm_shape ||
+                options.persistent || options.algo_sweep ||
+                options.reduce_sweep || options.soak_duration > 0)) {
+        bad_usage.message = "Reference algorithms need host buffers and "
+            "cannot be combined with derived datatypes, in-place, shapes, "
+            "persistent, a sweep or soak mode";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.skew && (options.algo_sweep || options.reduce_sweep ||
+                options.soak_duration > 0)) {
+        bad_usage.message = "Arrival skew cannot be combined with a sweep "
+            "or soak mode";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.throughput && (options.algo_sweep || options.reduce_sweep ||
+                options.soak_duration > 0)) {
+        bad_usage.message = "Throughput mode cannot be combined with a sweep "
+            "or soak mode";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.in_flight && (options.validate || options.in_place ||
+                options.omb_enable_ddt || options.skew ||
+                options.reduce_sweep)) {
+        bad_usage.message = "In-flight mode cannot be combined with "
+            "validation, in-place, derived datatypes, arrival skew or a sweep";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.per_rank && (options.algo_sweep || options.reduce_sweep ||
+                options.soak_duration > 0 || options.in_flight)) {
+        bad_usage.message = "Per-rank reports cannot be combined with a "
+            "sweep, soak or in-flight mode";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.vcounts && (options.omb_enable_ddt || options.in_place ||
+                OMB_SHAPE_WORLD != options.comm_shape || options.algo_sweep ||
+                options.soak_duration > 0 ||
+                (options.validate && NONE != options.accel))) {
+        bad_usage.message = "Count distributions cannot be combined with "
+            "derived datatypes, in-place, shapes, a sweep, soak mode or "
+            "validation of device buffers";
+        bad_usage.optarg = NULL;
+
+        return PO_BAD_USAGE;
+    }
+
+    if (options.touch_data) {
+        if ('H' != options.src || 'H' != options.dst) {
+            bad_usage.message = "Data touch requires host buffers";
+            bad_usage.optarg = NULL;
+
+            return PO_BAD_USAGE;
+        }
+        if (options.validate || options.soak_duration > 0) {
+            bad_usage.message = "Data touch cannot be combined with "
+                "validation or soak mode";
+            bad_usage.optarg = NULL;
+
+            return PO_BAD_USAGE;
+        }
+    }
+
     return PO_OKAY;
 }
 
@@ -1126,4 +2218,19 @@ void wtime(double *t)
     *t = (tv.tv_sec - sec)*1.0e+6 + tv.tv_usec;
 }
 
+int omb_compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of an array sorted in ascending order */
+double omb_percentile(double *sorted, int count, double pct)
+{
+    int index = (int)ceil(pct / 100.0 * count) - 1;
+
+    return sorted[MAX(0, MIN(index, count - 1))];
+}
+
 /* vi:set sw=4 sts=4 tw=80: */
@@ -27,6 +27,8 @@
 #include <inttypes.h>
 #include <sys/time.h>
 #include <limits.h>
+#include <float.h>
+#include <ctype.h>
 #include <sys/types.h>
 
 #ifdef _ENABLE_PAPI_
@@ -165,7 +167,7 @@ enum mpi_req{
     MAX_REQ_NUM = 1000
 };
 
-#define OMB_LONG_OPTIONS_ARRAY_SIZE 23
+#define OMB_LONG_OPTIONS_ARRAY_SIZE 50
 #define BW_LOOP_SMALL 100
 #define BW_SKIP_SMALL 10
 #define BW_LOOP_LARGE 20
@@ -191,11 +193,21 @@ enum mpi_req{
 #define OMB_DDT_BLOCK_LENGTH_DEFAULT 4
 #define OMB_FILE_PATH_MAX_LENGTH 1024
 #define OMB_DDT_FILE_PATH_MAX_LENGTH OMB_FILE_PATH_MAX_LENGTH
+#define OMB_TOPOLOGY_FILE_PATH_MAX_LENGTH OMB_FILE_PATH_MAX_LENGTH
 #define MAX_MESSAGE_SIZE (1 << 22)
 #define MAX_MSG_SIZE_PT2PT (1<<20)
 #define MAX_MSG_SIZE_COLL (1<<20)
 #define MIN_MESSAGE_SIZE 1
 #define LARGE_MESSAGE_SIZE 8192
+#define OMB_JUMP_THRESHOLD_DEFAULT 20.0
+#define OMB_LOAD_SIZE_DEFAULT (1<<20)
+#define OMB_LOAD_WINDOW_DEFAULT 64
+#define OMB_LOAD_DUTY_DEFAULT 100
+#define OMB_NUM_TRIALS_DEFAULT 10
+#define OMB_TOPOLOGY_DEGREE_DEFAULT 4
+#define OMB_SOAK_INTERVAL_DEFAULT 10.0
+#define OMB_SOAK_THRESHOLD_DEFAULT 10.0
+#define OMB_INFLIGHT_MAX_OPS 64
 
 #define MAX_ALIGNMENT 65536
 #define MAX_MEM_LIMIT (512*1024*1024)
@@ -257,7 +269,16 @@ enum test_subtype {
     NBC_BCAST,
     SCATTER,
     REDUCE,
-    BCAST
+    BCAST,
+    LAT_PROBE,
+    LAT_SWITCH,
+    LAT_LOAD,
+    CONGESTION,
+    HALO,
+    NEIGHBOR,
+    NBC_NEIGHBOR,
+    LAT_OVERLAP,
+    BW_OVERLAP
 };
 
 enum test_synctype {
@@ -290,6 +311,121 @@ enum buffer_num {
     MULTIPLE
 };
 
+/*traffic patterns, combined as a bit mask*/
+enum omb_pattern_types_t {
+    OMB_PATTERN_RANDOM = 1,
+    OMB_PATTERN_SHIFT = 2,
+    OMB_PATTERN_BITCOMP = 4,
+    OMB_PATTERN_TORNADO = 8,
+    OMB_PATTERN_ALLPAIRS = 16,
+    OMB_PATTERN_ALL = 31
+};
+
+/*halo neighbors, each level includes the previous one*/
+enum omb_halo_types_t {
+    OMB_HALO_FACES = 1,
+    OMB_HALO_EDGES,
+    OMB_HALO_CORNERS
+};
+
+/*halo exchange methods, combined as a bit mask*/
+enum omb_exchange_types_t {
+    OMB_EXCHANGE_ISEND = 1,
+    OMB_EXCHANGE_PERSISTENT = 2,
+    OMB_EXCHANGE_NEIGHBOR = 4,
+    OMB_EXCHANGE_ALL = 7
+};
+
+/*neighborhood collective topologies*/
+enum omb_topology_types_t {
+    OMB_TOPOLOGY_RING,
+    OMB_TOPOLOGY_KREG,
+    OMB_TOPOLOGY_STENCIL2D,
+    OMB_TOPOLOGY_STENCIL3D,
+    OMB_TOPOLOGY_FILE
+};
+
+/*reduction datatypes and ops, combined as bit masks*/
+enum omb_reduce_dtypes_t {
+    OMB_DTYPE_FLOAT = 1,
+    OMB_DTYPE_DOUBLE = 2,
+    OMB_DTYPE_INT = 4,
+    OMB_DTYPE_INT64 = 8,
+    OMB_DTYPE_COMPLEX = 16,
+    OMB_DTYPE_FLOAT_INT = 32,
+    OMB_DTYPE_BFLOAT16 = 64,
+    OMB_DTYPE_ALL = 127
+};
+
+enum omb_reduce_ops_t {
+    OMB_OP_SUM = 1,
+    OMB_OP_MAX = 2,
+    OMB_OP_MIN = 4,
+    OMB_OP_MAXLOC = 8,
+    OMB_OP_MINLOC = 16,
+    OMB_OP_ALL = 31
+};
+
+/*osu_multi_lat pairing strategies*/
+enum omb_pairing_types_t {
+    OMB_PAIRING_BLOCK,
+    OMB_PAIRING_INTRANODE,
+    OMB_PAIRING_INTERNODE,
+    OMB_PAIRING_NEAREST,
+    OMB_PAIRING_FARTHEST,
+    OMB_PAIRING_RANDOM
+};
+
+/*communicator shapes for the collectives*/
+enum omb_comm_shapes_t {
+    OMB_SHAPE_WORLD,
+    OMB_SHAPE_NODE,
+    OMB_SHAPE_LEADERS,
+    OMB_SHAPE_ROW,
+    OMB_SHAPE_COL,
+    OMB_SHAPE_GROUPS
+};
+
+/*reference collective algorithms*/
+enum omb_ref_algos_t {
+    OMB_REF_NONE = 0,
+    OMB_REF_HIER = 1,
+    OMB_REF_RING = 2,
+    OMB_REF_RD = 4,
+    OMB_REF_RABENSEIFNER = 8,
+    OMB_REF_BINOMIAL = 16,
+    OMB_REF_CHAIN = 32,
+    OMB_REF_BRUCK = 64,
+    OMB_REF_PAIRWISE = 128
+};
+
+/*arrival skew patterns for the collectives*/
+enum omb_skew_types_t {
+    OMB_SKEW_NONE,
+    OMB_SKEW_LATE,
+    OMB_SKEW_RAMP,
+    OMB_SKEW_UNIFORM,
+    OMB_SKEW_EXP,
+    OMB_SKEW_NORMAL
+};
+
+/*count distributions for the v-collectives*/
+enum omb_vcounts_types_t {
+    OMB_VCOUNTS_REGULAR,
+    OMB_VCOUNTS_UNIFORM,
+    OMB_VCOUNTS_ZIPF,
+    OMB_VCOUNTS_SPARSE,
+    OMB_VCOUNTS_HEAVY,
+    OMB_VCOUNTS_FILE
+};
+
+/*back-to-back throughput variants*/
+enum omb_throughput_types_t {
+    OMB_THROUGHPUT_NONE = 0,
+    OMB_THROUGHPUT_INDEP = 1,
+    OMB_THROUGHPUT_CHAIN = 2
+};
+
 /*ddt types*/
 enum omb_ddt_types_t {
     OMB_DDT_CONTIGUOUS,
@@ -359,6 +495,71 @@ struct options_t {
     enum omb_ddt_types_t ddt_type;
     omb_ddt_type_parameters_t ddt_type_parameters;
     int papi_enabled;
+    int pvar_enabled;
+    char *pvars;
+    int any_source;
+    double jump_threshold;
+    size_t load_size;
+    int load_window;
+    int load_duty;
+    int patterns;
+    int pattern_shift;
+    int num_trials;
+    int grid_ndims;
+    int grid_dims[3];
+    int grid_periodic;
+    enum omb_halo_types_t halo_type;
+    int exchange_types;
+    enum omb_topology_types_t topology;
+    int topology_degree;
+    char topology_file[OMB_TOPOLOGY_FILE_PATH_MAX_LENGTH];
+    int show_pairing;
+    enum omb_pairing_types_t pairing;
+    int show_soak;
+    double soak_duration;
+    double soak_interval;
+    double soak_threshold;
+    int show_ipc_floor;
+    int ipc_floor;
+    int show_touch_data;
+    int touch_data;
+    int show_algo_sweep;
+    int algo_sweep;
+    char *algo_rules;
+    int show_persistent;
+    int persistent;
+    int show_reduce_types;
+    int reduce_dtypes;
+    int reduce_ops;
+    int reduce_dtype;
+    int reduce_op;
+    int reduce_sweep;
+    int show_in_place;
+    int in_place;
+    int show_comm_shape;
+    enum omb_comm_shapes_t comm_shape;
+    int comm_groups;
+    int show_ref_algo;
+    int ref_algo;
+    int show_skew;
+    enum omb_skew_types_t skew;
+    double skew_us;
+    double skew_sd;
+    int show_throughput;
+    int throughput;
+    int show_in_flight;
+    int in_flight;
+    int in_flight_comms;
+    int in_flight_testany;
+    int in_flight_fixed;
+    size_t in_flight_sizes[OMB_INFLIGHT_MAX_OPS];
+    int show_vcounts;
+    enum omb_vcounts_types_t vcounts;
+    double vcounts_param;
+    char vcounts_file[OMB_FILE_PATH_MAX_LENGTH];
+    int show_per_rank;
+    int per_rank;
+    char per_rank_file[OMB_FILE_PATH_MAX_LENGTH];
 };
 
 struct bad_usage_t{
@@ -401,3 +602,10 @@ void enable_accel_support (void);
 #define WINDOW_SIZES_COUNT   (8)
 
 void wtime(double *t);
+int omb_compare_double(const void *a, const void *b);
+double omb_percentile(double *sorted, int count, double pct);
+int omb_reduce_valid(int dtype, int op);
+char const *omb_reduce_dtype_name(int dtype);
+char const *omb_reduce_op_name(int op);
+char const *omb_ref_algo_name(int algo);
+char const *omb_throughput_name(int throughput);
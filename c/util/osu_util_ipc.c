@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+
+#define _GNU_SOURCE
+#include <osu_util_mpi.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+static inline void omb_ipc_relax(int *spins)
+{
+    if (++(*spins) >= OMB_IPC_SPIN_LIMIT) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+/*
+ * Ring transfers are split into OMB_IPC_SLOT_SIZE pieces; an empty message
+ * still occupies one slot so it can serve as a notification.
+ */
+static void omb_ipc_ring_send(omb_ipc_ring_t *ring, char const *buf,
+                              size_t size)
+{
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    size_t offset = 0, len = 0;
+    int spins = 0;
+
+    do {
+        len = size - offset;
+        if (len > OMB_IPC_SLOT_SIZE) {
+            len = OMB_IPC_SLOT_SIZE;
+        }
+        while (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >=
+                OMB_IPC_RING_SLOTS) {
+            omb_ipc_relax(&spins);
+        }
+        memcpy(ring->slots[head % OMB_IPC_RING_SLOTS], buf + offset, len);
+        __atomic_store_n(&ring->head, ++head, __ATOMIC_RELEASE);
+        offset += len;
+    } while (offset < size);
+}
+
+static void omb_ipc_ring_recv(omb_ipc_ring_t *ring, char *buf, size_t size)
+{
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    size_t offset = 0, len = 0;
+    int spins = 0;
+
+    do {
+        len = size - offset;
+        if (len > OMB_IPC_SLOT_SIZE) {
+            len = OMB_IPC_SLOT_SIZE;
+        }
+        while (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail) {
+            omb_ipc_relax(&spins);
+        }
+        memcpy(buf + offset, ring->slots[tail % OMB_IPC_RING_SLOTS], len);
+        __atomic_store_n(&ring->tail, ++tail, __ATOMIC_RELEASE);
+        offset += len;
+    } while (offset < size);
+}
+
+static void omb_ipc_post(omb_ipc_t *ipc, uint64_t seq)
+{
+    __atomic_store_n(&ipc->shared->flag[ipc->leader ? 0 : 1].value, seq,
+            __ATOMIC_RELEASE);
+}
+
+static void omb_ipc_wait(omb_ipc_t *ipc, uint64_t seq)
+{
+    uint64_t *flag = &ipc->shared->flag[ipc->leader ? 1 : 0].value;
+    int spins = 0;
+
+    while (__atomic_load_n(flag, __ATOMIC_ACQUIRE) < seq) {
+        omb_ipc_relax(&spins);
+    }
+}
+
+/* Copy size bytes of the peer's send buffer straight into our receive buffer */
+static int omb_ipc_cma_read(omb_ipc_t *ipc, size_t size)
+{
+#ifdef HAVE_PROCESS_VM_READV
+    struct iovec local, remote;
+    ssize_t nread = 0;
+    size_t offset = 0;
+
+    while (offset < size) {
+        local.iov_base = ipc->r_buf + offset;
+        local.iov_len = size - offset;
+        remote.iov_base = (char *)ipc->peer_buf + offset;
+        remote.iov_len = size - offset;
+        nread = process_vm_readv(ipc->peer_pid, &local, 1, &remote, 1, 0);
+        if (0 >= nread) {
+            return -1;
+        }
+        offset += nread;
+    }
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+static void omb_ipc_pull(omb_ipc_t *ipc, size_t size)
+{
+    if (omb_ipc_cma_read(ipc, size)) {
+        fprintf(stderr, "process_vm_readv from pid %d failed\n",
+                ipc->peer_pid);
+        MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+    }
+}
+
+/*
+ * The leader creates and sizes the segment, the follower maps it and the
+ * leader unlinks the name once both sides hold a mapping.
+ */
+static int omb_ipc_map(omb_ipc_t *ipc, int peer, MPI_Comm comm)
+{
+    char name[64];
+    int leader_pid = ipc->leader ? (int)getpid() : ipc->peer_pid;
+    int fd = -1, mapped = 0, peer_mapped = 0;
+
+    snprintf(name, sizeof(name), "/omb_ipc_%d", leader_pid);
+    if (ipc->leader) {
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (0 <= fd && 0 != ftruncate(fd, sizeof(omb_ipc_shared_t))) {
+            close(fd);
+            shm_unlink(name);
+            fd = -1;
+        }
+    } else {
+        MPI_CHECK(MPI_Recv(&peer_mapped, 1, MPI_INT, peer, 1, comm,
+                    MPI_STATUS_IGNORE));
+        if (peer_mapped) {
+            fd = shm_open(name, O_RDWR, 0600);
+        }
+    }
+
+    if (0 <= fd) {
+        ipc->shared = mmap(NULL, sizeof(omb_ipc_shared_t),
+                PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        mapped = (MAP_FAILED != ipc->shared);
+        if (!mapped) {
+            ipc->shared = NULL;
+        }
+    }
+
+    if (ipc->leader) {
+        if (mapped) {
+            memset(ipc->shared, 0, sizeof(omb_ipc_shared_t));
+        }
+        MPI_CHECK(MPI_Send(&mapped, 1, MPI_INT, peer, 1, comm));
+        MPI_CHECK(MPI_Recv(&peer_mapped, 1, MPI_INT, peer, 1, comm,
+                    MPI_STATUS_IGNORE));
+        if (mapped) {
+            shm_unlink(name);
+        }
+    } else {
+        MPI_CHECK(MPI_Send(&mapped, 1, MPI_INT, peer, 1, comm));
+    }
+
+    if (!(mapped && peer_mapped) && NULL != ipc->shared) {
+        munmap(ipc->shared, sizeof(omb_ipc_shared_t));
+        ipc->shared = NULL;
+    }
+    return (mapped && peer_mapped) ? 0 : -1;
+}
+
+/*
+ * Set up the IPC floor between this rank and peer, or MPI_PROC_NULL for ranks
+ * that take no part. Collective over comm; returns 0 only if every pair
+ * shares a node and could map the segment.
+ */
+int omb_ipc_init(omb_ipc_t *ipc, int peer, size_t max_size, MPI_Comm comm)
+{
+    char name[MPI_MAX_PROCESSOR_NAME], peer_name[MPI_MAX_PROCESSOR_NAME];
+    int rank = 0, len = 0, pid = (int)getpid();
+    int enabled = 1, cma = 1, peer_cma = 0;
+    MPI_Aint buf = 0;
+
+    memset(ipc, 0, sizeof(*ipc));
+    MPI_CHECK(MPI_Comm_rank(comm, &rank));
+
+    if (MPI_PROC_NULL != peer) {
+        ipc->leader = rank < peer;
+        memset(name, 0, sizeof(name));
+        MPI_CHECK(MPI_Get_processor_name(name, &len));
+        MPI_CHECK(MPI_Sendrecv(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, peer,
+                    1, peer_name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, peer, 1,
+                    comm, MPI_STATUS_IGNORE));
+        MPI_CHECK(MPI_Sendrecv(&pid, 1, MPI_INT, peer, 1, &ipc->peer_pid, 1,
+                    MPI_INT, peer, 1, comm, MPI_STATUS_IGNORE));
+
+        if (0 != posix_memalign((void **)&ipc->s_buf, MESSAGE_ALIGNMENT,
+                    max_size + 1) ||
+            0 != posix_memalign((void **)&ipc->r_buf, MESSAGE_ALIGNMENT,
+                    max_size + 1)) {
+            fprintf(stderr, "Could not allocate IPC floor buffers [rank %d]\n",
+                    rank);
+            MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+        }
+        memset(ipc->s_buf, 'a', max_size + 1);
+        memset(ipc->r_buf, 'b', max_size + 1);
+        buf = (MPI_Aint)ipc->s_buf;
+        MPI_CHECK(MPI_Sendrecv(&buf, 1, MPI_AINT, peer, 1, &ipc->peer_buf, 1,
+                    MPI_AINT, peer, 1, comm, MPI_STATUS_IGNORE));
+
+        enabled = (0 == strcmp(name, peer_name)) &&
+            (0 == omb_ipc_map(ipc, peer, comm));
+
+        /* CMA is subject to ptrace permissions, so try it once up front */
+        cma = enabled && (0 == omb_ipc_cma_read(ipc, 1));
+        MPI_CHECK(MPI_Sendrecv(&cma, 1, MPI_INT, peer, 1, &peer_cma, 1,
+                    MPI_INT, peer, 1, comm, MPI_STATUS_IGNORE));
+        cma = cma && peer_cma;
+    }
+
+    MPI_CHECK(MPI_Allreduce(&enabled, &ipc->enabled, 1, MPI_INT, MPI_MIN,
+                comm));
+    MPI_CHECK(MPI_Allreduce(&cma, &ipc->cma, 1, MPI_INT, MPI_MIN, comm));
+    enabled = ipc->enabled;
+    if (MPI_PROC_NULL == peer) {
+        ipc->enabled = 0;
+    }
+
+    return enabled ? 0 : -1;
+}
+
+void omb_ipc_free(omb_ipc_t *ipc)
+{
+    if (NULL != ipc->shared) {
+        munmap(ipc->shared, sizeof(omb_ipc_shared_t));
+    }
+    free(ipc->s_buf);
+    free(ipc->r_buf);
+    memset(ipc, 0, sizeof(*ipc));
+}
+
+/* One-way ping-pong latency in us, valid on the leader */
+double omb_ipc_latency(omb_ipc_t *ipc, enum omb_ipc_path path, size_t size)
+{
+    omb_ipc_ring_t *out = &ipc->shared->ring[ipc->leader ? 0 : 1];
+    omb_ipc_ring_t *in = &ipc->shared->ring[ipc->leader ? 1 : 0];
+    double t_start = 0.0;
+    int i;
+
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        if (i == options.skip) {
+            t_start = MPI_Wtime();
+        }
+        if (OMB_IPC_SHM == path) {
+            if (ipc->leader) {
+                omb_ipc_ring_send(out, ipc->s_buf, size);
+                omb_ipc_ring_recv(in, ipc->r_buf, size);
+            } else {
+                omb_ipc_ring_recv(in, ipc->r_buf, size);
+                omb_ipc_ring_send(out, ipc->s_buf, size);
+            }
+        } else {
+            ipc->seq++;
+            if (ipc->leader) {
+                omb_ipc_post(ipc, ipc->seq);
+                omb_ipc_wait(ipc, ipc->seq);
+                omb_ipc_pull(ipc, size);
+            } else {
+                omb_ipc_wait(ipc, ipc->seq);
+                omb_ipc_pull(ipc, size);
+                omb_ipc_post(ipc, ipc->seq);
+            }
+        }
+    }
+
+    if (!ipc->leader) {
+        return 0.0;
+    }
+    return (MPI_Wtime() - t_start) * 1e6 / (2.0 * options.iterations);
+}
+
+/*
+ * Streaming bandwidth in MB/s from leader to follower, valid on the leader.
+ * Each iteration moves window_size messages and waits for one acknowledgement.
+ */
+double omb_ipc_bandwidth(omb_ipc_t *ipc, enum omb_ipc_path path, size_t size,
+                         int window_size)
+{
+    omb_ipc_ring_t *out = &ipc->shared->ring[ipc->leader ? 0 : 1];
+    omb_ipc_ring_t *in = &ipc->shared->ring[ipc->leader ? 1 : 0];
+    double t_start = 0.0;
+    int i, j;
+
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        if (i == options.skip) {
+            t_start = MPI_Wtime();
+        }
+        if (OMB_IPC_SHM == path) {
+            if (ipc->leader) {
+                for (j = 0; j < window_size; j++) {
+                    omb_ipc_ring_send(out, ipc->s_buf, size);
+                }
+                omb_ipc_ring_recv(in, ipc->r_buf, 0);
+            } else {
+                for (j = 0; j < window_size; j++) {
+                    omb_ipc_ring_recv(in, ipc->r_buf, size);
+                }
+                omb_ipc_ring_send(out, ipc->s_buf, 0);
+            }
+        } else {
+            ipc->seq++;
+            if (ipc->leader) {
+                omb_ipc_post(ipc, ipc->seq);
+                omb_ipc_wait(ipc, ipc->seq);
+            } else {
+                omb_ipc_wait(ipc, ipc->seq);
+                for (j = 0; j < window_size; j++) {
+                    omb_ipc_pull(ipc, size);
+                }
+                omb_ipc_post(ipc, ipc->seq);
+            }
+        }
+    }
+
+    if (!ipc->leader) {
+        return 0.0;
+    }
+    return size / 1e6 * window_size * options.iterations /
+        (MPI_Wtime() - t_start);
+}
+/* vi:set sw=4 sts=4 tw=80: */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+
+/*
+ * IPC floor: the same ping-pong and streaming patterns as the MPI benchmarks,
+ * run between two processes on one node without MPI in the data path. The
+ * SHM path copies through a single-producer/single-consumer ring in a shared
+ * segment (copy in, copy out); the CMA path is a single process_vm_readv()
+ * copy signalled through the same segment.
+ */
+#define OMB_IPC_CACHE_LINE 64
+#define OMB_IPC_RING_SLOTS 64
+#define OMB_IPC_SLOT_SIZE (16 * 1024)
+#define OMB_IPC_SPIN_LIMIT 1000
+
+enum omb_ipc_path {
+    OMB_IPC_SHM,
+    OMB_IPC_CMA
+};
+
+typedef struct omb_ipc_ring {
+    uint64_t head;
+    char pad_head[OMB_IPC_CACHE_LINE - sizeof(uint64_t)];
+    uint64_t tail;
+    char pad_tail[OMB_IPC_CACHE_LINE - sizeof(uint64_t)];
+    char slots[OMB_IPC_RING_SLOTS][OMB_IPC_SLOT_SIZE];
+} omb_ipc_ring_t;
+
+typedef struct omb_ipc_flag {
+    uint64_t value;
+    char pad[OMB_IPC_CACHE_LINE - sizeof(uint64_t)];
+} omb_ipc_flag_t;
+
+/* ring[0] and flag[0] are written by the leader, [1] by the follower */
+typedef struct omb_ipc_shared {
+    omb_ipc_ring_t ring[2];
+    omb_ipc_flag_t flag[2];
+} omb_ipc_shared_t;
+
+typedef struct omb_ipc {
+    int enabled;
+    int cma;
+    int leader;
+    int peer_pid;
+    uint64_t seq;
+    MPI_Aint peer_buf;
+    char *s_buf;
+    char *r_buf;
+    omb_ipc_shared_t *shared;
+} omb_ipc_t;
+
+int omb_ipc_init(omb_ipc_t *ipc, int peer, size_t max_size, MPI_Comm comm);
+void omb_ipc_free(omb_ipc_t *ipc);
+double omb_ipc_latency(omb_ipc_t *ipc, enum omb_ipc_path path, size_t size);
+double omb_ipc_bandwidth(omb_ipc_t *ipc, enum omb_ipc_path path, size_t size,
+                         int window_size);
@@ -28,6 +28,146 @@ MPI_Aint disp_local;
 #define DIM 25
 static float **a, *x, *y;
 
+/* Description of the neighborhood collective graph, printed in the preamble */
+static char omb_topology_desc[OMB_TOPOLOGY_FILE_PATH_MAX_LENGTH + 64];
+
+/* Averages over ranks from omb_persistent_init(), printed in print_stats() */
+static struct {
+    double init;
+    double blocking;
+    double nonblocking;
+} omb_persistent_stats;
+
+/* Max and total over ranks from omb_inplace_footprint(), for the preamble */
+static unsigned long long omb_inplace_saved[2];
+
+/* Description of the -K communicator shape, printed in the preamble */
+static char omb_comm_shape_desc[128];
+
+/* Average over ranks from omb_ref_time(), printed in print_stats() */
+static double omb_ref_latency;
+
+/*
+ * -y weights, one per block and averaging 1, and this rank's send and
+ * receive counts and displacements from the last omb_vcounts_fill();
+ * imbalance is the busiest rank's bytes over the average, for print_stats().
+ */
+static struct {
+    int rank;
+    int numprocs;
+    int matrix;
+    double *weights;
+    int *counts[2];
+    int *displs[2];
+    double imbalance;
+} omb_vcounts;
+
+/*
+ * -U hosts, MPI_MAX_PROCESSOR_NAME bytes per rank, node index per rank and
+ * first rank per node, gathered on rank 0 by the first omb_per_rank_stats();
+ * dumped is set once the CSV file has been truncated and given its header.
+ */
+static struct {
+    int init;
+    int nnodes;
+    char *hosts;
+    int *nodes;
+    int *first;
+    int dumped;
+} omb_per_rank;
+
+/* Time per call in us and calls per second from omb_throughput_time() */
+static double omb_throughput_stats[2];
+
+/*
+ * -J state for the current call and sums over the timed calls of the
+ * realized skew, the completion time and the wait inside the collective;
+ * omb_skew_stats() turns the sums into the printed columns.
+ */
+static struct {
+    unsigned long epoch;
+    double release;
+    double delay;
+    double spread;
+    double latest;
+    double sums[3];
+    double stats[3];
+    int count;
+} omb_skew;
+
+static void omb_skew_print_pattern(void)
+{
+    switch (options.skew) {
+        case OMB_SKEW_LATE:
+            fprintf(stdout, "# Arrival skew: last rank late by %.2f us\n",
+                    options.skew_us);
+            break;
+        case OMB_SKEW_RAMP:
+            fprintf(stdout, "# Arrival skew: linear ramp from 0 to %.2f us\n",
+                    options.skew_us);
+            break;
+        case OMB_SKEW_UNIFORM:
+            fprintf(stdout, "# Arrival skew: uniform in [0, %.2f] us\n",
+                    options.skew_us);
+            break;
+        case OMB_SKEW_EXP:
+            fprintf(stdout, "# Arrival skew: exponential, mean %.2f us\n",
+                    options.skew_us);
+            break;
+        case OMB_SKEW_NORMAL:
+            fprintf(stdout, "# Arrival skew: normal, mean %.2f us, sd %.2f "
+                    "us, clamped at 0\n", options.skew_us, options.skew_sd);
+            break;
+        default:
+            break;
+    }
+}
+
+static void omb_vcounts_print_pattern(void)
+{
+    switch (options.vcounts) {
+        case OMB_VCOUNTS_UNIFORM:
+            fprintf(stdout, "# Counts: uniform\n");
+            break;
+        case OMB_VCOUNTS_ZIPF:
+            fprintf(stdout, "# Counts: zipf, exponent %.2f\n",
+                    options.vcounts_param);
+            break;
+        case OMB_VCOUNTS_SPARSE:
+            fprintf(stdout, "# Counts: sparse, %.2f of the blocks empty\n",
+                    options.vcounts_param);
+            break;
+        case OMB_VCOUNTS_HEAVY:
+            fprintf(stdout, "# Counts: last rank %.2f times heavier\n",
+                    options.vcounts_param);
+            break;
+        case OMB_VCOUNTS_FILE:
+            fprintf(stdout, "# Counts: weights from %s\n",
+                    options.vcounts_file);
+            break;
+        default:
+            break;
+    }
+}
+
+static void omb_skew_print_header(void)
+{
+    if (options.skew) {
+        fprintf(stdout, "%*s%*s%*s", FIELD_WIDTH, "Skew(us)", FIELD_WIDTH,
+                "Completion(us)", FIELD_WIDTH, "Wait(us)");
+    }
+}
+
+static void omb_skew_print_stats(void)
+{
+    if (options.skew) {
+        fprintf(stdout, "%*.*f%*.*f%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_skew.stats[0], FIELD_WIDTH, FLOAT_PRECISION,
+                omb_skew.stats[1], FIELD_WIDTH, FLOAT_PRECISION,
+                omb_skew.stats[2]);
+    }
+}
+
 /* Validation multiplier constants*/
 #define FLOAT_VALIDATION_MULTIPLIER 2.0
 #define CHAR_VALIDATION_MULTIPLIER 7
@@ -136,6 +276,16 @@ void *align_buffer (void * ptr, unsigned long align_size)
 }
 
 
+static void print_help_soak (void)
+{
+    fprintf(stdout, "  -Z, --soak DURATION[:INTERVAL[:THRESHOLD]]\n");
+    fprintf(stdout, "                              run the largest message size for DURATION seconds, printing\n");
+    fprintf(stdout, "                              statistics every INTERVAL seconds and flagging intervals more\n");
+    fprintf(stdout, "                              than THRESHOLD percent worse than the rolling baseline or the\n");
+    fprintf(stdout, "                              first interval (default INTERVAL %.0f, THRESHOLD %.0f)\n",
+            OMB_SOAK_INTERVAL_DEFAULT, OMB_SOAK_THRESHOLD_DEFAULT);
+}
+
 void usage_one_sided (char const * name)
 {
     if (accel_enabled) {
@@ -194,7 +344,8 @@ void usage_one_sided (char const * name)
     fprintf(stdout, "  -x, --warmup ITER           number of warmup iterations to skip before timing"
                    "(default 100)\n");
 
-    if (options.subtype == BW) {
+    if (options.subtype == BW || options.subtype == CONGESTION ||
+            options.subtype == BW_OVERLAP) {
         fprintf(stdout, "  -W, --window-size SIZE      set number of messages to send before synchronization (default 64)\n");
     }
 
@@ -205,10 +356,15 @@ void usage_one_sided (char const * name)
     fprintf(stdout, "                                 [EVENTS]       //Comma seperated list of PAPI events\n");
     fprintf(stdout, "                                 [PATH]         //PAPI output file path\n");
 #endif
+    fprintf(stdout, "  -Q, --pvars NAMES|list      sample these comma separated MPI_T pvars around each\n");
+    fprintf(stdout, "                              size's timed region, or list the available ones\n");
     fprintf(stdout, "  -i, --iterations ITER       number of iterations for timing (default 10000)\n");
     if (options.show_validation) {
         fprintf(stdout, "  -c, --validation            Enable or disable validation. Disabled by default. \n");
     }
+    if (options.show_soak) {
+        print_help_soak();
+    }
     fprintf(stdout, "  -h, --help                  print this help message\n");
     fflush(stdout);
 }
@@ -303,7 +459,12 @@ void usage_mbw_mr()
     fprintf(stdout, "                                 [EVENTS]       //Comma seperated list of PAPI events\n");
     fprintf(stdout, "                                 [PATH]         //PAPI output file path\n");
 #endif
+    fprintf(stdout, "  -Q, --pvars NAMES|list         sample these comma separated MPI_T pvars around each\n");
+    fprintf(stdout, "                                 size's timed region, or list the available ones\n");
     fprintf(stdout, "  -c, --validation               Enable or disable validation. Disabled by default. \n");
+    fprintf(stdout, "  -F, --ipc-floor                when every pair shares a node, also report the aggregate\n");
+    fprintf(stdout, "                                 bandwidth over a shared-memory ring (SHM) and\n");
+    fprintf(stdout, "                                 process_vm_readv (CMA)\n");
     fprintf(stdout, "  -h, --help                     Print this help\n");
     fprintf(stdout, "\n");
     fprintf(stdout, "  Note: This benchmark relies on block ordering of the ranks.  Please see\n");
@@ -349,7 +510,10 @@ void print_help_message (int rank)
     }
 
     if (((options.bench == PT2PT) || (options.bench == MBW_MR)) &&
-        (LAT_MT != options.subtype) && (LAT_MP != options.subtype)) {
+        (LAT_MT != options.subtype) && (LAT_MP != options.subtype) &&
+        (LAT_PROBE != options.subtype) && (LAT_SWITCH != options.subtype) &&
+        (LAT_LOAD != options.subtype) && (CONGESTION != options.subtype) &&
+        (LAT_OVERLAP != options.subtype) && (BW_OVERLAP != options.subtype)) {
         fprintf(stdout, "  -b, --buffer-num            Use different buffers to perform data transfer (default single)\n");
         fprintf(stdout, "                              Options: single, multiple\n");
     }
@@ -373,11 +537,14 @@ void print_help_message (int rank)
     fprintf(stdout, "                              messages, 100 for large messages)\n");
     fprintf(stdout, "  -x, --warmup ITER           set number of warmup iterations to skip before timing (default 200)\n");
 
-    if (options.subtype == BW) {
+    if (options.subtype == BW || options.subtype == CONGESTION) {
         fprintf(stdout, "  -W, --window-size SIZE      set number of messages to send before synchronization (default 64)\n");
     }
 
-    if ((options.bench == PT2PT)) {
+    if ((options.bench == PT2PT) && (LAT_SWITCH != options.subtype) &&
+            (LAT_LOAD != options.subtype) && (CONGESTION != options.subtype) &&
+            (LAT_OVERLAP != options.subtype) &&
+            (BW_OVERLAP != options.subtype)) {
         fprintf(stdout, "  -c, --validation            Enable or disable"
                 " validation. Disabled by default. \n");
         fprintf(stdout, "  -u, --validation-warmup ITR Set number of warmup"
@@ -388,7 +555,9 @@ void print_help_message (int rank)
     if (options.bench == COLLECTIVE) {
         fprintf(stdout, "  -f, --full                  print full format listing (MIN/MAX latency and ITERATIONS\n");
         fprintf(stdout, "                              displayed in addition to AVERAGE latency)\n");
-        if (options.subtype != NBC) {
+        if (options.subtype != NBC && options.subtype != HALO &&
+                options.subtype != NEIGHBOR &&
+                options.subtype != NBC_NEIGHBOR) {
             fprintf(stdout, "  -c, --validation            Enable or disable"
                     " validation. Disabled by default. \n");
             fprintf(stdout, "  -u, --validation-warmup ITR Set number of warmup"
@@ -401,7 +570,8 @@ void print_help_message (int rank)
                 options.subtype == NBC_BCAST ||
                 options.subtype == NBC_GATHER ||
                 options.subtype == NBC_REDUCE ||
-                options.subtype == NBC_SCATTER) {
+                options.subtype == NBC_SCATTER ||
+                options.subtype == NBC_NEIGHBOR) {
             fprintf(stdout, "  -t, --num_test_calls CALLS  set the number of MPI_Test() calls during the dummy computation, \n");
             fprintf(stdout, "                              set CALLS to 100, 1000, or any number > 0.\n");
         }
@@ -434,23 +604,209 @@ void print_help_message (int rank)
         fprintf(stdout, "                              -t 4:6      // sender processes = 4 and receiver processes = 6\n");
         fprintf(stdout, "                              -t 2:       // not defined\n");
     }
+
+    if (LAT_OVERLAP == options.subtype || BW_OVERLAP == options.subtype) {
+        fprintf(stdout, "  -f, --full                  print full format listing (post, MPI_Test and MPI_Wait times\n");
+        fprintf(stdout, "                              and MIN/MAX communication time across the ranks)\n");
+        fprintf(stdout, "  -t, --num_test_calls CALLS  set the number of MPI_Test() calls during the dummy computation, \n");
+        fprintf(stdout, "                              set CALLS to 100, 1000, or any number > 0.\n");
+    }
+
+    if (LAT_PROBE == options.subtype) {
+        fprintf(stdout, "  -A, --any-source            receive with MPI_ANY_SOURCE instead of the peer rank\n");
+    }
+    if (options.show_pairing) {
+        fprintf(stdout, "  -S, --pairing STRATEGY      how ranks are paired: block (rank i with i + N/2), intranode,\n");
+        fprintf(stdout, "                              internode (neighboring hosts), nearest (neighbors in host order),\n");
+        fprintf(stdout, "                              farthest (hosts farthest apart by hostname hash) or random\n");
+        fprintf(stdout, "                              (default block)\n");
+    }
+    if (options.show_soak) {
+        print_help_soak();
+    }
+    if (options.show_ipc_floor) {
+        fprintf(stdout, "  -F, --ipc-floor             when both ranks share a node, also report the same pattern\n");
+        fprintf(stdout, "                              over a shared-memory ring (SHM) and process_vm_readv (CMA)\n");
+    }
+    if (options.show_touch_data) {
+        fprintf(stdout, "  -X, --touch-data            the sender writes the send buffer and the receiver sums the\n");
+        fprintf(stdout, "                              receive buffer every iteration; the main column stays\n");
+        fprintf(stdout, "                              communication-only and an end-to-end column is added\n");
+        fprintf(stdout, "                              (host buffers only)\n");
+    }
+    if (options.show_algo_sweep) {
+        fprintf(stdout, "  -C, --algo-sweep[=FILE]     rerun every size with each algorithm the MPI library\n");
+        fprintf(stdout, "                              exposes through MPI_T and print the best per size;\n");
+        fprintf(stdout, "                              with FILE, also write an Open MPI coll_tuned rules\n");
+        fprintf(stdout, "                              file (short form: -CFILE)\n");
+    }
+    if (options.show_persistent) {
+        fprintf(stdout, "  -N, --persistent            time MPI_Start/MPI_Wait on a persistent collective (MPI-4)\n");
+        fprintf(stdout, "                              and also report its init cost and the blocking and\n");
+        fprintf(stdout, "                              nonblocking latencies of the same call\n");
+    }
+    if (options.show_reduce_types) {
+        fprintf(stdout, "  -B, --datatype TYPES        comma separated reduction datatypes: float, double, int,\n");
+        fprintf(stdout, "                              int64, complex, float_int, bfloat16 or all (default float)\n");
+        fprintf(stdout, "  -O, --op OPS                comma separated reduction ops: sum, max, min, maxloc,\n");
+        fprintf(stdout, "                              minloc or all (default sum); maxloc and minloc use\n");
+        fprintf(stdout, "                              float_int, bfloat16 uses user-defined ops. Several\n");
+        fprintf(stdout, "                              datatypes or ops print a latency matrix of every valid\n");
+        fprintf(stdout, "                              combination per size (blocking benchmarks only)\n");
+    }
+    if (options.show_in_place) {
+        fprintf(stdout, "  -I, --in-place              pass MPI_IN_PLACE instead of a separate send (or, for\n");
+        fprintf(stdout, "                              scatter, receive) buffer and report the memory saved\n");
+    }
+    if (options.show_comm_shape) {
+        fprintf(stdout, "  -K, --comm-shape SHAPE      run the collective on world (default), node (one\n");
+        fprintf(stdout, "                              communicator per node), leaders (one rank per node),\n");
+        fprintf(stdout, "                              row or col (of a 2D grid from MPI_Dims_create) or\n");
+        fprintf(stdout, "                              groups:K (K disjoint blocks of ranks); all groups run\n");
+        fprintf(stdout, "                              concurrently and each group's latency is printed\n");
+        fprintf(stdout, "                              before the aggregate over all participating ranks\n");
+    }
+    if (options.show_skew) {
+        fprintf(stdout, "  -J, --skew SPEC             delay each rank before the timed collective instead of\n");
+        fprintf(stdout, "                              releasing all ranks together: late:US (last rank),\n");
+        fprintf(stdout, "                              ramp:US (0 to US over the ranks), uniform:US, exp:US\n");
+        fprintf(stdout, "                              (mean) or normal:US:SD. Adds the realized skew, the time\n");
+        fprintf(stdout, "                              from the release to the last rank's exit and the time\n");
+        fprintf(stdout, "                              ranks wait inside the collective for late arrivals\n");
+    }
+    if (options.show_throughput) {
+        fprintf(stdout, "  -q, --throughput TYPE       also run the iterations back to back without barriers\n");
+        fprintf(stdout, "                              and print the time per call and calls per second:\n");
+        fprintf(stdout, "                              indep         every call on the same input\n");
+        if (options.show_throughput & OMB_THROUGHPUT_CHAIN) {
+            fprintf(stdout, "                              chain         every call on the previous call's output\n");
+        }
+    }
+    if (options.show_per_rank) {
+        fprintf(stdout, "  -U, --per-rank K[:FILE]     gather every rank's latency and print the K slowest\n");
+        fprintf(stdout, "                              ranks with their hosts and the K slowest nodes for each\n");
+        fprintf(stdout, "                              size; FILE gets every rank as CSV\n");
+    }
+    if (options.show_vcounts) {
+        fprintf(stdout, "  -y, --counts DIST           irregular block sizes averaging the message size instead\n");
+        fprintf(stdout, "                              of equal ones: uniform (0 to twice the size), zipf:S\n");
+        fprintf(stdout, "                              (power law with exponent S), sparse:F (fraction F of the\n");
+        fprintf(stdout, "                              blocks empty), heavy:F (the last rank's blocks F times\n");
+        fprintf(stdout, "                              larger) or file:PATH (relative weights, one row per\n");
+        fprintf(stdout, "                              sender). Adds the busiest rank's bytes over the average\n");
+    }
+    if (options.show_in_flight) {
+        fprintf(stdout, "  -z, --in-flight K[:COMMS[:COMPLETION]]\n");
+        fprintf(stdout, "                              instead of one call at a time, post K calls of each size\n");
+        fprintf(stdout, "                              (at most %d) or one batch of a comma separated list of\n", OMB_INFLIGHT_MAX_OPS);
+        fprintf(stdout, "                              sizes, round-robin over COMMS duplicated communicators\n");
+        fprintf(stdout, "                              (default 1, the benchmark's own), and complete them with\n");
+        fprintf(stdout, "                              waitall (default) or testany, which also reports each\n");
+        fprintf(stdout, "                              call's completion order and latency\n");
+    }
+    if (options.show_ref_algo) {
+        fprintf(stdout, "  -E, --ref-algo ALGO         also time a reference algorithm for the collective and\n");
+        fprintf(stdout, "                              print it as an extra column (host buffers, checked\n");
+        fprintf(stdout, "                              with -c):\n");
+        if (options.show_ref_algo & OMB_REF_HIER) {
+            fprintf(stdout, "                              hier          node shared memory, library among node leaders\n");
+        }
+        if (options.show_ref_algo & OMB_REF_RING) {
+            fprintf(stdout, "                              ring          neighbor exchanges around a ring\n");
+        }
+        if (options.show_ref_algo & OMB_REF_RD) {
+            fprintf(stdout, "                              rd            recursive doubling\n");
+        }
+        if (options.show_ref_algo & OMB_REF_RABENSEIFNER) {
+            fprintf(stdout, "                              rabenseifner  recursive halving, then recursive doubling\n");
+        }
+        if (options.show_ref_algo & OMB_REF_BINOMIAL) {
+            fprintf(stdout, "                              binomial      binomial tree\n");
+        }
+        if (options.show_ref_algo & OMB_REF_CHAIN) {
+            fprintf(stdout, "                              chain         pipelined chain of 8 KB segments\n");
+        }
+        if (options.show_ref_algo & OMB_REF_BRUCK) {
+            fprintf(stdout, "                              bruck         log(p) rounds of packed blocks\n");
+        }
+        if (options.show_ref_algo & OMB_REF_PAIRWISE) {
+            fprintf(stdout, "                              pairwise      p - 1 rounds of pairwise exchanges\n");
+        }
+    }
+    if (LAT_LOAD == options.subtype) {
+        fprintf(stdout, "  -p, --num-pairs PAIRS       number of pairs running the latency probe, the remaining\n");
+        fprintf(stdout, "                              pairs generate background traffic (default 1)\n");
+        fprintf(stdout, "  -L, --load SIZE[:WINDOW[:DUTY]]\n");
+        fprintf(stdout, "                              background traffic sends WINDOW messages of SIZE bytes per\n");
+        fprintf(stdout, "                              burst and is active DUTY percent of the time; WINDOW is\n");
+        fprintf(stdout, "                              at most %d (default %d:%d:%d)\n", MAX_REQ_NUM,
+                OMB_LOAD_SIZE_DEFAULT, OMB_LOAD_WINDOW_DEFAULT, OMB_LOAD_DUTY_DEFAULT);
+    }
+    if (HALO == options.subtype) {
+        fprintf(stdout, "  -g, --grid DIMS[:PERIODIC]  process grid, either the number of dimensions (2 or 3) or\n");
+        fprintf(stdout, "                              an explicit decomposition such as 4x2 or 2x0x2 where 0 is\n");
+        fprintf(stdout, "                              chosen by MPI_Dims_create; PERIODIC is 0 or 1 (default 3:1)\n");
+        fprintf(stdout, "  -k, --halo TYPE             exchange faces, faces and edges, or all neighbors including\n");
+        fprintf(stdout, "                              corners; TYPE is faces, edges or corners (default faces)\n");
+        fprintf(stdout, "  -e, --exchange METHODS      comma separated exchange methods: isend, persistent,\n");
+        fprintf(stdout, "                              neighbor (MPI_Neighbor_alltoallw) or all (default all)\n");
+        fprintf(stdout, "                              -m selects the face size in bytes\n");
+    }
+    if (NEIGHBOR == options.subtype || NBC_NEIGHBOR == options.subtype) {
+        fprintf(stdout, "  -o, --topology TOPOLOGY     graph passed to MPI_Dist_graph_create_adjacent: ring,\n");
+        fprintf(stdout, "                              kreg[:K] (random K-regular graph), stencil2d, stencil3d\n");
+        fprintf(stdout, "                              (periodic 5/7-point stencils) or file:PATH, an edge list\n");
+        fprintf(stdout, "                              with one \"SRC DST\" rank pair per line (default ring, K = %d)\n",
+                OMB_TOPOLOGY_DEGREE_DEFAULT);
+    }
+    if (CONGESTION == options.subtype) {
+        fprintf(stdout, "  -T, --pattern PATTERNS      comma separated traffic patterns run on all ranks at once:\n");
+        fprintf(stdout, "                              random, shift[:K], bitcomp, tornado, allpairs or all\n");
+        fprintf(stdout, "                              (default all, K = 1)\n");
+        fprintf(stdout, "  -n, --num-trials TRIALS     number of trials per pattern and message size, the random\n");
+        fprintf(stdout, "                              permutation is re-seeded every trial (default %d)\n",
+                OMB_NUM_TRIALS_DEFAULT);
+    }
+    if (LAT_SWITCH == options.subtype) {
+        fprintf(stdout, "  -j, --jump-threshold PCT    report a protocol switch when latency exceeds the linear\n");
+        fprintf(stdout, "                              extrapolation of the smaller sizes by PCT percent (default %.0f)\n",
+                OMB_JUMP_THRESHOLD_DEFAULT);
+    }
     if (options.subtype == GATHER || options.subtype == SCATTER ||
             options.subtype == ALLTOALL || options.subtype == NBC_GATHER ||
             options.subtype == NBC_SCATTER || options.subtype == NBC_ALLTOALL ||
             options.subtype == NBC_BCAST || options.subtype == BCAST ||
-            options.bench == PT2PT) {
+            (options.bench == PT2PT && options.subtype != LAT_PROBE &&
+             options.subtype != LAT_SWITCH && options.subtype != LAT_LOAD &&
+             options.subtype != CONGESTION && options.subtype != LAT_OVERLAP &&
+             options.subtype != BW_OVERLAP)) {
         fprintf(stdout, "  -D, --ddt [TYPE]:[ARGS]     Enable DDT support\n");
         fprintf(stdout, "                              -D cont                          //Contiguous\n");
         fprintf(stdout, "                              -D vect:[stride]:[block_length]  //Vector\n");
         fprintf(stdout, "                              -D indx:[ddt file path]          //Index\n");
     }
-    fprintf(stdout, "  -G, --graph tty,png,pdf    graph output of per"
-                        " iteration values.\n");
+    if (LAT_PROBE != options.subtype && LAT_SWITCH != options.subtype &&
+            LAT_LOAD != options.subtype && CONGESTION != options.subtype &&
+            HALO != options.subtype && LAT_OVERLAP != options.subtype &&
+            BW_OVERLAP != options.subtype) {
+        fprintf(stdout, "  -G, --graph tty,png,pdf    graph output of per"
+                " iteration values.\n");
+    }
 #ifdef _ENABLE_PAPI_
-    fprintf(stdout, "  -P, --papi [EVENTS]:[PATH]     Enable PAPI support\n");
-    fprintf(stdout, "                                 [EVENTS]       //Comma seperated list of PAPI events\n");
-    fprintf(stdout, "                                 [PATH]         //PAPI output file path\n");
+    if (LAT_SWITCH != options.subtype && LAT_LOAD != options.subtype &&
+            CONGESTION != options.subtype && HALO != options.subtype &&
+            LAT_OVERLAP != options.subtype && BW_OVERLAP != options.subtype) {
+        fprintf(stdout, "  -P, --papi [EVENTS]:[PATH]     Enable PAPI support\n");
+        fprintf(stdout, "                                 [EVENTS]       //Comma seperated list of PAPI events\n");
+        fprintf(stdout, "                                 [PATH]         //PAPI output file path\n");
+    }
 #endif
+    if (LAT_SWITCH != options.subtype && LAT_LOAD != options.subtype &&
+            CONGESTION != options.subtype && HALO != options.subtype &&
+            LAT_OVERLAP != options.subtype && BW_OVERLAP != options.subtype) {
+        fprintf(stdout, "  -Q, --pvars NAMES|list      sample these comma separated MPI_T pvars around each\n");
+        fprintf(stdout, "                              size's timed region, or list the available ones\n");
+    }
     fprintf(stdout, "  -h, --help                  print this help\n");
     fprintf(stdout, "  -v, --version               print version info\n");
     fprintf(stdout, "\n");
@@ -602,7 +958,25 @@ void print_preamble_nbc (int rank)
             break;
     }
 
-    fprintf(stdout, "# Overall = Coll. Init + Compute + MPI_Test + MPI_Wait\n\n");
+    if (NBC_NEIGHBOR == options.subtype) {
+        fprintf(stdout, "# Topology: %s\n", omb_topology_desc);
+    }
+    if (OMB_DTYPE_FLOAT != options.reduce_dtype ||
+            OMB_OP_SUM != options.reduce_op) {
+        fprintf(stdout, "# Datatype: %s, op: %s\n",
+                omb_reduce_dtype_name(options.reduce_dtype),
+                omb_reduce_op_name(options.reduce_op));
+    }
+    if (options.in_place) {
+        fprintf(stdout, "# In-place saves %llu bytes per rank (max), %llu "
+                "bytes in total\n", omb_inplace_saved[0], omb_inplace_saved[1]);
+    }
+    omb_skew_print_pattern();
+    if (PT2PT == options.bench) {
+        fprintf(stdout, "# Overall = Post + Compute + MPI_Test + MPI_Wait\n\n");
+    } else {
+        fprintf(stdout, "# Overall = Coll. Init + Compute + MPI_Test + MPI_Wait\n\n");
+    }
 
     if (options.show_size) {
         fprintf(stdout, "%-*s", 10, "# Size");
@@ -630,6 +1004,7 @@ void print_preamble_nbc (int rank)
     if (options.validate) {
         fprintf(stdout, "%*s", FIELD_WIDTH, "Validation");
     }
+    omb_skew_print_header();
     if (options.omb_enable_ddt) {
         fprintf(stdout, "%*s", FIELD_WIDTH, "Transmit Size");
     }
@@ -658,6 +1033,16 @@ void display_nbc_params()
 
 void print_preamble (int rank)
 {
+#if MPI_VERSION < 4
+    if (options.persistent) {
+        if (0 == rank) {
+            fprintf(stderr, "Persistent collectives require an MPI-4 "
+                    "library\n");
+        }
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+#endif
     if (rank) {
         return;
     }
@@ -679,6 +1064,36 @@ void print_preamble (int rank)
             break;
     }
 
+    if (NEIGHBOR == options.subtype) {
+        fprintf(stdout, "# Topology: %s\n", omb_topology_desc);
+    }
+    if (OMB_SHAPE_WORLD != options.comm_shape) {
+        fprintf(stdout, "# Communicator: %s\n", omb_comm_shape_desc);
+    }
+    if (OMB_DTYPE_FLOAT != options.reduce_dtype ||
+            OMB_OP_SUM != options.reduce_op) {
+        fprintf(stdout, "# Datatype: %s, op: %s\n",
+                omb_reduce_dtype_name(options.reduce_dtype),
+                omb_reduce_op_name(options.reduce_op));
+    }
+    if (options.in_place) {
+        fprintf(stdout, "# In-place saves %llu bytes per rank (max), %llu "
+                "bytes in total\n", omb_inplace_saved[0], omb_inplace_saved[1]);
+    }
+    omb_skew_print_pattern();
+    omb_vcounts_print_pattern();
+    if (options.throughput) {
+        fprintf(stdout, "# Throughput: %s, %lu calls back to back%s\n",
+                omb_throughput_name(options.throughput), options.iterations,
+                OMB_THROUGHPUT_CHAIN == options.throughput &&
+                REDUCE == options.subtype && OMB_OP_SUM == options.reduce_op ?
+                ", chained with max so values stay finite" : "");
+    }
+    if (options.ref_algo) {
+        fprintf(stdout, "# Reference algorithm: %s\n",
+                omb_ref_algo_name(options.ref_algo));
+    }
+
     if (options.show_size) {
         fprintf(stdout, "%-*s", 10, "# Size");
         fprintf(stdout, "%*s", FIELD_WIDTH, "Avg Latency(us)");
@@ -694,6 +1109,21 @@ void print_preamble (int rank)
 
     if (options.validate)
         fprintf(stdout, "%*s", FIELD_WIDTH, "Validation");
+    if (options.persistent) {
+        fprintf(stdout, "%*s%*s%*s", FIELD_WIDTH, "Init(us)", FIELD_WIDTH,
+                "Blocking(us)", FIELD_WIDTH, "Nonblocking(us)");
+    }
+    if (options.ref_algo) {
+        fprintf(stdout, "%*s", FIELD_WIDTH, "Reference(us)");
+    }
+    if (options.throughput) {
+        fprintf(stdout, "%*s%*s", FIELD_WIDTH, "Time/op(us)", FIELD_WIDTH,
+                "Ops/s");
+    }
+    if (options.vcounts) {
+        fprintf(stdout, "%*s", FIELD_WIDTH, "Imbalance");
+    }
+    omb_skew_print_header();
     if (options.omb_enable_ddt) {
         fprintf(stdout, "%*s", FIELD_WIDTH, "Transmit Size");
     }
@@ -711,7 +1141,9 @@ void check_mem_limit(int numprocs)
             options.subtype == SCATTER ||
             options.subtype == NBC_GATHER ||
             options.subtype == NBC_ALLTOALL ||
-            options.subtype == NBC_SCATTER) {
+            options.subtype == NBC_SCATTER ||
+            options.subtype == NEIGHBOR ||
+            options.subtype == NBC_NEIGHBOR) {
         if ((options.max_message_size * numprocs) > options.max_mem_limit) {
             options.max_message_size = options.max_mem_limit / numprocs;
             if (0 == rank) {
@@ -734,6 +1166,21 @@ void check_mem_limit(int numprocs)
             }
             options.max_message_size = options.max_mem_limit;
         }
+    } else if (options.bench == PT2PT) {
+        /* One send and one receive buffer per window slot with -b multiple */
+        size_t nbufs = 2;
+
+        if (options.subtype == BW && options.buf_num == MULTIPLE) {
+            nbufs *= options.window_size;
+        }
+        if ((options.max_message_size * nbufs) > options.max_mem_limit) {
+            options.max_message_size = options.max_mem_limit / nbufs;
+            if (0 == rank) {
+                fprintf(stderr, "Warning! Limiting max message size to: %zu. "
+                        "Increase -M, --mem-limit for higher message sizes.\n",
+                        options.max_message_size);
+            }
+        }
     }
 }
 
@@ -750,6 +1197,8 @@ double calculate_and_print_stats(int rank, int size, int numprocs, double timer,
     double avg_comm_time   = latency;
     double min_comm_time = latency, max_comm_time = latency;
 
+    omb_per_rank_stats(size, overall_time, 1);
+
     if (rank != 0) {
         MPI_CHECK(MPI_Reduce(&test_total, &test_total, 1, MPI_DOUBLE, MPI_SUM, 0,
                    MPI_COMM_WORLD));
@@ -801,6 +1250,7 @@ double calculate_and_print_stats(int rank, int size, int numprocs, double timer,
     /* Time for the NBC call */
     init_total = init_total/numprocs;
 
+    omb_skew_stats();
 
     print_stats_nbc(rank, size, overall_time, tcomp_total, avg_comm_time,
                     min_comm_time, max_comm_time, wait_total, init_total,
@@ -854,6 +1304,7 @@ void print_stats_nbc (int rank, int size, double overall_time, double cpu_time,
     if (options.validate) {
         fprintf(stdout, "%*s", FIELD_WIDTH, VALIDATION_STATUS(errors));
     }
+    omb_skew_print_stats();
     if (!options.omb_enable_ddt) {
         fprintf(stdout, "\n");
     }
@@ -861,14 +1312,14 @@ void print_stats_nbc (int rank, int size, double overall_time, double cpu_time,
     fflush(stdout);
 }
 
-void print_stats (int rank, int size, double avg_time, double min_time, double max_time)
+void print_stats (int rank, size_t size, double avg_time, double min_time, double max_time)
 {
     if (rank) {
         return;
     }
 
     if (options.show_size) {
-        fprintf(stdout, "%-*d", 10, size);
+        fprintf(stdout, "%-*zu", 10, size);
         fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION, avg_time);
     } else {
         fprintf(stdout, "%*.*f", 17, FLOAT_PRECISION, avg_time);
@@ -880,13 +1331,33 @@ void print_stats (int rank, int size, double avg_time, double min_time, double m
                 FIELD_WIDTH, FLOAT_PRECISION, max_time,
                 12, options.iterations);
     }
+    if (options.persistent) {
+        fprintf(stdout, "%*.*f%*.*f%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_persistent_stats.init, FIELD_WIDTH, FLOAT_PRECISION,
+                omb_persistent_stats.blocking, FIELD_WIDTH, FLOAT_PRECISION,
+                omb_persistent_stats.nonblocking);
+    }
+    if (options.ref_algo) {
+        fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_ref_latency);
+    }
+    if (options.throughput) {
+        fprintf(stdout, "%*.*f%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_throughput_stats[0], FIELD_WIDTH, FLOAT_PRECISION,
+                omb_throughput_stats[1]);
+    }
+    if (options.vcounts) {
+        fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_vcounts.imbalance);
+    }
+    omb_skew_print_stats();
     if (!options.omb_enable_ddt) {
         fprintf(stdout, "\n");
     }
     fflush(stdout);
 }
 
-void print_stats_validate(int rank, int size, double avg_time, double min_time,
+void print_stats_validate(int rank, size_t size, double avg_time, double min_time,
             double max_time, int errors)
 {
     if (rank) {
@@ -894,7 +1365,7 @@ void print_stats_validate(int rank, int size, double avg_time, double min_time,
     }
 
     if (options.show_size) {
-        fprintf(stdout, "%-*d", 10, size);
+        fprintf(stdout, "%-*zu", 10, size);
         fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION, avg_time);
     } else {
         fprintf(stdout, "%*.*f", 17, FLOAT_PRECISION, avg_time);
@@ -907,6 +1378,26 @@ void print_stats_validate(int rank, int size, double avg_time, double min_time,
                 12, options.iterations);
     }
     fprintf(stdout, "%*s", FIELD_WIDTH, VALIDATION_STATUS(errors));
+    if (options.persistent) {
+        fprintf(stdout, "%*.*f%*.*f%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_persistent_stats.init, FIELD_WIDTH, FLOAT_PRECISION,
+                omb_persistent_stats.blocking, FIELD_WIDTH, FLOAT_PRECISION,
+                omb_persistent_stats.nonblocking);
+    }
+    if (options.ref_algo) {
+        fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_ref_latency);
+    }
+    if (options.throughput) {
+        fprintf(stdout, "%*.*f%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_throughput_stats[0], FIELD_WIDTH, FLOAT_PRECISION,
+                omb_throughput_stats[1]);
+    }
+    if (options.vcounts) {
+        fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                omb_vcounts.imbalance);
+    }
+    omb_skew_print_stats();
     if (!options.omb_enable_ddt) {
         fprintf(stdout, "\n");
     }
@@ -1010,6 +1501,10 @@ void set_buffer_validation(void* s_buf, void* r_buf, size_t size,
     void *temp_s_buffer = NULL;
     int rank = 0;
     char buf_type = 'H';
+    if (options.vcounts) {
+        omb_vcounts_set_buffer(s_buf, r_buf, iter);
+        return;
+    }
     MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
     switch (options.bench)
     {
@@ -1120,6 +1615,12 @@ void set_buffer_validation(void* s_buf, void* r_buf, size_t size,
                             int rank, numprocs;
                             MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
                             MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+                            if (OMB_DTYPE_FLOAT != options.reduce_dtype ||
+                                    OMB_OP_SUM != options.reduce_op) {
+                                omb_reduction_set_buffer(s_buf, 1, size, iter);
+                                omb_reduction_set_buffer(r_buf, 0, size, iter);
+                                break;
+                            }
                             set_buffer_float(s_buf, 1, size, iter,
                                     options.accel);
                             set_buffer_float(r_buf, 0, size, iter,
@@ -1146,6 +1647,13 @@ void set_buffer_validation(void* s_buf, void* r_buf, size_t size,
                             int rank, numprocs;
                             MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
                             MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+                            if (OMB_DTYPE_FLOAT != options.reduce_dtype ||
+                                    OMB_OP_SUM != options.reduce_op) {
+                                omb_reduction_set_buffer(s_buf, 1, size, iter);
+                                omb_reduction_set_buffer(r_buf, 0,
+                                        size / numprocs + 1, iter);
+                                break;
+                            }
                             set_buffer_float(s_buf, 1, size, iter,
                                     options.accel);
                             set_buffer_float(r_buf, 0, size / numprocs + 1,
@@ -1262,6 +1770,9 @@ uint8_t validate_data(void* r_buf, size_t size, int num_procs,
     void *temp_r_buf = NULL;
     int rank = 0;
 
+    if (options.vcounts) {
+        return omb_vcounts_validate(r_buf, iter);
+    }
     MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
     switch (options.bench)
     {
@@ -1396,11 +1907,22 @@ uint8_t validate_data(void* r_buf, size_t size, int num_procs,
     return 1;
 }
 
-int validate_reduce_scatter(float *buffer, size_t size, int* recvcounts,
+int validate_reduce_scatter(void *buffer, size_t size, int* recvcounts,
                             int rank, int num_procs, enum accel_type type,
                             int iter)
 {
     int i = 0, j = 0, k = 0, errors = 0;
+    size_t offset = 0;
+
+    if (OMB_DTYPE_FLOAT != options.reduce_dtype ||
+            OMB_OP_SUM != options.reduce_op) {
+        for (k = 0; k < rank; k++) {
+            offset += recvcounts[k];
+        }
+        return omb_reduction_validate(buffer, recvcounts[rank], offset, iter,
+                num_procs);
+    }
+
     float *expected_buffer = malloc(size * sizeof(float));
     float *temp_buffer = malloc(size * sizeof(float));
 
@@ -1438,10 +1960,16 @@ int validate_reduce_scatter(float *buffer, size_t size, int* recvcounts,
 
 }
 
-int validate_reduction(float *buffer, size_t size, int iter, int num_procs,
+int validate_reduction(void *buffer, size_t size, int iter, int num_procs,
                        enum accel_type type)
 {
     int i = 0, j = 0, errors = 0;
+
+    if (OMB_DTYPE_FLOAT != options.reduce_dtype ||
+            OMB_OP_SUM != options.reduce_op) {
+        return omb_reduction_validate(buffer, size, 0, iter, num_procs);
+    }
+
     float *expected_buffer = malloc(size * sizeof(float));
     float *temp_buffer = malloc(size * sizeof(float));
     int num_elements = size;
@@ -2788,4 +3316,2738 @@ void allocate_device_arrays(int n)
     is_alloc = 1;
 }
 #endif
+
+/*
+ * Neighborhood collectives
+ */
+
+/*
+ * Random K-regular digraph: the ranks are shuffled onto a circle and every
+ * rank sends to the ranks K distinct random offsets ahead of it, so each
+ * rank has exactly K sources and K destinations. Rank 0 draws the graph from
+ * a fixed seed and broadcasts it, so repeated runs use the same graph.
+ */
+static int omb_topology_kreg(int rank, int numprocs, int *sources,
+                             int *destinations, int *degree)
+{
+    int *perm = NULL, *offsets = NULL;
+    int i, j, tmp, pos = 0, k = options.topology_degree;
+
+    if (k >= numprocs) {
+        if (0 == rank) {
+            fprintf(stderr, "Degree %d requires at least %d processes\n", k,
+                    k + 1);
+        }
+        return 1;
+    }
+
+    perm = malloc(numprocs * sizeof(int));
+    offsets = malloc(numprocs * sizeof(int));
+    OMB_CHECK_NULL_AND_EXIT(perm, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(offsets, "Unable to allocate memory");
+
+    if (0 == rank) {
+        srand(1);
+        for (i = 0; i < numprocs; i++) {
+            perm[i] = i;
+            offsets[i] = i + 1;
+        }
+        for (i = numprocs - 1; i > 0; i--) {
+            j = rand() % (i + 1);
+            tmp = perm[i];
+            perm[i] = perm[j];
+            perm[j] = tmp;
+        }
+        /* Partial shuffle of 1..numprocs-1, the first K are the offsets */
+        for (i = 0; i < k; i++) {
+            j = i + rand() % (numprocs - 1 - i);
+            tmp = offsets[i];
+            offsets[i] = offsets[j];
+            offsets[j] = tmp;
+        }
+    }
+    MPI_CHECK(MPI_Bcast(perm, numprocs, MPI_INT, 0, MPI_COMM_WORLD));
+    MPI_CHECK(MPI_Bcast(offsets, k, MPI_INT, 0, MPI_COMM_WORLD));
+
+    for (i = 0; i < numprocs; i++) {
+        if (perm[i] == rank) {
+            pos = i;
+        }
+    }
+    for (i = 0; i < k; i++) {
+        destinations[i] = perm[(pos + offsets[i]) % numprocs];
+        sources[i] = perm[(pos - offsets[i] + numprocs) % numprocs];
+    }
+    *degree = k;
+
+    free(perm);
+    free(offsets);
+    return 0;
+}
+
+/*
+ * Periodic 5-point (2D) or 7-point (3D) stencil over the grid chosen by
+ * MPI_Dims_create. Small grids produce repeated neighbors, which is legal
+ * for distributed graphs and matches what a stencil code would do.
+ */
+static void omb_topology_stencil(int ndims, int *sources, int *destinations,
+                                 int *degree, int *dims)
+{
+    int periods[3] = {1, 1, 1};
+    int numprocs, d, minus, plus;
+    MPI_Comm cart;
+
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    dims[0] = dims[1] = dims[2] = 0;
+    MPI_CHECK(MPI_Dims_create(numprocs, ndims, dims));
+    MPI_CHECK(MPI_Cart_create(MPI_COMM_WORLD, ndims, dims, periods, 0,
+                &cart));
+    for (d = 0; d < ndims; d++) {
+        MPI_CHECK(MPI_Cart_shift(cart, d, 1, &minus, &plus));
+        sources[2 * d] = destinations[2 * d] = minus;
+        sources[2 * d + 1] = destinations[2 * d + 1] = plus;
+    }
+    *degree = 2 * ndims;
+    MPI_CHECK(MPI_Comm_free(&cart));
+}
+
+/*
+ * Read a directed edge list, one "SRC DST" pair per line with '#' starting a
+ * comment, on rank 0 and broadcast it. Every rank keeps the edges it is an
+ * endpoint of.
+ */
+static int omb_topology_file(int rank, int numprocs, int **sources,
+                             int **destinations, int *indegree,
+                             int *outdegree)
+{
+    FILE *fp = NULL;
+    char line[OMB_DDT_FILE_LINE_MAX_LENGTH];
+    int *edges = NULL, num_edges = 0, max_edges = 0, src, dst, i;
+
+    if (0 == rank) {
+        fp = fopen(options.topology_file, "r");
+        if (NULL == fp) {
+            fprintf(stderr, "Unable to open topology file %s\n",
+                    options.topology_file);
+            num_edges = -1;
+        }
+        while (NULL != fp && fgets(line, OMB_DDT_FILE_LINE_MAX_LENGTH, fp)) {
+            if ('#' == line[0] || 2 != sscanf(line, "%d %d", &src, &dst)) {
+                continue;
+            }
+            if (0 > src || src >= numprocs || 0 > dst || dst >= numprocs) {
+                fprintf(stderr, "Edge %d -> %d in %s is out of range for %d"
+                        " processes\n", src, dst, options.topology_file,
+                        numprocs);
+                num_edges = -1;
+                break;
+            }
+            if (num_edges == max_edges) {
+                max_edges = max_edges ? 2 * max_edges : 1024;
+                edges = realloc(edges, 2 * max_edges * sizeof(int));
+                OMB_CHECK_NULL_AND_EXIT(edges, "Unable to allocate memory");
+            }
+            edges[2 * num_edges] = src;
+            edges[2 * num_edges + 1] = dst;
+            num_edges++;
+        }
+        if (NULL != fp) {
+            fclose(fp);
+        }
+    }
+    MPI_CHECK(MPI_Bcast(&num_edges, 1, MPI_INT, 0, MPI_COMM_WORLD));
+    if (0 > num_edges) {
+        free(edges);
+        return 1;
+    }
+    if (0 != rank) {
+        edges = malloc((2 * num_edges + 1) * sizeof(int));
+        OMB_CHECK_NULL_AND_EXIT(edges, "Unable to allocate memory");
+    }
+    MPI_CHECK(MPI_Bcast(edges, 2 * num_edges, MPI_INT, 0, MPI_COMM_WORLD));
+
+    *indegree = *outdegree = 0;
+    for (i = 0; i < num_edges; i++) {
+        *outdegree += (rank == edges[2 * i]);
+        *indegree += (rank == edges[2 * i + 1]);
+    }
+    *sources = malloc((*indegree + 1) * sizeof(int));
+    *destinations = malloc((*outdegree + 1) * sizeof(int));
+    OMB_CHECK_NULL_AND_EXIT(*sources, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(*destinations, "Unable to allocate memory");
+
+    *indegree = *outdegree = 0;
+    for (i = 0; i < num_edges; i++) {
+        if (rank == edges[2 * i]) {
+            (*destinations)[(*outdegree)++] = edges[2 * i + 1];
+        }
+        if (rank == edges[2 * i + 1]) {
+            (*sources)[(*indegree)++] = edges[2 * i];
+        }
+    }
+
+    free(edges);
+    return 0;
+}
+
+/*
+ * Unweighted, unreordered MPI_Dist_graph_create_adjacent(). GCC 11 and later
+ * warn that the call reads from MPI_UNWEIGHTED, which some MPIs define as a
+ * small sentinel pointer that is never dereferenced, so the check is off here.
+ */
+void omb_dist_graph_create(MPI_Comm comm_old, int indegree, int *sources,
+                           int outdegree, int *destinations, MPI_Comm *comm)
+{
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#endif
+    MPI_CHECK(MPI_Dist_graph_create_adjacent(comm_old, indegree, sources,
+                MPI_UNWEIGHTED, outdegree, destinations, MPI_UNWEIGHTED,
+                MPI_INFO_NULL, 0, comm));
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+}
+
+/*
+ * Build the distributed graph communicator selected by -o. On success the
+ * local in/out degrees and the largest degree of any rank are returned; on
+ * failure rank 0 has printed the reason and 1 is returned on every rank.
+ */
+int omb_neighbor_create_comm(MPI_Comm *comm, int *indegree, int *outdegree,
+                             int *max_degree)
+{
+    int rank, numprocs, degree = 0;
+    int dims[3] = {0, 0, 0};
+    int local[2], global[2];
+    int *sources = NULL, *destinations = NULL;
+
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+
+    if (OMB_TOPOLOGY_FILE == options.topology) {
+        if (omb_topology_file(rank, numprocs, &sources, &destinations,
+                    indegree, outdegree)) {
+            return 1;
+        }
+    } else {
+        sources = malloc((numprocs + 6) * sizeof(int));
+        destinations = malloc((numprocs + 6) * sizeof(int));
+        OMB_CHECK_NULL_AND_EXIT(sources, "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(destinations, "Unable to allocate memory");
+
+        switch (options.topology) {
+            case OMB_TOPOLOGY_KREG:
+                if (omb_topology_kreg(rank, numprocs, sources, destinations,
+                            &degree)) {
+                    free(sources);
+                    free(destinations);
+                    return 1;
+                }
+                break;
+            case OMB_TOPOLOGY_STENCIL2D:
+                omb_topology_stencil(2, sources, destinations, &degree, dims);
+                break;
+            case OMB_TOPOLOGY_STENCIL3D:
+                omb_topology_stencil(3, sources, destinations, &degree, dims);
+                break;
+            case OMB_TOPOLOGY_RING:
+            default:
+                sources[0] = destinations[0] = (rank - 1 + numprocs) %
+                    numprocs;
+                sources[1] = destinations[1] = (rank + 1) % numprocs;
+                degree = 2;
+                break;
+        }
+        *indegree = *outdegree = degree;
+    }
+
+    omb_dist_graph_create(MPI_COMM_WORLD, *indegree, sources, *outdegree,
+            destinations, comm);
+    free(sources);
+    free(destinations);
+
+    local[0] = *indegree > *outdegree ? *indegree : *outdegree;
+    local[1] = -local[0];
+    MPI_CHECK(MPI_Allreduce(local, global, 2, MPI_INT, MPI_MAX,
+                MPI_COMM_WORLD));
+    *max_degree = global[0];
+
+    switch (options.topology) {
+        case OMB_TOPOLOGY_KREG:
+            sprintf(omb_topology_desc, "random %d-regular",
+                    options.topology_degree);
+            break;
+        case OMB_TOPOLOGY_STENCIL2D:
+            sprintf(omb_topology_desc, "2D stencil %dx%d", dims[0], dims[1]);
+            break;
+        case OMB_TOPOLOGY_STENCIL3D:
+            sprintf(omb_topology_desc, "3D stencil %dx%dx%d", dims[0],
+                    dims[1], dims[2]);
+            break;
+        case OMB_TOPOLOGY_FILE:
+            sprintf(omb_topology_desc, "file %s", options.topology_file);
+            break;
+        case OMB_TOPOLOGY_RING:
+        default:
+            sprintf(omb_topology_desc, "ring");
+            break;
+    }
+    if (-global[1] == global[0]) {
+        sprintf(&omb_topology_desc[strlen(omb_topology_desc)],
+                ", degree %d", global[0]);
+    } else {
+        sprintf(&omb_topology_desc[strlen(omb_topology_desc)],
+                ", degree %d-%d", -global[1], global[0]);
+    }
+
+    return 0;
+}
+
+#if MPI_VERSION < 4
+/*
+ * Describe count elements of datatype as a single element of a derived type:
+ * a vector of OMB_LARGE_COUNT_CHUNK sized blocks followed by the remainder.
+ */
+static int omb_large_count_type(size_t count, MPI_Datatype datatype,
+                                MPI_Datatype *large_type)
+{
+    MPI_Datatype types[2];
+    MPI_Aint displs[2] = {0, 0};
+    int blocklens[2] = {1, 1};
+    MPI_Aint lb = 0, extent = 0;
+    int nchunks = count / OMB_LARGE_COUNT_CHUNK;
+    int remainder = count % OMB_LARGE_COUNT_CHUNK;
+    int ret = MPI_SUCCESS;
+
+    ret = MPI_Type_vector(nchunks, OMB_LARGE_COUNT_CHUNK,
+            OMB_LARGE_COUNT_CHUNK, datatype, &types[0]);
+    if (MPI_SUCCESS != ret) {
+        return ret;
+    }
+    if (0 == remainder) {
+        *large_type = types[0];
+    } else {
+        MPI_Type_get_extent(datatype, &lb, &extent);
+        MPI_Type_contiguous(remainder, datatype, &types[1]);
+        displs[1] = (MPI_Aint)nchunks * OMB_LARGE_COUNT_CHUNK * extent;
+        ret = MPI_Type_create_struct(2, blocklens, displs, types, large_type);
+        MPI_Type_free(&types[0]);
+        MPI_Type_free(&types[1]);
+        if (MPI_SUCCESS != ret) {
+            return ret;
+        }
+    }
+    return MPI_Type_commit(large_type);
+}
+#endif /* #if MPI_VERSION < 4 */
+
+int omb_large_send(void *buf, size_t count, MPI_Datatype datatype, int dest,
+                   int tag, MPI_Comm comm)
+{
+#if MPI_VERSION < 4
+    MPI_Datatype large_type;
+    int ret = MPI_SUCCESS;
+#endif
+
+    if (count <= INT_MAX) {
+        return MPI_Send(buf, count, datatype, dest, tag, comm);
+    }
+#if MPI_VERSION >= 4
+    return MPI_Send_c(buf, count, datatype, dest, tag, comm);
+#else
+    ret = omb_large_count_type(count, datatype, &large_type);
+    if (MPI_SUCCESS == ret) {
+        ret = MPI_Send(buf, 1, large_type, dest, tag, comm);
+        MPI_Type_free(&large_type);
+    }
+    return ret;
+#endif
+}
+
+int omb_large_recv(void *buf, size_t count, MPI_Datatype datatype, int source,
+                   int tag, MPI_Comm comm, MPI_Status *status)
+{
+#if MPI_VERSION < 4
+    MPI_Datatype large_type;
+    int ret = MPI_SUCCESS;
+#endif
+
+    if (count <= INT_MAX) {
+        return MPI_Recv(buf, count, datatype, source, tag, comm, status);
+    }
+#if MPI_VERSION >= 4
+    return MPI_Recv_c(buf, count, datatype, source, tag, comm, status);
+#else
+    ret = omb_large_count_type(count, datatype, &large_type);
+    if (MPI_SUCCESS == ret) {
+        ret = MPI_Recv(buf, 1, large_type, source, tag, comm, status);
+        MPI_Type_free(&large_type);
+    }
+    return ret;
+#endif
+}
+
+/*
+ * The derived type may be freed right away; MPI keeps it alive until the
+ * pending request completes.
+ */
+int omb_large_isend(void *buf, size_t count, MPI_Datatype datatype, int dest,
+                    int tag, MPI_Comm comm, MPI_Request *request)
+{
+#if MPI_VERSION < 4
+    MPI_Datatype large_type;
+    int ret = MPI_SUCCESS;
+#endif
+
+    if (count <= INT_MAX) {
+        return MPI_Isend(buf, count, datatype, dest, tag, comm, request);
+    }
+#if MPI_VERSION >= 4
+    return MPI_Isend_c(buf, count, datatype, dest, tag, comm, request);
+#else
+    ret = omb_large_count_type(count, datatype, &large_type);
+    if (MPI_SUCCESS == ret) {
+        ret = MPI_Isend(buf, 1, large_type, dest, tag, comm, request);
+        MPI_Type_free(&large_type);
+    }
+    return ret;
+#endif
+}
+
+int omb_large_irecv(void *buf, size_t count, MPI_Datatype datatype,
+                    int source, int tag, MPI_Comm comm, MPI_Request *request)
+{
+#if MPI_VERSION < 4
+    MPI_Datatype large_type;
+    int ret = MPI_SUCCESS;
+#endif
+
+    if (count <= INT_MAX) {
+        return MPI_Irecv(buf, count, datatype, source, tag, comm, request);
+    }
+#if MPI_VERSION >= 4
+    return MPI_Irecv_c(buf, count, datatype, source, tag, comm, request);
+#else
+    ret = omb_large_count_type(count, datatype, &large_type);
+    if (MPI_SUCCESS == ret) {
+        ret = MPI_Irecv(buf, 1, large_type, source, tag, comm, request);
+        MPI_Type_free(&large_type);
+    }
+    return ret;
+#endif
+}
+
+/*
+ * Predefined reduction operations are only defined on predefined datatypes,
+ * so without MPI-4 a large reduction is issued as a sequence of
+ * OMB_LARGE_COUNT_CHUNK element calls.
+ */
+int omb_large_allreduce(void *sendbuf, void *recvbuf, size_t count,
+                        MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
+{
+#if MPI_VERSION < 4
+    MPI_Aint lb = 0, extent = 0;
+    size_t offset = 0, chunk = 0;
+    int ret = MPI_SUCCESS;
+#endif
+
+    if (count <= INT_MAX) {
+        return MPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+    }
+#if MPI_VERSION >= 4
+    return MPI_Allreduce_c(sendbuf, recvbuf, count, datatype, op, comm);
+#else
+    MPI_Type_get_extent(datatype, &lb, &extent);
+    for (offset = 0; offset < count && MPI_SUCCESS == ret; offset += chunk) {
+        chunk = count - offset;
+        if (chunk > OMB_LARGE_COUNT_CHUNK) {
+            chunk = OMB_LARGE_COUNT_CHUNK;
+        }
+        ret = MPI_Allreduce(MPI_IN_PLACE == sendbuf ? MPI_IN_PLACE :
+                (char *)sendbuf + offset * extent,
+                (char *)recvbuf + offset * extent, chunk, datatype, op, comm);
+    }
+    return ret;
+#endif
+}
+
+enum omb_soak_action {
+    OMB_SOAK_RUN,
+    OMB_SOAK_REPORT,
+    OMB_SOAK_STOP
+};
+
+static void omb_soak_reset(omb_soak_t *soak)
+{
+    soak->sum = 0.0;
+    soak->count = 0.0;
+    soak->min = DBL_MAX;
+    soak->max = 0.0;
+}
+
+void omb_soak_init(omb_soak_t *soak, size_t size, char const *metric,
+                   int higher_is_better, MPI_Comm comm)
+{
+    int rank = 0;
+    char avg_metric[32];
+
+    memset(soak, 0, sizeof(*soak));
+    soak->higher_is_better = higher_is_better;
+    omb_soak_reset(soak);
+
+    MPI_CHECK(MPI_Comm_rank(comm, &rank));
+    print_version_message(rank);
+    if (0 == rank) {
+        fprintf(stdout, "# Soak: %.0f s at %zu bytes, %.0f s intervals, "
+                "%.0f%% threshold\n", options.soak_duration, size,
+                options.soak_interval, options.soak_threshold);
+        snprintf(avg_metric, sizeof(avg_metric), "Avg %s", metric);
+        fprintf(stdout, "%-*s%*s%*s%*s%*s%*s%*s\n", 10, "# Interval",
+                FIELD_WIDTH, "Time(s)", FIELD_WIDTH, avg_metric,
+                FIELD_WIDTH, "Min", FIELD_WIDTH, "Max", FIELD_WIDTH,
+                "Baseline", FIELD_WIDTH, "Status");
+        fflush(stdout);
+    }
+    MPI_CHECK(MPI_Barrier(comm));
+    soak->t_begin = soak->t_interval = MPI_Wtime();
+}
+
+void omb_soak_record(omb_soak_t *soak, double value)
+{
+    soak->sum += value;
+    soak->count += 1.0;
+    if (value < soak->min) {
+        soak->min = value;
+    }
+    if (value > soak->max) {
+        soak->max = value;
+    }
+}
+
+static int omb_soak_worse(omb_soak_t *soak, double value, double baseline)
+{
+    double threshold = options.soak_threshold / 100.0;
+
+    if (soak->higher_is_better) {
+        return value < baseline * (1.0 - threshold);
+    }
+    return value > baseline * (1.0 + threshold);
+}
+
+/*
+ * Close the current interval. Each interval is compared against the mean of
+ * the last OMB_SOAK_BASELINE_WINDOW healthy intervals to catch sudden drops,
+ * and against the first interval to catch drift too slow for the rolling
+ * baseline to notice. Degraded intervals are kept out of the baseline.
+ */
+static void omb_soak_report(omb_soak_t *soak, double now, MPI_Comm comm)
+{
+    int rank = 0, i;
+    double local[2] = {soak->sum, soak->count}, global[2] = {0.0, 0.0};
+    double min = 0.0, max = 0.0, avg = 0.0, baseline = 0.0;
+    char const *status = "ok";
+
+    MPI_CHECK(MPI_Comm_rank(comm, &rank));
+    MPI_CHECK(MPI_Reduce(local, global, 2, MPI_DOUBLE, MPI_SUM, 0, comm));
+    MPI_CHECK(MPI_Reduce(&soak->min, &min, 1, MPI_DOUBLE, MPI_MIN, 0, comm));
+    MPI_CHECK(MPI_Reduce(&soak->max, &max, 1, MPI_DOUBLE, MPI_MAX, 0, comm));
+    omb_soak_reset(soak);
+    soak->t_interval = now;
+
+    if (0 != rank || 0.0 == global[1]) {
+        return;
+    }
+
+    avg = global[0] / global[1];
+    soak->interval++;
+    if (0 == soak->nhistory) {
+        soak->reference = avg;
+        baseline = avg;
+        status = "baseline";
+    } else {
+        for (i = 0; i < soak->nhistory; i++) {
+            baseline += soak->history[i];
+        }
+        baseline /= soak->nhistory;
+        if (omb_soak_worse(soak, avg, baseline)) {
+            status = "DEGRADED";
+        } else if (omb_soak_worse(soak, avg, soak->reference)) {
+            status = "DRIFT";
+        }
+    }
+
+    if (0 == strcmp(status, "ok") || 0 == strcmp(status, "baseline")) {
+        if (OMB_SOAK_BASELINE_WINDOW == soak->nhistory) {
+            memmove(soak->history, &soak->history[1],
+                    (OMB_SOAK_BASELINE_WINDOW - 1) * sizeof(double));
+            soak->nhistory--;
+        }
+        soak->history[soak->nhistory++] = avg;
+    } else {
+        soak->degraded++;
+    }
+
+    fprintf(stdout, "%-*d%*.*f%*.*f%*.*f%*.*f%*.*f%*s\n", 10, soak->interval,
+            FIELD_WIDTH, FLOAT_PRECISION, now - soak->t_begin,
+            FIELD_WIDTH, FLOAT_PRECISION, avg,
+            FIELD_WIDTH, FLOAT_PRECISION, min,
+            FIELD_WIDTH, FLOAT_PRECISION, max,
+            FIELD_WIDTH, FLOAT_PRECISION, baseline,
+            FIELD_WIDTH, status);
+    fflush(stdout);
+}
+
+int omb_soak_continue(omb_soak_t *soak, MPI_Comm comm)
+{
+    int rank = 0, action = OMB_SOAK_RUN;
+    double now = MPI_Wtime();
+
+    MPI_CHECK(MPI_Comm_rank(comm, &rank));
+    if (0 == rank) {
+        if (now - soak->t_begin >= options.soak_duration) {
+            action = OMB_SOAK_STOP;
+        } else if (now - soak->t_interval >= options.soak_interval) {
+            action = OMB_SOAK_REPORT;
+        }
+    }
+    MPI_CHECK(MPI_Bcast(&action, 1, MPI_INT, 0, comm));
+
+    if (OMB_SOAK_RUN != action) {
+        omb_soak_report(soak, now, comm);
+    }
+    if (OMB_SOAK_STOP == action) {
+        if (0 == rank) {
+            fprintf(stdout, "# Soak finished: %d intervals, %d degraded\n",
+                    soak->interval, soak->degraded);
+            fflush(stdout);
+        }
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * Data touch. The producer fills the send buffer with a per-iteration byte so
+ * the stores cannot be hoisted out of the loop. The consumer sums the receive
+ * buffer a word at a time with independent accumulators, which the compiler
+ * vectorizes; the result goes to a volatile sink so the loads are kept.
+ */
+static volatile uint64_t omb_touch_sink;
+
+void omb_touch_produce(char *buf, size_t size, int iteration)
+{
+    memset(buf, 'a' + iteration % 26, size);
+}
+
+void omb_touch_consume(char const *buf, size_t size)
+{
+    uint64_t acc[4] = {0, 0, 0, 0}, word[4];
+    size_t i = 0, j;
+
+    for (; i + sizeof(word) <= size; i += sizeof(word)) {
+        memcpy(word, buf + i, sizeof(word));
+        for (j = 0; j < 4; j++) {
+            acc[j] += word[j];
+        }
+    }
+    for (; i < size; i++) {
+        acc[0] += (unsigned char)buf[i];
+    }
+    omb_touch_sink += acc[0] + acc[1] + acc[2] + acc[3];
+}
+
+/*
+ * Collective algorithm sweep through MPI_T control variables. The selector for
+ * a collective is the cvar whose '_'-separated name contains the collective as
+ * a token and ends in "algorithm" (coll_tuned_allreduce_algorithm,
+ * MPIR_CVAR_ALLREDUCE_INTRA_ALGORITHM). It must be an enumeration so that the
+ * candidates can be listed. Every candidate is measured on a fresh duplicate
+ * of comm because Open MPI's tuned component reads the setting when a
+ * communicator is created.
+ */
+static int omb_sweep_match(char const *cvar, char const *collective)
+{
+    char name[256], *token, *saveptr = NULL;
+    int found = 0, last_is_algorithm = 0, i;
+
+    for (i = 0; cvar[i] && i < (int)sizeof(name) - 1; i++) {
+        name[i] = tolower((unsigned char)cvar[i]);
+    }
+    name[i] = '\0';
+
+    for (token = strtok_r(name, "_", &saveptr); NULL != token;
+            token = strtok_r(NULL, "_", &saveptr)) {
+        if (0 == strcmp(token, "inter")) {
+            return 0;
+        }
+        found |= 0 == strcmp(token, collective);
+        last_is_algorithm = 0 == strcmp(token, "algorithm");
+    }
+
+    return found && last_is_algorithm;
+}
+
+static int omb_sweep_find_cvar(char const *collective, char *name,
+                               int name_max, MPI_T_enum *enumtype)
+{
+    int num = 0, i, name_len, desc_len, verbosity, bind, scope;
+    MPI_Datatype datatype;
+
+    MPI_CHECK(MPI_T_cvar_get_num(&num));
+    for (i = 0; i < num; i++) {
+        name_len = name_max;
+        desc_len = 0;
+        if (MPI_SUCCESS != MPI_T_cvar_get_info(i, name, &name_len, &verbosity,
+                    &datatype, enumtype, NULL, &desc_len, &bind, &scope)) {
+            continue;
+        }
+        if (MPI_INT == datatype && MPI_T_ENUM_NULL != *enumtype &&
+                MPI_T_SCOPE_CONSTANT != scope &&
+                MPI_T_SCOPE_READONLY != scope &&
+                omb_sweep_match(name, collective)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* Returns 1 if the named cvar exists and reads as zero */
+static int omb_sweep_cvar_is_zero(char const *cvar)
+{
+    char name[256], value[64];
+    int num = 0, i, j, name_len, desc_len, verbosity, bind, scope, count;
+    int zero = 0;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+    MPI_T_cvar_handle handle;
+
+    MPI_CHECK(MPI_T_cvar_get_num(&num));
+    for (i = 0; i < num; i++) {
+        name_len = sizeof(name);
+        desc_len = 0;
+        if (MPI_SUCCESS != MPI_T_cvar_get_info(i, name, &name_len, &verbosity,
+                    &datatype, &enumtype, NULL, &desc_len, &bind, &scope) ||
+                0 != strcmp(name, cvar)) {
+            continue;
+        }
+        if (MPI_SUCCESS != MPI_T_cvar_handle_alloc(i, NULL, &handle, &count)) {
+            return 0;
+        }
+        memset(value, 0, sizeof(value));
+        if (1 == count && MPI_SUCCESS == MPI_T_cvar_read(handle, value)) {
+            for (zero = 1, j = 0; j < (int)sizeof(value); j++) {
+                zero = zero && 0 == value[j];
+            }
+        }
+        MPI_T_cvar_handle_free(&handle);
+        return zero;
+    }
+
+    return 0;
+}
+
+/* Collective ids of Open MPI's coll_tuned dynamic rules file */
+static int omb_sweep_ompi_id(char const *collective)
+{
+    if (0 == strcmp(collective, "allreduce")) {
+        return 2;
+    } else if (0 == strcmp(collective, "alltoall")) {
+        return 3;
+    } else if (0 == strcmp(collective, "bcast")) {
+        return 7;
+    }
+    return -1;
+}
+
+static void omb_sweep_write_rules(char const *path, char const *collective,
+                                  int comm_size, int const *best,
+                                  int const *values, int nsizes, size_t unit)
+{
+    FILE *fp = NULL;
+    size_t size;
+    int s, nrules = 0;
+
+    for (s = 0; s < nsizes; s++) {
+        nrules += 0 == s || best[s] != best[s - 1];
+    }
+
+    fp = fopen(path, "w");
+    if (NULL == fp) {
+        fprintf(stderr, "Could not open rules file %s\n", path);
+        return;
+    }
+    fprintf(fp, "# Open MPI coll_tuned dynamic rules written by %s\n",
+            benchmark_name);
+    fprintf(fp, "1 # number of collectives\n");
+    fprintf(fp, "%d # collective id (%s)\n", omb_sweep_ompi_id(collective),
+            collective);
+    fprintf(fp, "1 # number of communicator sizes\n");
+    fprintf(fp, "%d # communicator size\n", comm_size);
+    fprintf(fp, "%d # number of message sizes\n", nrules);
+    fprintf(fp, "# message size, algorithm, fan in/out, segment size\n");
+    for (s = 0, size = options.min_message_size; s < nsizes;
+            s++, size = (size ? size * 2 : 1)) {
+        if (0 == s || best[s] != best[s - 1]) {
+            fprintf(fp, "%zu %d 0 0\n", 0 == s ? 0 : size * unit,
+                    values[best[s]]);
+        }
+    }
+    fclose(fp);
+    fprintf(stdout, "# Rules written to %s (use with "
+            "--mca coll_tuned_dynamic_rules_filename)\n", path);
+}
+
+int omb_coll_sweep(char const *collective, size_t unit,
+                   omb_coll_sweep_fn run, void *arg, MPI_Comm comm)
+{
+    char cvar[256], item[OMB_SWEEP_NAME_LEN];
+    char names[OMB_SWEEP_MAX_ALGOS][OMB_SWEEP_NAME_LEN];
+    int values[OMB_SWEEP_MAX_ALGOS], best[64];
+    int provided = 0, index, nitems = 0, nalgos = 0, nsizes = 0;
+    int original = 0, count = 0, rank = 0, comm_size = 0, failed = 0;
+    int unsupported = 0, def = -1;
+    int a, s, len;
+    size_t size;
+    double *latency = NULL;
+    MPI_T_enum enumtype;
+    MPI_T_cvar_handle handle;
+    MPI_Comm sweep_comm;
+
+    MPI_CHECK(MPI_Comm_rank(comm, &rank));
+    MPI_CHECK(MPI_Comm_size(comm, &comm_size));
+    if (MPI_SUCCESS != MPI_T_init_thread(MPI_THREAD_SINGLE, &provided)) {
+        if (0 == rank) {
+            fprintf(stderr, "MPI_T interface is not available\n");
+        }
+        return -1;
+    }
+
+    index = omb_sweep_find_cvar(collective, cvar, sizeof(cvar), &enumtype);
+    if (index < 0) {
+        if (0 == rank) {
+            fprintf(stderr, "No writable MPI_T algorithm control variable "
+                    "found for %s\n", collective);
+        }
+        MPI_T_finalize();
+        return -1;
+    }
+    if (0 == strncmp(cvar, "coll_tuned_", strlen("coll_tuned_")) &&
+            omb_sweep_cvar_is_zero("coll_tuned_use_dynamic_rules")) {
+        if (0 == rank) {
+            fprintf(stderr, "%s is ignored unless dynamic rules are enabled; "
+                    "rerun with --mca coll_tuned_use_dynamic_rules 1\n", cvar);
+        }
+        MPI_T_finalize();
+        return -1;
+    }
+
+    len = sizeof(item);
+    MPI_CHECK(MPI_T_enum_get_info(enumtype, &nitems, item, &len));
+    for (a = 0; a < nitems && nalgos < OMB_SWEEP_MAX_ALGOS; a++) {
+        len = OMB_SWEEP_NAME_LEN;
+        if (MPI_SUCCESS == MPI_T_enum_get_item(enumtype, a, &values[nalgos],
+                    names[nalgos], &len)) {
+            nalgos++;
+        }
+    }
+    for (size = options.min_message_size; size * unit <=
+            options.max_message_size && nsizes < 64;
+            size = (size ? size * 2 : 1)) {
+        nsizes++;
+    }
+
+    MPI_CHECK(MPI_T_cvar_handle_alloc(index, NULL, &handle, &count));
+    MPI_CHECK(MPI_T_cvar_read(handle, &original));
+    /* The baseline is whatever the library runs when left alone */
+    for (a = 0; a < nalgos && def < 0; a++) {
+        def = values[a] == original ? a : def;
+    }
+    latency = calloc((size_t)nalgos * nsizes, sizeof(double));
+
+    print_version_message(rank);
+    if (0 == rank) {
+        fprintf(stdout, "# Algorithm sweep: %s, %d candidates\n", cvar,
+                nalgos);
+        fflush(stdout);
+    }
+
+    for (a = 0; a < nalgos && !failed; a++) {
+        failed = MPI_SUCCESS != MPI_T_cvar_write(handle, &values[a]);
+        MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX,
+                    comm));
+        if (failed) {
+            if (0 == rank) {
+                fprintf(stderr, "Could not set %s to %s\n", cvar, names[a]);
+            }
+            break;
+        }
+
+        MPI_CHECK(MPI_Comm_dup(comm, &sweep_comm));
+        MPI_CHECK(MPI_Comm_set_errhandler(sweep_comm, MPI_ERRORS_RETURN));
+        if (0 == rank) {
+            fprintf(stdout, "\n# Algorithm %d: %s\n", values[a], names[a]);
+            fprintf(stdout, "%-*s%*s\n", 10, "# Size", FIELD_WIDTH,
+                    "Avg Latency(us)");
+            fflush(stdout);
+        }
+        for (s = 0; s < nsizes; s++) {
+            latency[a * nsizes + s] = DBL_MAX;
+        }
+        for (s = 0, size = options.min_message_size; s < nsizes;
+                s++, size = (size ? size * 2 : 1)) {
+            latency[a * nsizes + s] = run(sweep_comm, size, arg);
+            unsupported = latency[a * nsizes + s] < 0;
+            MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &unsupported, 1, MPI_INT,
+                        MPI_MAX, comm));
+            if (unsupported) {
+                latency[a * nsizes + s] = DBL_MAX;
+                if (0 == rank) {
+                    fprintf(stdout, "# Not supported from %zu bytes on\n",
+                            size * unit);
+                }
+                break;
+            }
+            if (0 == rank) {
+                fprintf(stdout, "%-*zu%*.*f\n", 10, size * unit, FIELD_WIDTH,
+                        FLOAT_PRECISION, latency[a * nsizes + s]);
+                fflush(stdout);
+            }
+        }
+        MPI_CHECK(MPI_Comm_free(&sweep_comm));
+    }
+    MPI_T_cvar_write(handle, &original);
+    MPI_T_cvar_handle_free(&handle);
+
+    if (0 == rank && !failed) {
+        if (def >= 0) {
+            fprintf(stdout, "\n# Best algorithm per size (default: %s)\n",
+                    names[def]);
+        } else {
+            fprintf(stdout, "\n# Best algorithm per size (default: %d, not "
+                    "a swept value)\n", original);
+        }
+        fprintf(stdout, "%-*s%*s%*s%*s%*s\n", 10, "# Size", 24, "Algorithm",
+                FIELD_WIDTH, "Latency(us)", FIELD_WIDTH, "Default(us)",
+                FIELD_WIDTH, "Speedup");
+        for (s = 0, size = options.min_message_size; s < nsizes;
+                s++, size = (size ? size * 2 : 1)) {
+            best[s] = 0;
+            for (a = 1; a < nalgos; a++) {
+                if (latency[a * nsizes + s] < latency[best[s] * nsizes + s]) {
+                    best[s] = a;
+                }
+            }
+            fprintf(stdout, "%-*zu%*s%*.*f", 10, size * unit, 24,
+                    names[best[s]], FIELD_WIDTH, FLOAT_PRECISION,
+                    latency[best[s] * nsizes + s]);
+            if (def >= 0) {
+                fprintf(stdout, "%*.*f%*.2f\n", FIELD_WIDTH, FLOAT_PRECISION,
+                        latency[def * nsizes + s], FIELD_WIDTH,
+                        latency[def * nsizes + s] /
+                        latency[best[s] * nsizes + s]);
+            } else {
+                fprintf(stdout, "%*s%*s\n", FIELD_WIDTH, "-", FIELD_WIDTH,
+                        "-");
+            }
+        }
+        if (NULL != options.algo_rules) {
+            if (0 == strncmp(cvar, "coll_tuned_", strlen("coll_tuned_")) &&
+                    omb_sweep_ompi_id(collective) >= 0) {
+                omb_sweep_write_rules(options.algo_rules, collective,
+                        comm_size, best, values, nsizes, unit);
+            } else {
+                fprintf(stdout, "# Rules file not written: only Open MPI "
+                        "coll_tuned rules are supported\n");
+            }
+        }
+        fflush(stdout);
+    }
+
+    free(latency);
+    MPI_T_finalize();
+
+    return failed ? -1 : 0;
+}
+
+void omb_coll_args_init(omb_coll_args_t *args, enum omb_coll_type type,
+                        MPI_Comm comm)
+{
+    memset(args, 0, sizeof(*args));
+    args->type = type;
+    args->sendtype = MPI_CHAR;
+    args->recvtype = MPI_CHAR;
+    args->op = MPI_SUM;
+    args->comm = comm;
+}
+
+int omb_coll_call(omb_coll_args_t *args, enum omb_coll_call call,
+                  MPI_Request *request)
+{
+    omb_coll_args_t *a = args;
+
+    switch (a->type) {
+        case OMB_COLL_ALLGATHER:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Allgather(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Iallgather(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->comm,
+                        request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Allgather_init(a->sendbuf, a->sendcount, a->sendtype,
+                    a->recvbuf, a->recvcount, a->recvtype, a->comm,
+                    MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_ALLGATHERV:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Allgatherv(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcounts, a->rdispls, a->recvtype,
+                        a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Iallgatherv(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcounts, a->rdispls, a->recvtype,
+                        a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Allgatherv_init(a->sendbuf, a->sendcount, a->sendtype,
+                    a->recvbuf, a->recvcounts, a->rdispls, a->recvtype,
+                    a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_ALLREDUCE:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Allreduce(a->sendbuf, a->recvbuf, a->sendcount,
+                        a->sendtype, a->op, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Iallreduce(a->sendbuf, a->recvbuf, a->sendcount,
+                        a->sendtype, a->op, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Allreduce_init(a->sendbuf, a->recvbuf, a->sendcount,
+                    a->sendtype, a->op, a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_ALLTOALL:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Alltoall(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ialltoall(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->comm,
+                        request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Alltoall_init(a->sendbuf, a->sendcount, a->sendtype,
+                    a->recvbuf, a->recvcount, a->recvtype, a->comm,
+                    MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_ALLTOALLV:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Alltoallv(a->sendbuf, a->sendcounts, a->sdispls,
+                        a->sendtype, a->recvbuf, a->recvcounts, a->rdispls,
+                        a->recvtype, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ialltoallv(a->sendbuf, a->sendcounts, a->sdispls,
+                        a->sendtype, a->recvbuf, a->recvcounts, a->rdispls,
+                        a->recvtype, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Alltoallv_init(a->sendbuf, a->sendcounts, a->sdispls,
+                    a->sendtype, a->recvbuf, a->recvcounts, a->rdispls,
+                    a->recvtype, a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_ALLTOALLW:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Alltoallw(a->sendbuf, a->sendcounts, a->sdispls,
+                        a->sendtypes, a->recvbuf, a->recvcounts, a->rdispls,
+                        a->recvtypes, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ialltoallw(a->sendbuf, a->sendcounts, a->sdispls,
+                        a->sendtypes, a->recvbuf, a->recvcounts, a->rdispls,
+                        a->recvtypes, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Alltoallw_init(a->sendbuf, a->sendcounts, a->sdispls,
+                    a->sendtypes, a->recvbuf, a->recvcounts, a->rdispls,
+                    a->recvtypes, a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_BARRIER:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Barrier(a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ibarrier(a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Barrier_init(a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_BCAST:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Bcast(a->sendbuf, a->sendcount, a->sendtype,
+                        a->root, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ibcast(a->sendbuf, a->sendcount, a->sendtype,
+                        a->root, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Bcast_init(a->sendbuf, a->sendcount, a->sendtype,
+                    a->root, a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_GATHER:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Gather(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->root,
+                        a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Igather(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->root,
+                        a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Gather_init(a->sendbuf, a->sendcount, a->sendtype,
+                    a->recvbuf, a->recvcount, a->recvtype, a->root, a->comm,
+                    MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_GATHERV:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Gatherv(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcounts, a->rdispls, a->recvtype,
+                        a->root, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Igatherv(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcounts, a->rdispls, a->recvtype,
+                        a->root, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Gatherv_init(a->sendbuf, a->sendcount, a->sendtype,
+                    a->recvbuf, a->recvcounts, a->rdispls, a->recvtype,
+                    a->root, a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_REDUCE:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Reduce(a->sendbuf, a->recvbuf, a->sendcount,
+                        a->sendtype, a->op, a->root, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ireduce(a->sendbuf, a->recvbuf, a->sendcount,
+                        a->sendtype, a->op, a->root, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Reduce_init(a->sendbuf, a->recvbuf, a->sendcount,
+                    a->sendtype, a->op, a->root, a->comm, MPI_INFO_NULL,
+                    request);
+#endif
+            break;
+        case OMB_COLL_REDUCE_SCATTER:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Reduce_scatter(a->sendbuf, a->recvbuf,
+                        a->recvcounts, a->sendtype, a->op, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ireduce_scatter(a->sendbuf, a->recvbuf,
+                        a->recvcounts, a->sendtype, a->op, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Reduce_scatter_init(a->sendbuf, a->recvbuf,
+                    a->recvcounts, a->sendtype, a->op, a->comm,
+                    MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_SCATTER:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Scatter(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->root,
+                        a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Iscatter(a->sendbuf, a->sendcount, a->sendtype,
+                        a->recvbuf, a->recvcount, a->recvtype, a->root,
+                        a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Scatter_init(a->sendbuf, a->sendcount, a->sendtype,
+                    a->recvbuf, a->recvcount, a->recvtype, a->root, a->comm,
+                    MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_SCATTERV:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Scatterv(a->sendbuf, a->sendcounts, a->sdispls,
+                        a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                        a->root, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Iscatterv(a->sendbuf, a->sendcounts, a->sdispls,
+                        a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                        a->root, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Scatterv_init(a->sendbuf, a->sendcounts, a->sdispls,
+                    a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                    a->root, a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_NEIGHBOR_ALLGATHER:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Neighbor_allgather(a->sendbuf, a->sendcount,
+                        a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                        a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ineighbor_allgather(a->sendbuf, a->sendcount,
+                        a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                        a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Neighbor_allgather_init(a->sendbuf, a->sendcount,
+                    a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                    a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_NEIGHBOR_ALLTOALL:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Neighbor_alltoall(a->sendbuf, a->sendcount,
+                        a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                        a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ineighbor_alltoall(a->sendbuf, a->sendcount,
+                        a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                        a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Neighbor_alltoall_init(a->sendbuf, a->sendcount,
+                    a->sendtype, a->recvbuf, a->recvcount, a->recvtype,
+                    a->comm, MPI_INFO_NULL, request);
+#endif
+            break;
+        case OMB_COLL_NEIGHBOR_ALLTOALLV:
+            if (OMB_CALL_BLOCKING == call) {
+                return MPI_Neighbor_alltoallv(a->sendbuf, a->sendcounts,
+                        a->sdispls, a->sendtype, a->recvbuf, a->recvcounts,
+                        a->rdispls, a->recvtype, a->comm);
+            } else if (OMB_CALL_NONBLOCKING == call) {
+                return MPI_Ineighbor_alltoallv(a->sendbuf, a->sendcounts,
+                        a->sdispls, a->sendtype, a->recvbuf, a->recvcounts,
+                        a->rdispls, a->recvtype, a->comm, request);
+            }
+#if MPI_VERSION >= 4
+            return MPI_Neighbor_alltoallv_init(a->sendbuf, a->sendcounts,
+                    a->sdispls, a->sendtype, a->recvbuf, a->recvcounts,
+                    a->rdispls, a->recvtype, a->comm, MPI_INFO_NULL,
+                    request);
+#endif
+            break;
+    }
+
+    return MPI_ERR_OTHER;
+}
+
+/* Average latency in us of the blocking or nonblocking form on this rank */
+static double omb_persistent_compare(omb_coll_args_t *args,
+                                     enum omb_coll_call call)
+{
+    MPI_Request request;
+    double t_start = 0.0, timer = 0.0;
+    int i;
+
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        t_start = MPI_Wtime();
+        MPI_CHECK(omb_coll_call(args, call, &request));
+        if (OMB_CALL_NONBLOCKING == call) {
+            MPI_CHECK(MPI_Wait(&request, MPI_STATUS_IGNORE));
+        }
+        if (i >= options.skip) {
+            timer += MPI_Wtime() - t_start;
+        }
+        MPI_CHECK(MPI_Barrier(args->comm));
+    }
+
+    return timer * 1e6 / options.iterations;
+}
+
+void omb_persistent_init(omb_coll_args_t *args, MPI_Request *request)
+{
+    double t_start = 0.0, t_init = 0.0, local[3], sum[3];
+    int i, numprocs = 0;
+
+    MPI_CHECK(MPI_Comm_size(args->comm, &numprocs));
+    for (i = 0; i < OMB_PERSISTENT_INIT_REPS; i++) {
+        if (i > 0) {
+            MPI_CHECK(MPI_Request_free(request));
+        }
+        MPI_CHECK(MPI_Barrier(args->comm));
+        t_start = MPI_Wtime();
+        MPI_CHECK(omb_coll_call(args, OMB_CALL_PERSISTENT, request));
+        t_init += MPI_Wtime() - t_start;
+    }
+
+    local[0] = t_init * 1e6 / OMB_PERSISTENT_INIT_REPS;
+    local[1] = omb_persistent_compare(args, OMB_CALL_BLOCKING);
+    local[2] = omb_persistent_compare(args, OMB_CALL_NONBLOCKING);
+    MPI_CHECK(MPI_Reduce(local, sum, 3, MPI_DOUBLE, MPI_SUM, 0, args->comm));
+    omb_persistent_stats.init = sum[0] / numprocs;
+    omb_persistent_stats.blocking = sum[1] / numprocs;
+    omb_persistent_stats.nonblocking = sum[2] / numprocs;
+}
+
+int omb_coll_count_check(size_t unit)
+{
+    char const *mode = NULL;
+    size_t max = options.max_message_size;
+    int rank = 0, j;
+
+    if (options.persistent) {
+        mode = "-N";
+    } else if (options.throughput) {
+        mode = "-q";
+    } else if (options.ref_algo) {
+        mode = "-E";
+    } else if (options.in_flight) {
+        mode = "-z";
+        for (j = 0, max = options.in_flight_fixed ? 0 : max;
+                j < options.in_flight && options.in_flight_fixed; j++) {
+            max = MAX(max, options.in_flight_sizes[j]);
+        }
+    }
+    if (NULL == mode || max / unit <= INT_MAX) {
+        return 0;
+    }
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    if (0 == rank) {
+        fprintf(stderr, "%s passes int counts to MPI, please use sizes of "
+                "%zu bytes or less\n", mode, (size_t)INT_MAX * unit);
+    }
+
+    return 1;
+}
+
+typedef struct omb_float_int {
+    float value;
+    int index;
+} omb_float_int_t;
+
+static MPI_Op omb_bfloat16_ops[3] = {MPI_OP_NULL, MPI_OP_NULL, MPI_OP_NULL};
+
+/* bfloat16 is the upper half of a float, rounded to nearest even */
+static uint16_t omb_float_to_bfloat16(float value)
+{
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    bits += 0x7FFF + ((bits >> 16) & 1);
+
+    return bits >> 16;
+}
+
+static float omb_bfloat16_to_float(uint16_t value)
+{
+    uint32_t bits = (uint32_t)value << 16;
+    float result;
+
+    memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+static void omb_bfloat16_sum(void *in, void *inout, int *len,
+                             MPI_Datatype *datatype)
+{
+    uint16_t *a = in, *b = inout;
+    int i;
+
+    for (i = 0; i < *len; i++) {
+        b[i] = omb_float_to_bfloat16(omb_bfloat16_to_float(a[i]) +
+                omb_bfloat16_to_float(b[i]));
+    }
+}
+
+static void omb_bfloat16_max(void *in, void *inout, int *len,
+                             MPI_Datatype *datatype)
+{
+    uint16_t *a = in, *b = inout;
+    int i;
+
+    for (i = 0; i < *len; i++) {
+        if (omb_bfloat16_to_float(a[i]) > omb_bfloat16_to_float(b[i])) {
+            b[i] = a[i];
+        }
+    }
+}
+
+static void omb_bfloat16_min(void *in, void *inout, int *len,
+                             MPI_Datatype *datatype)
+{
+    uint16_t *a = in, *b = inout;
+    int i;
+
+    for (i = 0; i < *len; i++) {
+        if (omb_bfloat16_to_float(a[i]) < omb_bfloat16_to_float(b[i])) {
+            b[i] = a[i];
+        }
+    }
+}
+
+void omb_reduction_get(MPI_Datatype *datatype, MPI_Op *op, size_t *size)
+{
+    MPI_User_function *bfloat16_fns[3] = {omb_bfloat16_sum, omb_bfloat16_max,
+        omb_bfloat16_min};
+    int i;
+
+    switch (options.reduce_dtype) {
+        case OMB_DTYPE_DOUBLE:
+            *datatype = MPI_DOUBLE;
+            *size = sizeof(double);
+            break;
+        case OMB_DTYPE_INT:
+            *datatype = MPI_INT;
+            *size = sizeof(int);
+            break;
+        case OMB_DTYPE_INT64:
+            *datatype = MPI_INT64_T;
+            *size = sizeof(int64_t);
+            break;
+        case OMB_DTYPE_COMPLEX:
+            *datatype = MPI_C_FLOAT_COMPLEX;
+            *size = 2 * sizeof(float);
+            break;
+        case OMB_DTYPE_FLOAT_INT:
+            *datatype = MPI_FLOAT_INT;
+            *size = sizeof(omb_float_int_t);
+            break;
+        case OMB_DTYPE_BFLOAT16:
+            *datatype = MPI_UINT16_T;
+            *size = sizeof(uint16_t);
+            break;
+        default:
+            *datatype = MPI_FLOAT;
+            *size = sizeof(float);
+            break;
+    }
+
+    switch (options.reduce_op) {
+        case OMB_OP_MAX:
+            *op = MPI_MAX;
+            i = 1;
+            break;
+        case OMB_OP_MIN:
+            *op = MPI_MIN;
+            i = 2;
+            break;
+        case OMB_OP_MAXLOC:
+            *op = MPI_MAXLOC;
+            i = -1;
+            break;
+        case OMB_OP_MINLOC:
+            *op = MPI_MINLOC;
+            i = -1;
+            break;
+        default:
+            *op = MPI_SUM;
+            i = 0;
+            break;
+    }
+
+    if (OMB_DTYPE_BFLOAT16 == options.reduce_dtype && i >= 0) {
+        if (MPI_OP_NULL == omb_bfloat16_ops[i]) {
+            MPI_CHECK(MPI_Op_create(bfloat16_fns[i], 1, &omb_bfloat16_ops[i]));
+        }
+        *op = omb_bfloat16_ops[i];
+    }
+}
+
+void omb_reduction_free(void)
+{
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        if (MPI_OP_NULL != omb_bfloat16_ops[i]) {
+            MPI_CHECK(MPI_Op_free(&omb_bfloat16_ops[i]));
+        }
+    }
+}
+
+/*
+ * Element i of the send buffer on rank r. Sums use the float pattern (kept
+ * small for bfloat16 so that it stays exact); max and min rotate an offset
+ * of 0..numprocs-1 over the ranks so that the winning rank varies with i.
+ */
+static double omb_reduction_value(size_t i, int iter, int rank, int numprocs)
+{
+    double base = OMB_DTYPE_BFLOAT16 == options.reduce_dtype ? i % 8 + 1 :
+        i % 100 + 1;
+
+    if (OMB_OP_SUM == options.reduce_op) {
+        return OMB_DTYPE_BFLOAT16 == options.reduce_dtype ? base :
+            base * (iter + 1);
+    }
+
+    return base + (rank + i) % numprocs;
+}
+
+static void omb_reduction_store(void *buffer, size_t i, double value,
+                                int index)
+{
+    switch (options.reduce_dtype) {
+        case OMB_DTYPE_DOUBLE:
+            ((double *)buffer)[i] = value;
+            break;
+        case OMB_DTYPE_INT:
+            ((int *)buffer)[i] = (int)value;
+            break;
+        case OMB_DTYPE_INT64:
+            ((int64_t *)buffer)[i] = (int64_t)value;
+            break;
+        case OMB_DTYPE_COMPLEX:
+            ((float *)buffer)[2 * i] = value;
+            ((float *)buffer)[2 * i + 1] = -value;
+            break;
+        case OMB_DTYPE_FLOAT_INT:
+            ((omb_float_int_t *)buffer)[i].value = value;
+            ((omb_float_int_t *)buffer)[i].index = index;
+            break;
+        case OMB_DTYPE_BFLOAT16:
+            ((uint16_t *)buffer)[i] = omb_float_to_bfloat16(value);
+            break;
+        default:
+            ((float *)buffer)[i] = value;
+            break;
+    }
+}
+
+/* Returns the value; index gets the pair index or the imaginary part */
+static double omb_reduction_load(void *buffer, size_t i, double *index)
+{
+    *index = 0;
+    switch (options.reduce_dtype) {
+        case OMB_DTYPE_DOUBLE:
+            return ((double *)buffer)[i];
+        case OMB_DTYPE_INT:
+            return ((int *)buffer)[i];
+        case OMB_DTYPE_INT64:
+            return ((int64_t *)buffer)[i];
+        case OMB_DTYPE_COMPLEX:
+            *index = ((float *)buffer)[2 * i + 1];
+            return ((float *)buffer)[2 * i];
+        case OMB_DTYPE_FLOAT_INT:
+            *index = ((omb_float_int_t *)buffer)[i].index;
+            return ((omb_float_int_t *)buffer)[i].value;
+        case OMB_DTYPE_BFLOAT16:
+            return omb_bfloat16_to_float(((uint16_t *)buffer)[i]);
+        default:
+            return ((float *)buffer)[i];
+    }
+}
+
+void omb_reduction_set_buffer(void *buffer, int is_send_buf, size_t count,
+                              int iter)
+{
+    int rank = 0, numprocs = 0;
+    size_t i;
+
+    if (NULL == buffer) {
+        return;
+    }
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    for (i = 0; i < count; i++) {
+        omb_reduction_store(buffer, i, is_send_buf ? omb_reduction_value(i,
+                    iter, rank, numprocs) : 0, rank);
+    }
+}
+
+/* count elements of the result starting at element offset of the vector */
+int omb_reduction_validate(void *buffer, size_t count, size_t offset,
+                           int iter, int num_procs)
+{
+    double expected, value, index, expected_index = 0, delta;
+    size_t i, j;
+
+    for (i = 0; i < count; i++) {
+        j = offset + i;
+        switch (options.reduce_op) {
+            case OMB_OP_SUM:
+                expected = omb_reduction_value(j, iter, 0, 1) * num_procs;
+                expected_index = -expected;
+                break;
+            case OMB_OP_MAX:
+            case OMB_OP_MAXLOC:
+                expected = omb_reduction_value(j, iter, num_procs - 1 - j %
+                        num_procs, num_procs);
+                expected_index = (num_procs - 1 - j % num_procs);
+                break;
+            default:
+                expected = omb_reduction_value(j, iter, (num_procs - j %
+                            num_procs) % num_procs, num_procs);
+                expected_index = (num_procs - j % num_procs) % num_procs;
+                break;
+        }
+        delta = OMB_DTYPE_BFLOAT16 == options.reduce_dtype ?
+            OMB_BFLOAT16_DELTA * expected : ERROR_DELTA;
+        value = omb_reduction_load(buffer, i, &index);
+        if (fabs(value - expected) > delta) {
+            return 1;
+        }
+        if ((OMB_DTYPE_COMPLEX == options.reduce_dtype ||
+                    OMB_DTYPE_FLOAT_INT == options.reduce_dtype) &&
+                fabs(index - expected_index) > delta) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int omb_reduction_sweep(size_t unit, omb_coll_sweep_fn run, void *arg,
+                        MPI_Comm comm)
+{
+    int dtypes[OMB_REDUCE_MAX_COMBOS], ops[OMB_REDUCE_MAX_COMBOS];
+    int ncombos = 0, dtype, op, rank = 0, i;
+    char name[OMB_SWEEP_NAME_LEN];
+    MPI_Datatype datatype;
+    MPI_Op mpi_op;
+    size_t size, elem_size, count;
+    double latency;
+
+    for (dtype = 1; dtype <= OMB_DTYPE_ALL; dtype <<= 1) {
+        for (op = 1; op <= OMB_OP_ALL; op <<= 1) {
+            if ((options.reduce_dtypes & dtype) &&
+                    (options.reduce_ops & op) && omb_reduce_valid(dtype, op)) {
+                dtypes[ncombos] = dtype;
+                ops[ncombos++] = op;
+            }
+        }
+    }
+
+    MPI_CHECK(MPI_Comm_rank(comm, &rank));
+    if (0 == rank) {
+        fprintf(stdout, "# Datatype x op sweep, average latency (us)\n");
+        fprintf(stdout, "%-*s", 10, "# Size");
+        for (i = 0; i < ncombos; i++) {
+            snprintf(name, sizeof(name), "%s:%s",
+                    omb_reduce_dtype_name(dtypes[i]),
+                    omb_reduce_op_name(ops[i]));
+            fprintf(stdout, "%*s", FIELD_WIDTH, name);
+        }
+        fprintf(stdout, "\n");
+        fflush(stdout);
+    }
+
+    for (size = options.min_message_size; size * unit <=
+            options.max_message_size; size *= 2) {
+        if (0 == rank) {
+            fprintf(stdout, "%-*zu", 10, size * unit);
+        }
+        for (i = 0; i < ncombos; i++) {
+            options.reduce_dtype = dtypes[i];
+            options.reduce_op = ops[i];
+            omb_reduction_get(&datatype, &mpi_op, &elem_size);
+            count = size * unit / elem_size;
+            latency = count ? run(comm, count, arg) : -1.0;
+            if (0 == rank) {
+                if (latency < 0) {
+                    fprintf(stdout, "%*s", FIELD_WIDTH, "-");
+                } else {
+                    fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION,
+                            latency);
+                }
+            }
+        }
+        if (0 == rank) {
+            fprintf(stdout, "\n");
+            fflush(stdout);
+        }
+    }
+    omb_reduction_free();
+
+    return 0;
+}
+
+void omb_inplace_seed(void *dst, void *src, size_t size)
+{
+#ifdef _ENABLE_OPENACC_
+    size_t i;
+    char *d = (char *)dst, *s = (char *)src;
+#endif
+
+    if (!options.in_place) {
+        return;
+    }
+    switch (options.accel) {
+        case NONE:
+            memcpy(dst, src, size);
+            break;
+        case CUDA:
+        case MANAGED:
+#ifdef _ENABLE_CUDA_
+            CUDA_CHECK(cudaMemcpy(dst, src, size, cudaMemcpyDefault));
+            CUDA_CHECK(cudaDeviceSynchronize());
+#endif
+            break;
+        case OPENACC:
+#ifdef _ENABLE_OPENACC_
+            #pragma acc parallel loop deviceptr(d, s)
+            for (i = 0; i < size; i++) {
+                d[i] = s[i];
+            }
+#endif
+            break;
+        case ROCM:
+#ifdef _ENABLE_ROCM_
+            ROCM_CHECK(hipMemcpy(dst, src, size, hipMemcpyDeviceToDevice));
+            ROCM_CHECK(hipDeviceSynchronize());
+#endif
+            break;
+        default:
+            break;
+    }
+}
+
+void omb_inplace_footprint(size_t saved, MPI_Comm comm)
+{
+    unsigned long long local = saved;
+
+    if (!options.in_place) {
+        return;
+    }
+    MPI_CHECK(MPI_Reduce(&local, &omb_inplace_saved[0], 1,
+                MPI_UNSIGNED_LONG_LONG, MPI_MAX, 0, comm));
+    MPI_CHECK(MPI_Reduce(&local, &omb_inplace_saved[1], 1,
+                MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, comm));
+}
+void omb_comm_shape_create(omb_comm_shape_t *shape)
+{
+    MPI_Comm node_comm, leader_comm;
+    int rank = 0, numprocs = 0, local_rank = 0, color = 0, active = 0;
+    int dims[2] = {0, 0};
+
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    shape->comm = MPI_COMM_WORLD;
+    shape->group = 0;
+    shape->ngroups = 1;
+    shape->nactive = numprocs;
+    if (OMB_SHAPE_WORLD == options.comm_shape) {
+        return;
+    }
+    if (OMB_SHAPE_GROUPS == options.comm_shape &&
+            options.comm_groups > numprocs) {
+        if (0 == rank) {
+            fprintf(stderr, "Error: %d groups need at least as many "
+                    "processes\n", options.comm_groups);
+        }
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_FAILURE);
+    }
+
+    MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+                MPI_INFO_NULL, &node_comm));
+    MPI_CHECK(MPI_Comm_rank(node_comm, &local_rank));
+    MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, 0 == local_rank ? 0 :
+                MPI_UNDEFINED, rank, &leader_comm));
+    MPI_CHECK(MPI_Dims_create(numprocs, 2, dims));
+    switch (options.comm_shape) {
+        case OMB_SHAPE_NODE:
+            /* Nodes are numbered by their leader's rank among the leaders */
+            if (MPI_COMM_NULL != leader_comm) {
+                MPI_CHECK(MPI_Comm_rank(leader_comm, &color));
+            }
+            MPI_CHECK(MPI_Bcast(&color, 1, MPI_INT, 0, node_comm));
+            break;
+        case OMB_SHAPE_LEADERS:
+            color = 0 == local_rank ? 0 : MPI_UNDEFINED;
+            break;
+        case OMB_SHAPE_ROW:
+            color = rank / dims[1];
+            break;
+        case OMB_SHAPE_COL:
+            color = rank % dims[1];
+            break;
+        case OMB_SHAPE_GROUPS:
+            color = (int)((long)rank * options.comm_groups / numprocs);
+            break;
+        default:
+            break;
+    }
+    MPI_CHECK(MPI_Comm_free(&node_comm));
+    if (MPI_COMM_NULL != leader_comm) {
+        MPI_CHECK(MPI_Comm_free(&leader_comm));
+    }
+
+    MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, color, rank, &shape->comm));
+    if (MPI_COMM_NULL == shape->comm) {
+        shape->comm = MPI_COMM_SELF;
+        shape->group = -1;
+    } else {
+        shape->group = color;
+        active = 1;
+    }
+    MPI_CHECK(MPI_Allreduce(&active, &shape->nactive, 1, MPI_INT, MPI_SUM,
+                MPI_COMM_WORLD));
+    MPI_CHECK(MPI_Allreduce(&shape->group, &shape->ngroups, 1, MPI_INT,
+                MPI_MAX, MPI_COMM_WORLD));
+    shape->ngroups++;
+
+    switch (options.comm_shape) {
+        case OMB_SHAPE_NODE:
+            snprintf(omb_comm_shape_desc, sizeof(omb_comm_shape_desc),
+                    "node-local, %d nodes", shape->ngroups);
+            break;
+        case OMB_SHAPE_LEADERS:
+            snprintf(omb_comm_shape_desc, sizeof(omb_comm_shape_desc),
+                    "node leaders, %d of %d ranks", shape->nactive, numprocs);
+            break;
+        case OMB_SHAPE_ROW:
+        case OMB_SHAPE_COL:
+            snprintf(omb_comm_shape_desc, sizeof(omb_comm_shape_desc),
+                    "%d %ss of a %dx%d grid", shape->ngroups,
+                    OMB_SHAPE_ROW == options.comm_shape ? "row" : "column",
+                    dims[0], dims[1]);
+            break;
+        default:
+            snprintf(omb_comm_shape_desc, sizeof(omb_comm_shape_desc),
+                    "%d disjoint groups", shape->ngroups);
+            break;
+    }
+}
+
+void omb_comm_shape_free(omb_comm_shape_t *shape)
+{
+    if (MPI_COMM_WORLD != shape->comm && MPI_COMM_SELF != shape->comm) {
+        MPI_CHECK(MPI_Comm_free(&shape->comm));
+    }
+}
+
+void omb_comm_shape_stats(omb_comm_shape_t *shape, size_t size, double latency,
+                          double *avg_time, double *min_time,
+                          double *max_time)
+{
+    double local[3], row[5], *rows = NULL;
+    int rank = 0, numprocs = 0, comm_rank = 0, comm_size = 0, i;
+    int active = shape->group >= 0;
+
+    /* Idle ranks must not move the min, max or sum */
+    local[0] = active ? latency : DBL_MAX;
+    local[1] = active ? latency : -DBL_MAX;
+    local[2] = active ? latency : 0.0;
+    MPI_CHECK(MPI_Reduce(&local[0], min_time, 1, MPI_DOUBLE, MPI_MIN, 0,
+                MPI_COMM_WORLD));
+    MPI_CHECK(MPI_Reduce(&local[1], max_time, 1, MPI_DOUBLE, MPI_MAX, 0,
+                MPI_COMM_WORLD));
+    MPI_CHECK(MPI_Reduce(&local[2], avg_time, 1, MPI_DOUBLE, MPI_SUM, 0,
+                MPI_COMM_WORLD));
+    *avg_time = *avg_time / shape->nactive;
+    omb_per_rank_stats(size, latency, active);
+    if (OMB_SHAPE_WORLD == options.comm_shape) {
+        return;
+    }
+
+    /* Each group reduces its own stats, its root forwards them to rank 0 */
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    MPI_CHECK(MPI_Comm_rank(shape->comm, &comm_rank));
+    MPI_CHECK(MPI_Comm_size(shape->comm, &comm_size));
+    MPI_CHECK(MPI_Reduce(&latency, &row[2], 1, MPI_DOUBLE, MPI_SUM, 0,
+                shape->comm));
+    MPI_CHECK(MPI_Reduce(&latency, &row[3], 1, MPI_DOUBLE, MPI_MIN, 0,
+                shape->comm));
+    MPI_CHECK(MPI_Reduce(&latency, &row[4], 1, MPI_DOUBLE, MPI_MAX, 0,
+                shape->comm));
+    row[0] = active && 0 == comm_rank ? shape->group : -1;
+    row[1] = comm_size;
+    row[2] /= comm_size;
+    if (0 == rank) {
+        rows = malloc(5 * numprocs * sizeof(double));
+    }
+    MPI_CHECK(MPI_Gather(row, 5, MPI_DOUBLE, rows, 5, MPI_DOUBLE, 0,
+                MPI_COMM_WORLD));
+    if (0 == rank) {
+        fprintf(stdout, "# Per-group latency(us) at %zu bytes: avg, min, max\n",
+                size);
+        for (i = 0; i < numprocs; i++) {
+            if (rows[5 * i] < 0) {
+                continue;
+            }
+            fprintf(stdout, "#   group %-6d%6d ranks%*.*f%*.*f%*.*f\n",
+                    (int)rows[5 * i], (int)rows[5 * i + 1], FIELD_WIDTH,
+                    FLOAT_PRECISION, rows[5 * i + 2], FIELD_WIDTH,
+                    FLOAT_PRECISION, rows[5 * i + 3], FIELD_WIDTH,
+                    FLOAT_PRECISION, rows[5 * i + 4]);
+        }
+        fflush(stdout);
+        free(rows);
+    }
+}
+
+void omb_ref_time(omb_ref_t *ref, omb_coll_args_t *args, size_t size,
+                  int *errors)
+{
+    double t_start = 0.0, timer = 0.0, latency = 0.0, sum = 0.0;
+    void *recvbuf = args->recvbuf, *checkbuf = args->recvbuf;
+    int i, rank = 0, numprocs = 0;
+
+    MPI_CHECK(MPI_Comm_rank(args->comm, &rank));
+    MPI_CHECK(MPI_Comm_size(args->comm, &numprocs));
+    /* Bcast is checked in its only buffer, reduce only at the root */
+    if (OMB_COLL_BCAST == args->type) {
+        recvbuf = NULL;
+        checkbuf = args->sendbuf;
+    } else if (OMB_COLL_REDUCE == args->type && args->root != rank) {
+        recvbuf = checkbuf = NULL;
+    }
+
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        if (options.validate) {
+            set_buffer_validation(args->sendbuf, recvbuf, size, options.accel,
+                    i);
+        }
+        MPI_CHECK(MPI_Barrier(args->comm));
+        t_start = MPI_Wtime();
+        MPI_CHECK(omb_ref_call(ref, args));
+        if (i >= options.skip) {
+            timer += MPI_Wtime() - t_start;
+        }
+        if (options.validate && NULL != checkbuf) {
+            *errors += validate_data(checkbuf, size, numprocs, options.accel,
+                    i);
+        }
+    }
+
+    latency = timer * 1e6 / options.iterations;
+    MPI_CHECK(MPI_Reduce(&latency, &sum, 1, MPI_DOUBLE, MPI_SUM, 0,
+                args->comm));
+    omb_ref_latency = sum / numprocs;
+}
+
+void omb_throughput_time(omb_coll_args_t *args)
+{
+    double t_start = 0.0, elapsed = 0.0, max_elapsed = 0.0;
+    void *sendbuf = args->sendbuf, *recvbuf = args->recvbuf, *tmp = NULL;
+    MPI_Op op = args->op;
+    MPI_Datatype datatype;
+    size_t unit;
+    int i, rank = 0, chain = 0, reduce_op = options.reduce_op;
+
+    if (!options.throughput) {
+        return;
+    }
+    /* In place, the result already is the next call's input */
+    chain = OMB_THROUGHPUT_CHAIN == options.throughput &&
+        MPI_IN_PLACE != args->sendbuf;
+    /* A chained sum grows every call until it overflows, a max stays put */
+    if (OMB_THROUGHPUT_CHAIN == options.throughput &&
+            OMB_COLL_ALLREDUCE == args->type && OMB_OP_SUM == reduce_op) {
+        options.reduce_op = OMB_OP_MAX;
+        omb_reduction_get(&datatype, &args->op, &unit);
+        options.reduce_op = reduce_op;
+    }
+
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        if (i == options.skip) {
+            MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+            t_start = MPI_Wtime();
+        }
+        MPI_CHECK(omb_coll_call(args, OMB_CALL_BLOCKING, NULL));
+        if (chain) {
+            tmp = args->sendbuf;
+            args->sendbuf = args->recvbuf;
+            args->recvbuf = tmp;
+        }
+    }
+    elapsed = MPI_Wtime() - t_start;
+    args->sendbuf = sendbuf;
+    args->recvbuf = recvbuf;
+    args->op = op;
+
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0,
+                MPI_COMM_WORLD));
+    if (0 == rank) {
+        omb_throughput_stats[0] = max_elapsed * 1e6 / options.iterations;
+        omb_throughput_stats[1] = options.iterations / max_elapsed;
+    }
+}
+
+/*
+ * One row of omb_inflight_run(): nops calls already set up in ops, keyed by
+ * the bytes of one call (the largest of a fixed list) and the batch total
+ */
+static void omb_inflight_row(omb_coll_args_t *ops, int nops, size_t bytes,
+                             size_t total, MPI_Comm comm)
+{
+    MPI_Request requests[OMB_INFLIGHT_MAX_OPS];
+    double local[2 * OMB_INFLIGHT_MAX_OPS + 1];
+    double sum[2 * OMB_INFLIGHT_MAX_OPS + 1], max[2 * OMB_INFLIGHT_MAX_OPS + 1];
+    double t_start = 0.0;
+    int i, j, index, flag, done, rank = 0, numprocs = 0, nvals = 2 * nops + 1;
+
+    MPI_CHECK(MPI_Comm_rank(comm, &rank));
+    MPI_CHECK(MPI_Comm_size(comm, &numprocs));
+    memset(local, 0, sizeof(local));
+
+    /* local[0] is the batch time, then per call latency and order */
+    for (i = 0; i < options.iterations + options.skip; i++) {
+        MPI_CHECK(MPI_Barrier(comm));
+        t_start = MPI_Wtime();
+        for (j = 0; j < nops; j++) {
+            MPI_CHECK(omb_coll_call(&ops[j], OMB_CALL_NONBLOCKING,
+                        &requests[j]));
+        }
+        if (options.in_flight_testany) {
+            for (done = 0; done < nops;) {
+                MPI_CHECK(MPI_Testany(nops, requests, &index, &flag,
+                            MPI_STATUS_IGNORE));
+                if (!flag || MPI_UNDEFINED == index) {
+                    continue;
+                }
+                if (i >= options.skip) {
+                    local[1 + index] += MPI_Wtime() - t_start;
+                    local[1 + nops + index] += done + 1;
+                }
+                done++;
+            }
+        } else {
+            MPI_CHECK(MPI_Waitall(nops, requests, MPI_STATUSES_IGNORE));
+        }
+        if (i >= options.skip) {
+            local[0] += MPI_Wtime() - t_start;
+        }
+    }
+
+    for (j = 0; j < nvals; j++) {
+        local[j] /= options.iterations;
+        if (j <= nops) {
+            local[j] *= 1e6;
+        }
+    }
+    MPI_CHECK(MPI_Reduce(local, sum, nvals, MPI_DOUBLE, MPI_SUM, 0, comm));
+    MPI_CHECK(MPI_Reduce(local, max, nvals, MPI_DOUBLE, MPI_MAX, 0, comm));
+    if (0 != rank) {
+        return;
+    }
+
+    fprintf(stdout, "%-*zu%*zu%*.*f%*.*f%*.*f%*.*f\n", 10, bytes, FIELD_WIDTH,
+            total, FIELD_WIDTH, FLOAT_PRECISION, sum[0] / numprocs,
+            FIELD_WIDTH, FLOAT_PRECISION, max[0], FIELD_WIDTH,
+            FLOAT_PRECISION, nops * 1e6 / max[0], FIELD_WIDTH,
+            FLOAT_PRECISION, total / max[0]);
+    if (options.in_flight_testany) {
+        for (j = 0; j < nops; j++) {
+            fprintf(stdout, "#   call %-4d%10d elements comm %-4d%*.*f%*.*f"
+                    "%*.*f\n", j, ops[j].sendcount,
+                    j % options.in_flight_comms, FIELD_WIDTH,
+                    FLOAT_PRECISION, sum[1 + nops + j] / numprocs,
+                    FIELD_WIDTH, FLOAT_PRECISION, sum[1 + j] / numprocs,
+                    FIELD_WIDTH, FLOAT_PRECISION, max[1 + j]);
+        }
+    }
+    fflush(stdout);
+}
+
+int omb_inflight_run(omb_coll_args_t *args, size_t unit)
+{
+    omb_coll_args_t ops[OMB_INFLIGHT_MAX_OPS];
+    MPI_Comm comms[OMB_INFLIGHT_MAX_OPS];
+    char *sendbuf = NULL, *recvbuf = NULL;
+    size_t size, bytes, offset, bufsize = 0;
+    int j, rank = 0, nops = options.in_flight;
+
+    if (omb_coll_count_check(unit)) {
+        return 1;
+    }
+    MPI_CHECK(MPI_Comm_rank(args->comm, &rank));
+    for (j = 0; j < nops; j++) {
+        bufsize += options.in_flight_fixed ? options.in_flight_sizes[j] +
+            unit : options.max_message_size;
+    }
+    if (allocate_memory_coll((void **)&sendbuf, bufsize, options.accel) ||
+            allocate_memory_coll((void **)&recvbuf, bufsize, options.accel)) {
+        fprintf(stderr, "Could Not Allocate Memory [rank %d]\n", rank);
+        MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+    }
+    set_buffer(sendbuf, options.accel, 1, bufsize);
+    set_buffer(recvbuf, options.accel, 0, bufsize);
+    for (j = 0; j < options.in_flight_comms; j++) {
+        comms[j] = args->comm;
+        if (options.in_flight_comms > 1) {
+            MPI_CHECK(MPI_Comm_dup(args->comm, &comms[j]));
+        }
+    }
+    for (j = 0; j < nops; j++) {
+        ops[j] = *args;
+        ops[j].comm = comms[j % options.in_flight_comms];
+    }
+
+    if (0 == rank) {
+        fprintf(stdout, "\n");
+        switch (options.accel) {
+            case CUDA:
+                printf(benchmark_header, "-CUDA");
+                break;
+            case OPENACC:
+                printf(benchmark_header, "-OPENACC");
+                break;
+            case MANAGED:
+                printf(benchmark_header, "-MANAGED");
+                break;
+            case ROCM:
+                printf(benchmark_header, "-ROCM");
+                break;
+            default:
+                printf(benchmark_header, "");
+                break;
+        }
+        fprintf(stdout, "# In-flight: %d calls on %d communicator%s, "
+                "completed with %s\n", nops, options.in_flight_comms,
+                options.in_flight_comms > 1 ? "s" : "",
+                options.in_flight_testany ? "MPI_Testany" : "MPI_Waitall");
+        if (options.in_flight_testany) {
+            fprintf(stdout, "# Per call: completion order from 1, average "
+                    "and max latency (us) from the first post\n");
+        }
+        fprintf(stdout, "%-*s%*s%*s%*s%*s%*s\n", 10, "# Bytes", FIELD_WIDTH,
+                "Batch Bytes", FIELD_WIDTH, "Avg Batch(us)", FIELD_WIDTH,
+                "Max Batch(us)", FIELD_WIDTH, "Ops/s", FIELD_WIDTH,
+                "Bandwidth (MB/s)");
+        fflush(stdout);
+    }
+
+    if (options.in_flight_fixed) {
+        for (j = 0, offset = 0, size = 0; j < nops; j++) {
+            ops[j].sendcount = ops[j].recvcount =
+                options.in_flight_sizes[j] < unit ? 1 :
+                options.in_flight_sizes[j] / unit;
+            ops[j].sendbuf = sendbuf + offset;
+            ops[j].recvbuf = recvbuf + offset;
+            offset += ops[j].sendcount * unit;
+            size = MAX(size, ops[j].sendcount * unit);
+        }
+        if (size > LARGE_MESSAGE_SIZE) {
+            options.skip = options.skip_large;
+            options.iterations = options.iterations_large;
+        }
+        omb_inflight_row(ops, nops, size, offset, args->comm);
+    } else {
+        for (size = options.min_message_size; size * unit <=
+                options.max_message_size; size *= 2) {
+            bytes = size * unit;
+            if (bytes > LARGE_MESSAGE_SIZE) {
+                options.skip = options.skip_large;
+                options.iterations = options.iterations_large;
+            }
+            for (j = 0; j < nops; j++) {
+                ops[j].sendcount = ops[j].recvcount = (int)size;
+                ops[j].sendbuf = sendbuf + j * bytes;
+                ops[j].recvbuf = recvbuf + j * bytes;
+            }
+            omb_inflight_row(ops, nops, bytes, nops * bytes, args->comm);
+        }
+    }
+
+    for (j = 0; j < options.in_flight_comms && options.in_flight_comms > 1;
+            j++) {
+        MPI_CHECK(MPI_Comm_free(&comms[j]));
+    }
+    free_buffer(sendbuf, options.accel);
+    free_buffer(recvbuf, options.accel);
+
+    return 0;
+}
+
+typedef struct omb_per_rank_entry {
+    double latency;
+    int index;
+} omb_per_rank_entry_t;
+
+/* Slowest first, then by index */
+static int omb_per_rank_compare(const void *a, const void *b)
+{
+    const omb_per_rank_entry_t *x = a, *y = b;
+
+    if (x->latency != y->latency) {
+        return x->latency < y->latency ? 1 : -1;
+    }
+    return x->index - y->index;
+}
+
+/* Hosts of all ranks on rank 0, numbered in order of first appearance */
+static void omb_per_rank_init(int rank, int numprocs)
+{
+    char host[MPI_MAX_PROCESSOR_NAME];
+    int len = 0, i, j;
+
+    memset(host, 0, sizeof(host));
+    MPI_CHECK(MPI_Get_processor_name(host, &len));
+    if (0 == rank) {
+        omb_per_rank.hosts = malloc(numprocs * MPI_MAX_PROCESSOR_NAME);
+        omb_per_rank.nodes = malloc(numprocs * sizeof(int));
+        omb_per_rank.first = malloc(numprocs * sizeof(int));
+        OMB_CHECK_NULL_AND_EXIT(omb_per_rank.hosts,
+                "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(omb_per_rank.nodes,
+                "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(omb_per_rank.first,
+                "Unable to allocate memory");
+    }
+    MPI_CHECK(MPI_Gather(host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                omb_per_rank.hosts, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, 0,
+                MPI_COMM_WORLD));
+    omb_per_rank.init = 1;
+    if (0 != rank) {
+        return;
+    }
+    for (i = 0; i < numprocs; i++) {
+        for (j = 0; j < i && strcmp(omb_per_rank.hosts + i *
+                    MPI_MAX_PROCESSOR_NAME, omb_per_rank.hosts + j *
+                    MPI_MAX_PROCESSOR_NAME); j++);
+        if (j < i) {
+            omb_per_rank.nodes[i] = omb_per_rank.nodes[j];
+        } else {
+            omb_per_rank.first[omb_per_rank.nnodes] = i;
+            omb_per_rank.nodes[i] = omb_per_rank.nnodes++;
+        }
+    }
+}
+
+static void omb_per_rank_dump(size_t size, double *latency, int numprocs)
+{
+    FILE *fp = NULL;
+    int i;
+
+    fp = fopen(options.per_rank_file, omb_per_rank.dumped ? "a" : "w");
+    if (NULL == fp) {
+        fprintf(stderr, "Unable to open per-rank file %s\n",
+                options.per_rank_file);
+        return;
+    }
+    if (!omb_per_rank.dumped) {
+        fprintf(fp, "size,rank,host,node,latency_us\n");
+        omb_per_rank.dumped = 1;
+    }
+    for (i = 0; i < numprocs; i++) {
+        if (latency[i] >= 0.0) {
+            fprintf(fp, "%zu,%d,%s,%d,%.*f\n", size, i, omb_per_rank.hosts +
+                    i * MPI_MAX_PROCESSOR_NAME, omb_per_rank.nodes[i],
+                    FLOAT_PRECISION, latency[i]);
+        }
+    }
+    fclose(fp);
+}
+
+void omb_per_rank_stats(size_t size, double latency, int active)
+{
+    omb_per_rank_entry_t *ranks = NULL, *nodes = NULL;
+    double *latencies = NULL, *sorted = NULL, *node_max = NULL;
+    double value = active ? latency : -1.0, median;
+    int rank = 0, numprocs = 0, nactive = 0, *node_ranks = NULL, i, n;
+
+    if (!options.per_rank) {
+        return;
+    }
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    if (!omb_per_rank.init) {
+        omb_per_rank_init(rank, numprocs);
+    }
+    if (0 == rank) {
+        latencies = malloc(numprocs * sizeof(double));
+        OMB_CHECK_NULL_AND_EXIT(latencies, "Unable to allocate memory");
+    }
+    MPI_CHECK(MPI_Gather(&value, 1, MPI_DOUBLE, latencies, 1, MPI_DOUBLE, 0,
+                MPI_COMM_WORLD));
+    if (0 != rank) {
+        return;
+    }
+
+    ranks = malloc(numprocs * sizeof(omb_per_rank_entry_t));
+    sorted = malloc(numprocs * sizeof(double));
+    nodes = calloc(omb_per_rank.nnodes, sizeof(omb_per_rank_entry_t));
+    node_max = calloc(omb_per_rank.nnodes, sizeof(double));
+    node_ranks = calloc(omb_per_rank.nnodes, sizeof(int));
+    OMB_CHECK_NULL_AND_EXIT(ranks, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(sorted, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(nodes, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(node_max, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(node_ranks, "Unable to allocate memory");
+
+    for (i = 0; i < omb_per_rank.nnodes; i++) {
+        nodes[i].index = i;
+    }
+    for (i = 0; i < numprocs; i++) {
+        if (latencies[i] < 0.0) {
+            continue;
+        }
+        n = omb_per_rank.nodes[i];
+        ranks[nactive].latency = sorted[nactive] = latencies[i];
+        ranks[nactive++].index = i;
+        nodes[n].latency += latencies[i];
+        node_max[n] = MAX(node_max[n], latencies[i]);
+        node_ranks[n]++;
+    }
+    for (i = 0; i < omb_per_rank.nnodes; i++) {
+        nodes[i].latency = node_ranks[i] ? nodes[i].latency / node_ranks[i] :
+            -1.0;
+    }
+    qsort(sorted, nactive, sizeof(double), omb_compare_double);
+    qsort(ranks, nactive, sizeof(omb_per_rank_entry_t),
+            omb_per_rank_compare);
+    qsort(nodes, omb_per_rank.nnodes, sizeof(omb_per_rank_entry_t),
+            omb_per_rank_compare);
+    median = omb_percentile(sorted, nactive, 50.0);
+
+    fprintf(stdout, "# Slowest %d of %d ranks at %zu bytes: latency(us) and "
+            "ratio to the median %.*f\n", MIN(options.per_rank, nactive),
+            nactive, size, FLOAT_PRECISION, median);
+    for (i = 0; i < MIN(options.per_rank, nactive); i++) {
+        fprintf(stdout, "#   rank %-8d%-24s%*.*f%*.2f\n", ranks[i].index,
+                omb_per_rank.hosts + ranks[i].index * MPI_MAX_PROCESSOR_NAME,
+                FIELD_WIDTH, FLOAT_PRECISION, ranks[i].latency, 10,
+                median > 0.0 ? ranks[i].latency / median : 0.0);
+    }
+    for (n = 0; n < omb_per_rank.nnodes && nodes[n].latency >= 0.0; n++);
+    fprintf(stdout, "# Slowest %d of %d nodes at %zu bytes: ranks, avg and "
+            "max latency(us)\n", MIN(options.per_rank, n), n, size);
+    for (i = 0; i < MIN(options.per_rank, n); i++) {
+        fprintf(stdout, "#   %-32s%6d ranks%*.*f%*.*f\n",
+                omb_per_rank.hosts + omb_per_rank.first[nodes[i].index] *
+                MPI_MAX_PROCESSOR_NAME, node_ranks[nodes[i].index],
+                FIELD_WIDTH, FLOAT_PRECISION, nodes[i].latency, FIELD_WIDTH,
+                FLOAT_PRECISION, node_max[nodes[i].index]);
+    }
+    fflush(stdout);
+    if ('\0' != options.per_rank_file[0]) {
+        omb_per_rank_dump(size, latencies, numprocs);
+    }
+
+    free(latencies);
+    free(ranks);
+    free(sorted);
+    free(nodes);
+    free(node_max);
+    free(node_ranks);
+}
+
+/* The next splitmix64 draw of state, uniform in [0, 1) */
+static double omb_vcounts_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+
+    return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Read whitespace separated weights on rank 0, skipping lines that start
+ * with '#', and broadcast them. A per-rank distribution takes numprocs
+ * weights or a numprocs by numprocs matrix, whose row sums it uses.
+ */
+static int omb_vcounts_file(double *weights, int nblocks, MPI_Comm comm)
+{
+    FILE *fp = NULL;
+    char line[OMB_DDT_FILE_LINE_MAX_LENGTH], *token, *end;
+    int n = 0, i, j, p = omb_vcounts.numprocs, max = p * p;
+    double *values = malloc(max * sizeof(double));
+
+    OMB_CHECK_NULL_AND_EXIT(values, "Unable to allocate memory");
+    if (0 == omb_vcounts.rank) {
+        fp = fopen(options.vcounts_file, "r");
+        if (NULL == fp) {
+            fprintf(stderr, "Unable to open counts file %s\n",
+                    options.vcounts_file);
+            n = -1;
+        }
+        while (NULL != fp && n >= 0 &&
+                fgets(line, OMB_DDT_FILE_LINE_MAX_LENGTH, fp)) {
+            if ('#' == line[0]) {
+                continue;
+            }
+            for (token = strtok(line, " \t\r\n"); NULL != token && n >= 0;
+                    token = strtok(NULL, " \t\r\n")) {
+                if (n == max) {
+                    n = -1;
+                    break;
+                }
+                values[n] = strtod(token, &end);
+                n = (end == token || '\0' != *end || values[n] < 0.0) ?
+                    -1 : n + 1;
+            }
+        }
+        if (NULL != fp) {
+            fclose(fp);
+        }
+        if (n >= 0 && n != max && (omb_vcounts.matrix || n != p)) {
+            n = -1;
+        }
+        if (n < 0 && NULL != fp) {
+            fprintf(stderr, "%s needs %d non-negative weights%s\n",
+                    options.vcounts_file, nblocks, omb_vcounts.matrix ? "" :
+                    " or a matrix of them");
+        }
+    }
+    MPI_CHECK(MPI_Bcast(&n, 1, MPI_INT, 0, comm));
+    if (n < 0) {
+        free(values);
+        return 1;
+    }
+    MPI_CHECK(MPI_Bcast(values, n, MPI_DOUBLE, 0, comm));
+
+    for (i = 0; i < nblocks; i++) {
+        weights[i] = values[i];
+        if (n > nblocks) {
+            for (weights[i] = 0.0, j = 0; j < p; j++) {
+                weights[i] += values[i * p + j];
+            }
+        }
+    }
+    free(values);
+    return 0;
+}
+
+void omb_vcounts_init(MPI_Comm comm)
+{
+    uint64_t state = 1;
+    double sum = 0.0;
+    int *order = NULL, nblocks, heavy, tmp, i, j;
+
+    if (!options.vcounts) {
+        return;
+    }
+    MPI_CHECK(MPI_Comm_rank(comm, &omb_vcounts.rank));
+    MPI_CHECK(MPI_Comm_size(comm, &omb_vcounts.numprocs));
+    omb_vcounts.matrix = ALLTOALL == options.subtype;
+    nblocks = omb_vcounts.numprocs * (omb_vcounts.matrix ?
+            omb_vcounts.numprocs : 1);
+    omb_vcounts.weights = malloc(nblocks * sizeof(double));
+    order = malloc(nblocks * sizeof(int));
+    for (i = 0; i < 2; i++) {
+        omb_vcounts.counts[i] = malloc(omb_vcounts.numprocs * sizeof(int));
+        omb_vcounts.displs[i] = malloc(omb_vcounts.numprocs * sizeof(int));
+        OMB_CHECK_NULL_AND_EXIT(omb_vcounts.counts[i],
+                "Unable to allocate memory");
+        OMB_CHECK_NULL_AND_EXIT(omb_vcounts.displs[i],
+                "Unable to allocate memory");
+    }
+    OMB_CHECK_NULL_AND_EXIT(omb_vcounts.weights, "Unable to allocate memory");
+    OMB_CHECK_NULL_AND_EXIT(order, "Unable to allocate memory");
+
+    /* Zipf ranks and sparse holes land on a shuffled order of the blocks */
+    for (i = 0; i < nblocks; i++) {
+        order[i] = i;
+    }
+    for (i = nblocks - 1; i > 0; i--) {
+        j = (int)(omb_vcounts_random(&state) * (i + 1));
+        tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    heavy = omb_vcounts.numprocs - 1;
+    for (i = 0; i < nblocks; i++) {
+        switch (options.vcounts) {
+            case OMB_VCOUNTS_UNIFORM:
+                omb_vcounts.weights[i] = omb_vcounts_random(&state);
+                break;
+            case OMB_VCOUNTS_ZIPF:
+                omb_vcounts.weights[i] = pow(order[i] + 1,
+                        -options.vcounts_param);
+                break;
+            case OMB_VCOUNTS_SPARSE:
+                omb_vcounts.weights[i] = order[i] < options.vcounts_param *
+                    nblocks ? 0.0 : 1.0;
+                break;
+            case OMB_VCOUNTS_HEAVY:
+                omb_vcounts.weights[i] = (omb_vcounts.matrix ?
+                        i / omb_vcounts.numprocs == heavy ||
+                        i % omb_vcounts.numprocs == heavy : i == heavy) ?
+                    options.vcounts_param : 1.0;
+                break;
+            default:
+                break;
+        }
+    }
+    free(order);
+    if (OMB_VCOUNTS_FILE == options.vcounts &&
+            omb_vcounts_file(omb_vcounts.weights, nblocks, comm)) {
+        MPI_CHECK(MPI_Abort(comm, EXIT_FAILURE));
+    }
+
+    for (i = 0; i < nblocks; i++) {
+        sum += omb_vcounts.weights[i];
+    }
+    if (sum <= 0.0) {
+        if (0 == omb_vcounts.rank) {
+            fprintf(stderr, "Every block of the count distribution is "
+                    "empty\n");
+        }
+        MPI_CHECK(MPI_Abort(comm, EXIT_FAILURE));
+    }
+    for (i = 0; i < nblocks; i++) {
+        omb_vcounts.weights[i] *= nblocks / sum;
+    }
+}
+
+/* Block from src to dst, or of src alone for the per-rank distributions */
+static int omb_vcounts_count(int src, int dst, size_t size)
+{
+    int block = omb_vcounts.matrix ? src * omb_vcounts.numprocs + dst : src;
+
+    return (int)(omb_vcounts.weights[block] * size + 0.5);
+}
+
+size_t omb_vcounts_bufsize(size_t size)
+{
+    size_t total = 0, row, col, max = 0;
+    int i, j;
+
+    if (!options.vcounts) {
+        return 0;
+    }
+    for (i = 0; i < omb_vcounts.numprocs; i++) {
+        for (row = col = 0, j = 0; j < omb_vcounts.numprocs; j++) {
+            row += omb_vcounts_count(i, j, size);
+            col += omb_vcounts_count(j, i, size);
+        }
+        max = MAX(max, MAX(row, col));
+        total += omb_vcounts_count(i, 0, size);
+    }
+
+    return omb_vcounts.matrix ? max : total;
+}
+
+int omb_vcounts_fill(size_t size, int *sendcounts, int *sdispls,
+                     int *recvcounts, int *rdispls)
+{
+    double load, max = 0.0, sum = 0.0;
+    int i, j, p = omb_vcounts.numprocs, rank = omb_vcounts.rank;
+
+    if (!options.vcounts) {
+        return (int)size;
+    }
+    for (i = 0; i < p; i++) {
+        omb_vcounts.counts[0][i] = omb_vcounts.matrix ?
+            omb_vcounts_count(rank, i, size) : omb_vcounts_count(i, 0, size);
+        omb_vcounts.counts[1][i] = omb_vcounts.matrix ?
+            omb_vcounts_count(i, rank, size) : omb_vcounts.counts[0][i];
+        for (j = 0; j < 2; j++) {
+            omb_vcounts.displs[j][i] = i ? omb_vcounts.displs[j][i - 1] +
+                omb_vcounts.counts[j][i - 1] : 0;
+        }
+        if (NULL != sendcounts) {
+            sendcounts[i] = omb_vcounts.counts[0][i];
+            sdispls[i] = omb_vcounts.displs[0][i];
+        }
+        if (NULL != recvcounts) {
+            recvcounts[i] = omb_vcounts.counts[1][i];
+            rdispls[i] = omb_vcounts.displs[1][i];
+        }
+
+        /* A rank's load is what it sends and receives, or its own block */
+        for (load = 0.0, j = 0; j < p && omb_vcounts.matrix; j++) {
+            load += omb_vcounts_count(i, j, size) +
+                omb_vcounts_count(j, i, size);
+        }
+        load = omb_vcounts.matrix ? load : omb_vcounts_count(i, 0, size);
+        max = MAX(max, load);
+        sum += load;
+    }
+    omb_vcounts.imbalance = sum > 0.0 ? max * p / sum : 0.0;
+
+    return omb_vcounts.counts[0][rank];
+}
+
+/* Byte k of the block from src to dst in call iter */
+static char omb_vcounts_value(int src, int dst, int k, int iter)
+{
+    return (char)((src * 31 + dst * 7 + k * 3 + iter) % 256);
+}
+
+/*
+ * Alltoallv sends a block to every rank, scatterv's root one to each rank,
+ * and the gathers send one block of their own; the receive side is the
+ * mirror image. Host buffers only, which -y enforces with -c. Ranks that
+ * receive nothing, like the non-roots of gatherv, pass a NULL r_buf.
+ */
+void omb_vcounts_set_buffer(void *s_buf, void *r_buf, int iter)
+{
+    char *s = (char *)s_buf;
+    int i, k, p = omb_vcounts.numprocs, rank = omb_vcounts.rank;
+
+    if (ALLTOALL == options.subtype ||
+            (SCATTER == options.subtype && 0 == rank)) {
+        for (i = 0; i < p; i++) {
+            for (k = 0; k < omb_vcounts.counts[0][i]; k++) {
+                s[omb_vcounts.displs[0][i] + k] = omb_vcounts_value(rank, i,
+                        k, iter);
+            }
+        }
+    } else if (SCATTER != options.subtype) {
+        for (k = 0; k < omb_vcounts.counts[0][rank]; k++) {
+            s[k] = omb_vcounts_value(rank, 0, k, iter);
+        }
+    }
+    if (NULL != r_buf) {
+        memset(r_buf, 0, SCATTER == options.subtype ?
+                omb_vcounts.counts[1][rank] : omb_vcounts.displs[1][p - 1] +
+                omb_vcounts.counts[1][p - 1]);
+    }
+}
+
+int omb_vcounts_validate(void *r_buf, int iter)
+{
+    char *r = (char *)r_buf;
+    int i, k, p = omb_vcounts.numprocs, rank = omb_vcounts.rank;
+
+    if (SCATTER == options.subtype) {
+        for (k = 0; k < omb_vcounts.counts[1][rank]; k++) {
+            if (r[k] != omb_vcounts_value(0, rank, k, iter)) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    for (i = 0; i < p; i++) {
+        for (k = 0; k < omb_vcounts.counts[1][i]; k++) {
+            if (r[omb_vcounts.displs[1][i] + k] != omb_vcounts_value(i,
+                        ALLTOALL == options.subtype ? rank : 0, k, iter)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+void omb_vcounts_free(void)
+{
+    int i;
+
+    if (!options.vcounts) {
+        return;
+    }
+    for (i = 0; i < 2; i++) {
+        free(omb_vcounts.counts[i]);
+        free(omb_vcounts.displs[i]);
+    }
+    free(omb_vcounts.weights);
+}
+
+/* splitmix64 of the call and the rank, uniform in [0, 1) */
+static double omb_skew_random(int rank, int stream)
+{
+    uint64_t z = omb_skew.epoch * 0x9E3779B97F4A7C15ULL +
+        ((uint64_t)rank << 1 | stream) + 1;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+
+    return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Delay of rank in the current call, in seconds */
+static double omb_skew_delay_of(int rank, int numprocs)
+{
+    double us = 0.0;
+
+    switch (options.skew) {
+        case OMB_SKEW_LATE:
+            us = numprocs - 1 == rank ? options.skew_us : 0.0;
+            break;
+        case OMB_SKEW_RAMP:
+            us = options.skew_us * rank / (numprocs - 1);
+            break;
+        case OMB_SKEW_UNIFORM:
+            us = options.skew_us * omb_skew_random(rank, 0);
+            break;
+        case OMB_SKEW_EXP:
+            us = -options.skew_us * log(1.0 - omb_skew_random(rank, 0));
+            break;
+        case OMB_SKEW_NORMAL:
+            us = options.skew_us + options.skew_sd *
+                sqrt(-2.0 * log(1.0 - omb_skew_random(rank, 0))) *
+                cos(2.0 * M_PI * omb_skew_random(rank, 1));
+            break;
+        default:
+            break;
+    }
+
+    return MAX(0.0, us) * 1e-6;
+}
+
+void omb_skew_delay(void)
+{
+    double delay, earliest = DBL_MAX;
+    int i, rank = 0, numprocs = 0;
+
+    if (!options.skew) {
+        return;
+    }
+    omb_skew.release = MPI_Wtime();
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    omb_skew.latest = 0.0;
+    for (i = 0; i < numprocs; i++) {
+        delay = omb_skew_delay_of(i, numprocs);
+        earliest = MIN(earliest, delay);
+        omb_skew.latest = MAX(omb_skew.latest, delay);
+        if (i == rank) {
+            omb_skew.delay = delay;
+        }
+    }
+    omb_skew.spread = omb_skew.latest - earliest;
+    omb_skew.epoch++;
+    while (MPI_Wtime() - omb_skew.release < omb_skew.delay);
+}
+
+void omb_skew_record(int iteration, double t_stop)
+{
+    double busy;
+
+    if (!options.skew || iteration < options.skip) {
+        return;
+    }
+    /* Time inside the collective before the last rank arrived */
+    busy = t_stop - omb_skew.release - omb_skew.delay;
+    omb_skew.sums[0] += omb_skew.spread;
+    omb_skew.sums[1] += t_stop - omb_skew.release;
+    omb_skew.sums[2] += MAX(0.0, MIN(busy, omb_skew.latest - omb_skew.delay));
+    omb_skew.count++;
+}
+
+/*
+ * The completion time is the slowest rank's; the skew is the same on every
+ * rank and the wait is averaged over ranks.
+ */
+void omb_skew_stats(void)
+{
+    double local[3], completion = 0.0, wait = 0.0;
+    int i, numprocs = 0;
+
+    if (!options.skew) {
+        return;
+    }
+    MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numprocs));
+    for (i = 0; i < 3; i++) {
+        local[i] = omb_skew.count ? omb_skew.sums[i] * 1e6 / omb_skew.count :
+            0.0;
+        omb_skew.sums[i] = 0.0;
+    }
+    omb_skew.count = 0;
+    MPI_CHECK(MPI_Reduce(&local[1], &completion, 1, MPI_DOUBLE, MPI_MAX, 0,
+                MPI_COMM_WORLD));
+    MPI_CHECK(MPI_Reduce(&local[2], &wait, 1, MPI_DOUBLE, MPI_SUM, 0,
+                MPI_COMM_WORLD));
+    omb_skew.stats[0] = local[0];
+    omb_skew.stats[1] = completion;
+    omb_skew.stats[2] = wait / numprocs;
+}
 /* vi:set sw=4 sts=4 tw=80: */
@@ -12,6 +12,9 @@
 #include "osu_util.h"
 #include "osu_util_graph.h"
 #include "osu_util_papi.h"
+#include "osu_util_ipc.h"
+#include "osu_util_pvar.h"
+#include "osu_util_ref.h"
 
 #define MPI_CHECK(stmt)                                          \
 do {                                                             \
@@ -71,8 +74,8 @@ void print_help_message (int rank);
 void print_version_message (int rank);
 void print_preamble (int rank);
 void print_preamble_nbc (int rank);
-void print_stats (int rank, int size, double avg, double min, double max);
-void print_stats_validate(int rank, int size, double avg, double min,
+void print_stats (int rank, size_t size, double avg, double min, double max);
+void print_stats_validate(int rank, size_t size, double avg, double min,
                           double max, int errors);
 void print_stats_nbc (int rank, int size, double ovrl, double cpu,
                       double avg_comm, double min_comm, double max_comm,
@@ -143,11 +146,11 @@ int omb_get_local_rank();
 #define ERROR_DELTA 0.001
 uint8_t validate_data(void* r_buf, size_t size, int num_procs,
                       enum accel_type type, int iter);
-int validate_reduction(float * buffer, size_t size, int iter, int num_procs,
+int validate_reduction(void *buffer, size_t size, int iter, int num_procs,
                        enum accel_type type);
 int validate_collective(char *buffer, size_t size, int value1, int value2,
                         enum accel_type type, int itr);
-int validate_reduce_scatter(float *buffer, size_t size, int* recvcounts,
+int validate_reduce_scatter(void *buffer, size_t size, int* recvcounts,
                             int rank, int num_procs, enum accel_type type,
                             int iter);
 
@@ -162,6 +165,255 @@ void omb_ddt_free(MPI_Datatype *datatype);
 size_t omb_ddt_get_size(size_t size);
 void omb_ddt_append_stats(size_t omb_ddt_transmit_size);
 
+/*
+ * Neighborhood collectives
+ */
+int omb_neighbor_create_comm(MPI_Comm *comm, int *indegree, int *outdegree,
+                             int *max_degree);
+void omb_dist_graph_create(MPI_Comm comm_old, int indegree, int *sources,
+                           int outdegree, int *destinations, MPI_Comm *comm);
+
+/*
+ * Large count. Element counts beyond INT_MAX go through the MPI-4 "_c"
+ * bindings when available, otherwise through a derived datatype (pt2pt) or
+ * INT_MAX sized pieces (reductions).
+ */
+#define OMB_LARGE_COUNT_CHUNK (1 << 30)
+int omb_large_send(void *buf, size_t count, MPI_Datatype datatype, int dest,
+                   int tag, MPI_Comm comm);
+int omb_large_recv(void *buf, size_t count, MPI_Datatype datatype, int source,
+                   int tag, MPI_Comm comm, MPI_Status *status);
+int omb_large_isend(void *buf, size_t count, MPI_Datatype datatype, int dest,
+                    int tag, MPI_Comm comm, MPI_Request *request);
+int omb_large_irecv(void *buf, size_t count, MPI_Datatype datatype,
+                    int source, int tag, MPI_Comm comm, MPI_Request *request);
+int omb_large_allreduce(void *sendbuf, void *recvbuf, size_t count,
+                        MPI_Datatype datatype, MPI_Op op, MPI_Comm comm);
+
+/*
+ * Soak mode. Benchmarks record one sample per timed operation and call
+ * omb_soak_continue() collectively between batches; it closes intervals,
+ * prints them on rank 0 and tells every rank when the duration is over.
+ */
+#define OMB_SOAK_BASELINE_WINDOW 5
+typedef struct omb_soak {
+    int higher_is_better;
+    double t_begin;
+    double t_interval;
+    double sum;
+    double count;
+    double min;
+    double max;
+    double reference;
+    double history[OMB_SOAK_BASELINE_WINDOW];
+    int nhistory;
+    int interval;
+    int degraded;
+} omb_soak_t;
+void omb_soak_init(omb_soak_t *soak, size_t size, char const *metric,
+                   int higher_is_better, MPI_Comm comm);
+void omb_soak_record(omb_soak_t *soak, double value);
+int omb_soak_continue(omb_soak_t *soak, MPI_Comm comm);
+
+/* Data touch: write the payload before sending, read it after receiving */
+void omb_touch_produce(char *buf, size_t size, int iteration);
+void omb_touch_consume(char const *buf, size_t size);
+
+/*
+ * Collective algorithm sweep. run() times one message size (in units of unit
+ * bytes) on comm and returns the average latency in us, valid on rank 0, or a
+ * negative value on every rank if the algorithm rejected the call. comm has
+ * MPI_ERRORS_RETURN set for that purpose.
+ */
+#define OMB_SWEEP_MAX_ALGOS 32
+#define OMB_SWEEP_NAME_LEN 64
+typedef double (*omb_coll_sweep_fn)(MPI_Comm comm, size_t size, void *arg);
+int omb_coll_sweep(char const *collective, size_t unit, omb_coll_sweep_fn run,
+                   void *arg, MPI_Comm comm);
+
+/*
+ * Reduction datatypes and ops (-B/-O). omb_reduction_get() returns the MPI
+ * datatype, op and element size for options.reduce_dtype and
+ * options.reduce_op; bfloat16 travels as MPI_UINT16_T with user-defined ops.
+ * Validation buffers are host only. omb_reduction_sweep() runs every valid
+ * combination of the selected masks per size and prints a latency matrix.
+ */
+#define OMB_BFLOAT16_DELTA (1.0 / 128)
+#define OMB_REDUCE_MAX_COMBOS 35
+void omb_reduction_get(MPI_Datatype *datatype, MPI_Op *op, size_t *size);
+void omb_reduction_free(void);
+void omb_reduction_set_buffer(void *buffer, int is_send_buf, size_t count,
+                              int iter);
+int omb_reduction_validate(void *buffer, size_t count, size_t offset,
+                           int iter, int num_procs);
+int omb_reduction_sweep(size_t unit, omb_coll_sweep_fn run, void *arg,
+                        MPI_Comm comm);
+
+/*
+ * Persistent collectives (MPI-4). A benchmark describes its collective once
+ * per size in an omb_coll_args_t; omb_persistent_init() then measures the
+ * init cost and the blocking and nonblocking latencies of the same call for
+ * print_stats() and returns an inactive persistent request for the timed loop.
+ */
+#define OMB_PERSISTENT_INIT_REPS 10
+enum omb_coll_type {
+    OMB_COLL_ALLGATHER,
+    OMB_COLL_ALLGATHERV,
+    OMB_COLL_ALLREDUCE,
+    OMB_COLL_ALLTOALL,
+    OMB_COLL_ALLTOALLV,
+    OMB_COLL_ALLTOALLW,
+    OMB_COLL_BARRIER,
+    OMB_COLL_BCAST,
+    OMB_COLL_GATHER,
+    OMB_COLL_GATHERV,
+    OMB_COLL_REDUCE,
+    OMB_COLL_REDUCE_SCATTER,
+    OMB_COLL_SCATTER,
+    OMB_COLL_SCATTERV,
+    OMB_COLL_NEIGHBOR_ALLGATHER,
+    OMB_COLL_NEIGHBOR_ALLTOALL,
+    OMB_COLL_NEIGHBOR_ALLTOALLV
+};
+enum omb_coll_call {
+    OMB_CALL_BLOCKING,
+    OMB_CALL_NONBLOCKING,
+    OMB_CALL_PERSISTENT
+};
+typedef struct omb_coll_args {
+    enum omb_coll_type type;
+    void *sendbuf;
+    void *recvbuf;
+    int sendcount;
+    int recvcount;
+    MPI_Datatype sendtype;
+    MPI_Datatype recvtype;
+    int *sendcounts;
+    int *sdispls;
+    MPI_Datatype *sendtypes;
+    int *recvcounts;
+    int *rdispls;
+    MPI_Datatype *recvtypes;
+    MPI_Op op;
+    int root;
+    MPI_Comm comm;
+} omb_coll_args_t;
+void omb_coll_args_init(omb_coll_args_t *args, enum omb_coll_type type,
+                        MPI_Comm comm);
+int omb_coll_call(omb_coll_args_t *args, enum omb_coll_call call,
+                  MPI_Request *request);
+void omb_persistent_init(omb_coll_args_t *args, MPI_Request *request);
+
+/*
+ * The counts of omb_coll_args_t are int. omb_coll_count_check() returns 1 on
+ * every rank, after rank 0 has printed why, when a mode built on it would
+ * need more than INT_MAX elements of unit bytes for the sizes up to -m.
+ */
+int omb_coll_count_check(size_t unit);
+
+/*
+ * In-place collectives (-I). omb_inplace_seed() puts a rank's own
+ * contribution where MPI_IN_PLACE reads it in the receive buffer before a
+ * validated call and does nothing without -I. omb_inplace_footprint() is
+ * collective and records the buffer memory each rank no longer needs at the
+ * largest size for the preamble.
+ */
+void omb_inplace_seed(void *dst, void *src, size_t size);
+void omb_inplace_footprint(size_t saved, MPI_Comm comm);
+
+/*
+ * Communicator shapes (-K). omb_comm_shape_create() splits MPI_COMM_WORLD
+ * into the groups the collective runs on concurrently; ranks outside every
+ * group (non-leaders) run it on MPI_COMM_SELF and are left out of the stats.
+ * omb_comm_shape_stats() stands in for the min/max/avg reductions over
+ * MPI_COMM_WORLD and, for any shape but world, first prints each group.
+ */
+typedef struct omb_comm_shape {
+    MPI_Comm comm;
+    int group;
+    int ngroups;
+    int nactive;
+} omb_comm_shape_t;
+void omb_comm_shape_create(omb_comm_shape_t *shape);
+void omb_comm_shape_free(omb_comm_shape_t *shape);
+void omb_comm_shape_stats(omb_comm_shape_t *shape, size_t size, double latency,
+                          double *avg_time, double *min_time,
+                          double *max_time);
+
+/*
+ * omb_ref_time() runs the -E reference algorithm on the collective in args
+ * with the benchmark's iteration counts for the current size, validates
+ * every call with -c and adds the failures to *errors. Its latency, averaged
+ * over ranks, becomes an extra column of print_stats(). Counts are int, see
+ * omb_coll_count_check().
+ */
+void omb_ref_time(omb_ref_t *ref, omb_coll_args_t *args, size_t size,
+                  int *errors);
+
+/*
+ * Arrival skew (-J). omb_skew_delay() replaces the aligned release after the
+ * barrier with a per-rank delay, drawn the same way on every rank so each
+ * rank knows the latest arrival without communicating. omb_skew_record()
+ * charges a timed call that ended at t_stop, and omb_skew_stats() is
+ * collective and averages the calls of a size for print_stats().
+ */
+void omb_skew_delay(void);
+void omb_skew_record(int iteration, double t_stop);
+void omb_skew_stats(void);
+
+/*
+ * Throughput mode (-q). omb_throughput_time() is collective and issues the
+ * collective in args back to back for the benchmark's iterations with no
+ * barrier in between, after one aligned start. The chain variant swaps the
+ * send and receive buffers after each call so every call reduces or
+ * exchanges the previous result; a chained sum runs as a max of the same
+ * datatype, since repeated sums overflow. The batch ends with the slowest
+ * rank, whose time per call and calls per second become extra columns of
+ * print_stats().
+ */
+void omb_throughput_time(omb_coll_args_t *args);
+
+/*
+ * In-flight nonblocking collectives (-z). omb_inflight_run() replaces the
+ * benchmark's loops: per size it posts K copies of the collective in args,
+ * each on its own slice of buffers it allocates and round-robin over COMMS
+ * duplicates of args->comm, and completes them with MPI_Waitall or by
+ * polling MPI_Testany. It prints the batch time, calls per second and
+ * bandwidth and, with testany, each call's completion order and latency.
+ * Counts are in elements of unit bytes as in the benchmark's size loop.
+ * Returns 1 without running if a size needs more than INT_MAX elements.
+ */
+int omb_inflight_run(omb_coll_args_t *args, size_t unit);
+
+/*
+ * Count distributions for the v-collectives (-y). omb_vcounts_init() is
+ * collective and draws one weight per block, the same on every rank: a
+ * matrix of sender by receiver for alltoallv and one block per rank for the
+ * gather, scatter and allgather variants. The weights average 1, so
+ * omb_vcounts_fill() scales them to a mean block of size bytes, writes the
+ * non-NULL count and displacement arrays of this rank and returns its own
+ * block for the scalar count argument. omb_vcounts_bufsize() is the largest
+ * buffer any rank needs at a size. With -y, set_buffer_validation() and
+ * validate_data() follow the last filled counts. Without -y, init and fill
+ * change nothing and bufsize returns 0.
+ */
+void omb_vcounts_init(MPI_Comm comm);
+size_t omb_vcounts_bufsize(size_t size);
+int omb_vcounts_fill(size_t size, int *sendcounts, int *sdispls,
+                     int *recvcounts, int *rdispls);
+void omb_vcounts_set_buffer(void *s_buf, void *r_buf, int iter);
+int omb_vcounts_validate(void *r_buf, int iter);
+void omb_vcounts_free(void);
+
+/*
+ * Per-rank report (-U). omb_per_rank_stats() is collective and gathers every
+ * rank's latency at a size to rank 0, which prints the K slowest ranks with
+ * their hosts and the K slowest nodes, and with K:FILE appends every rank to
+ * FILE as CSV. Idle ranks pass active 0. The stats functions of the
+ * collectives call it before printing the size.
+ */
+void omb_per_rank_stats(size_t size, double latency, int active);
+
 int atomic_data_validation_setup(MPI_Datatype datatype, int jrank, void *buf, size_t buf_size);
 int atomic_data_validation_check(MPI_Datatype datatype, MPI_Op op, int jrank, void *addr, void *res, size_t buf_size, _Bool check_addr, _Bool check_result, int *validation_error_flag);
 int atomic_data_validation_print_summary();
@@ -19,6 +19,7 @@ char omb_papi_output_filename[OMB_PAPI_FILE_PATH_MAX_LENGTH];
 
 void omb_papi_init(int *papi_eventset)
 {
+    omb_pvar_init();
 #ifdef _ENABLE_PAPI_
     int papi_retval = 0, i = 0;
     omb_papi_output = fopen(omb_papi_output_filename, "w");
@@ -69,6 +70,7 @@ void omb_papi_init(int *papi_eventset)
 
 void omb_papi_start(int *papi_eventset)
 {
+    omb_pvar_start();
 #ifdef _ENABLE_PAPI_
     int papi_retval = 0;
 
@@ -84,8 +86,9 @@ void omb_papi_start(int *papi_eventset)
 #endif /*#ifdef _ENABLE_PAPI_*/
 }
 
-void omb_papi_stop_and_print(int *papi_eventset, int size)
+void omb_papi_stop_and_print(int *papi_eventset, size_t size)
 {
+    omb_pvar_stop_and_print(size);
 #ifdef _ENABLE_PAPI_
     int myid = 0, i = 0, j = 0, papi_retval = 0, numprocs = 0;
     long long *count;
@@ -107,7 +110,7 @@ void omb_papi_stop_and_print(int *papi_eventset, int size)
         exit(EXIT_FAILURE);
     }
     if (myid == 0) {
-        fprintf(omb_papi_output, "Size: %d\n", size);
+        fprintf(omb_papi_output, "Size: %zu\n", size);
         fprintf(omb_papi_output, ">>========================================"
                 "=======================>>\n");
         fprintf(omb_papi_output, "%-*s", FIELD_WIDTH, "PAPI Event Name");
@@ -140,6 +143,7 @@ void omb_papi_stop_and_print(int *papi_eventset, int size)
 
 void omb_papi_free(int *papi_eventset)
 {
+    omb_pvar_free();
 #ifdef _ENABLE_PAPI_
     if (!options.papi_enabled) {
         return;
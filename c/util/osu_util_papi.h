@@ -24,6 +24,6 @@
 
 void omb_papi_init(int *papi_eventset);
 void omb_papi_start(int *papi_eventset);
-void omb_papi_stop_and_print(int *papi_eventset, int size);
+void omb_papi_stop_and_print(int *papi_eventset, size_t size);
 void omb_papi_free(int *papi_eventset);
 void omb_papi_parse_event_options(char *opt_arr);
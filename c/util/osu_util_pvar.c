@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+
+#include <osu_util_mpi.h>
+
+static char omb_pvar_names[OMB_PVAR_NUMBER_OF_VARS][OMB_PVAR_NAME_LENGTH];
+static int omb_pvar_nov = 0;
+static int omb_pvar_list = 0;
+static MPI_T_pvar_session omb_pvar_session;
+static MPI_T_pvar_handle omb_pvar_handles[OMB_PVAR_NUMBER_OF_VARS];
+static MPI_Datatype omb_pvar_types[OMB_PVAR_NUMBER_OF_VARS];
+static int omb_pvar_counts[OMB_PVAR_NUMBER_OF_VARS];
+static int omb_pvar_deltas[OMB_PVAR_NUMBER_OF_VARS];
+static double omb_pvar_before[OMB_PVAR_NUMBER_OF_VARS];
+static MPI_Comm omb_pvar_comm;
+
+static char const *omb_pvar_class_name(int var_class)
+{
+    switch (var_class) {
+        case MPI_T_PVAR_CLASS_STATE:
+            return "state";
+        case MPI_T_PVAR_CLASS_LEVEL:
+            return "level";
+        case MPI_T_PVAR_CLASS_SIZE:
+            return "size";
+        case MPI_T_PVAR_CLASS_PERCENTAGE:
+            return "percentage";
+        case MPI_T_PVAR_CLASS_HIGHWATERMARK:
+            return "highwatermark";
+        case MPI_T_PVAR_CLASS_LOWWATERMARK:
+            return "lowwatermark";
+        case MPI_T_PVAR_CLASS_COUNTER:
+            return "counter";
+        case MPI_T_PVAR_CLASS_AGGREGATE:
+            return "aggregate";
+        case MPI_T_PVAR_CLASS_TIMER:
+            return "timer";
+        case MPI_T_PVAR_CLASS_GENERIC:
+            return "generic";
+    }
+    return "unknown";
+}
+
+static int omb_pvar_supported_type(MPI_Datatype datatype)
+{
+    return MPI_UNSIGNED == datatype || MPI_UNSIGNED_LONG == datatype ||
+        MPI_UNSIGNED_LONG_LONG == datatype || MPI_COUNT == datatype ||
+        MPI_INT == datatype || MPI_DOUBLE == datatype;
+}
+
+/* Read a pvar and return the sum of its elements */
+static double omb_pvar_read(int i)
+{
+    double value = 0.0;
+    void *buf;
+    int j;
+
+    buf = calloc(omb_pvar_counts[i], sizeof(unsigned long long) +
+            sizeof(double));
+    MPI_CHECK(MPI_T_pvar_read(omb_pvar_session, omb_pvar_handles[i], buf));
+    for (j = 0; j < omb_pvar_counts[i]; j++) {
+        if (MPI_UNSIGNED == omb_pvar_types[i]) {
+            value += ((unsigned *)buf)[j];
+        } else if (MPI_UNSIGNED_LONG == omb_pvar_types[i]) {
+            value += ((unsigned long *)buf)[j];
+        } else if (MPI_UNSIGNED_LONG_LONG == omb_pvar_types[i]) {
+            value += ((unsigned long long *)buf)[j];
+        } else if (MPI_COUNT == omb_pvar_types[i]) {
+            value += ((MPI_Count *)buf)[j];
+        } else if (MPI_INT == omb_pvar_types[i]) {
+            value += ((int *)buf)[j];
+        } else {
+            value += ((double *)buf)[j];
+        }
+    }
+    free(buf);
+
+    return value;
+}
+
+static void omb_pvar_print_list(void)
+{
+    char name[OMB_PVAR_NAME_LENGTH];
+    int num = 0, i, name_len, desc_len, verbosity, var_class, bind;
+    int readonly, continuous, atomic;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+
+    MPI_CHECK(MPI_T_pvar_get_num(&num));
+    fprintf(stdout, "# %d MPI_T performance variables\n", num);
+    fprintf(stdout, "%-*s%*s%*s\n", 48, "# Name", 16, "Class", 12,
+            "Bound to");
+    for (i = 0; i < num; i++) {
+        name_len = sizeof(name);
+        desc_len = 0;
+        if (MPI_SUCCESS != MPI_T_pvar_get_info(i, name, &name_len,
+                    &verbosity, &var_class, &datatype, &enumtype, NULL,
+                    &desc_len, &bind, &readonly, &continuous, &atomic)) {
+            continue;
+        }
+        fprintf(stdout, "%-*s%*s%*s\n", 48, name, 16,
+                omb_pvar_class_name(var_class), 12,
+                MPI_T_BIND_NO_OBJECT == bind ? "-" :
+                MPI_T_BIND_MPI_COMM == bind ? "comm" : "other");
+    }
+    fflush(stdout);
+}
+
+static void omb_pvar_parse_options(char *optarg)
+{
+    char *token;
+
+    if (0 == strcmp(optarg, "list")) {
+        omb_pvar_list = 1;
+        return;
+    }
+    for (token = strtok(optarg, ","); NULL != token;
+            token = strtok(NULL, ",")) {
+        if (OMB_PVAR_NUMBER_OF_VARS == omb_pvar_nov) {
+            fprintf(stderr, "Warning! Only the first %d pvars are sampled\n",
+                    OMB_PVAR_NUMBER_OF_VARS);
+            break;
+        }
+        strncpy(omb_pvar_names[omb_pvar_nov], token,
+                OMB_PVAR_NAME_LENGTH - 1);
+        omb_pvar_nov++;
+    }
+}
+
+void omb_pvar_init(void)
+{
+    char name[OMB_PVAR_NAME_LENGTH];
+    int num = 0, i, j, rank = 0, provided = 0, name_len, desc_len;
+    int verbosity, var_class, bind, readonly, continuous, atomic;
+    int index;
+    MPI_T_enum enumtype;
+    void *obj;
+
+    if (!options.pvar_enabled) {
+        return;
+    }
+    omb_pvar_parse_options(options.pvars);
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    if (MPI_SUCCESS != MPI_T_init_thread(MPI_THREAD_SINGLE, &provided)) {
+        fprintf(stderr, "Error initializing the MPI_T interface\n");
+        exit(EXIT_FAILURE);
+    }
+    if (omb_pvar_list) {
+        if (0 == rank) {
+            omb_pvar_print_list();
+        }
+        MPI_T_finalize();
+        MPI_CHECK(MPI_Finalize());
+        exit(EXIT_SUCCESS);
+    }
+
+    omb_pvar_comm = MPI_COMM_WORLD;
+    MPI_CHECK(MPI_T_pvar_session_create(&omb_pvar_session));
+    MPI_CHECK(MPI_T_pvar_get_num(&num));
+    for (i = 0; i < omb_pvar_nov; i++) {
+        for (index = -1, j = 0; j < num && index < 0; j++) {
+            name_len = sizeof(name);
+            desc_len = 0;
+            if (MPI_SUCCESS == MPI_T_pvar_get_info(j, name, &name_len,
+                        &verbosity, &var_class, &omb_pvar_types[i], &enumtype,
+                        NULL, &desc_len, &bind, &readonly, &continuous,
+                        &atomic) && 0 == strcmp(name, omb_pvar_names[i])) {
+                index = j;
+            }
+        }
+        if (index < 0) {
+            fprintf(stderr, "Error: MPI_T pvar %s not found, see -Q list\n",
+                    omb_pvar_names[i]);
+            exit(EXIT_FAILURE);
+        }
+        if (!omb_pvar_supported_type(omb_pvar_types[i]) ||
+                (MPI_T_BIND_NO_OBJECT != bind &&
+                 MPI_T_BIND_MPI_COMM != bind)) {
+            fprintf(stderr, "Error: MPI_T pvar %s has an unsupported type or "
+                    "binding\n", omb_pvar_names[i]);
+            exit(EXIT_FAILURE);
+        }
+        obj = MPI_T_BIND_MPI_COMM == bind ? (void *)&omb_pvar_comm : NULL;
+        MPI_CHECK(MPI_T_pvar_handle_alloc(omb_pvar_session, index, obj,
+                    &omb_pvar_handles[i], &omb_pvar_counts[i]));
+        if (!continuous) {
+            MPI_CHECK(MPI_T_pvar_start(omb_pvar_session,
+                        omb_pvar_handles[i]));
+        }
+        /* Counts and times accumulate; everything else is a current value */
+        omb_pvar_deltas[i] = MPI_T_PVAR_CLASS_COUNTER == var_class ||
+            MPI_T_PVAR_CLASS_AGGREGATE == var_class ||
+            MPI_T_PVAR_CLASS_TIMER == var_class;
+    }
+}
+
+void omb_pvar_start(void)
+{
+    int i;
+
+    if (!options.pvar_enabled) {
+        return;
+    }
+    for (i = 0; i < omb_pvar_nov; i++) {
+        omb_pvar_before[i] = omb_pvar_read(i);
+    }
+}
+
+void omb_pvar_stop_and_print(size_t size)
+{
+    double value[OMB_PVAR_NUMBER_OF_VARS];
+    double sum[OMB_PVAR_NUMBER_OF_VARS], max[OMB_PVAR_NUMBER_OF_VARS];
+    int i, rank = 0;
+
+    if (!options.pvar_enabled || 0 == omb_pvar_nov) {
+        return;
+    }
+    for (i = 0; i < omb_pvar_nov; i++) {
+        value[i] = omb_pvar_read(i);
+        if (omb_pvar_deltas[i]) {
+            value[i] -= omb_pvar_before[i];
+        }
+    }
+    MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPI_CHECK(MPI_Reduce(value, sum, omb_pvar_nov, MPI_DOUBLE, MPI_SUM, 0,
+                MPI_COMM_WORLD));
+    MPI_CHECK(MPI_Reduce(value, max, omb_pvar_nov, MPI_DOUBLE, MPI_MAX, 0,
+                MPI_COMM_WORLD));
+    if (0 == rank) {
+        fprintf(stdout, "# MPI_T pvars at %zu bytes (sum and max over "
+                "ranks)\n", size);
+        for (i = 0; i < omb_pvar_nov; i++) {
+            fprintf(stdout, "#   %-*s%-8s%*.*f%*.*f\n", 40, omb_pvar_names[i],
+                    omb_pvar_deltas[i] ? "change" : "value", FIELD_WIDTH,
+                    FLOAT_PRECISION, sum[i], FIELD_WIDTH, FLOAT_PRECISION,
+                    max[i]);
+        }
+        fflush(stdout);
+    }
+}
+
+void omb_pvar_free(void)
+{
+    int i;
+
+    if (!options.pvar_enabled) {
+        return;
+    }
+    for (i = 0; i < omb_pvar_nov; i++) {
+        MPI_T_pvar_handle_free(omb_pvar_session, &omb_pvar_handles[i]);
+    }
+    MPI_T_pvar_session_free(&omb_pvar_session);
+    MPI_T_finalize();
+}
+/* vi:set sw=4 sts=4 tw=80: */
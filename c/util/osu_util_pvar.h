@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+
+/*
+ * MPI_T performance variables, sampled at the same points as the PAPI
+ * counters: omb_papi_start() reads them before a size's timed region and
+ * omb_papi_stop_and_print() reads them again and prints the change.
+ */
+#define OMB_PVAR_NUMBER_OF_VARS 16
+#define OMB_PVAR_NAME_LENGTH 128
+
+void omb_pvar_init(void);
+void omb_pvar_start(void);
+void omb_pvar_stop_and_print(size_t size);
+void omb_pvar_free(void);
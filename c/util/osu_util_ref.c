@@ -0,0 +1,803 @@
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+
+#include <osu_util_mpi.h>
+
+static void *omb_ref_alloc(size_t size)
+{
+    void *ptr = malloc(size);
+
+    if (NULL == ptr) {
+        fprintf(stderr, "Could Not Allocate Memory for the reference "
+                "collectives\n");
+        MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE));
+    }
+
+    return ptr;
+}
+
+/* Make the stores of every rank on the node visible to the others */
+static void omb_ref_node_sync(omb_ref_t *ref)
+{
+    MPI_CHECK(MPI_Win_sync(ref->win));
+    MPI_CHECK(MPI_Barrier(ref->node_comm));
+    MPI_CHECK(MPI_Win_sync(ref->win));
+}
+
+/*
+ * The shared window lives on node rank 0 and holds one slot of max_size bytes
+ * per node rank followed by two result areas of result_size bytes. Calls
+ * alternate between the result areas so a rank may start the next call while
+ * the others still copy out of the previous one.
+ */
+static void omb_ref_hier_init(omb_ref_t *ref, int numprocs)
+{
+    MPI_Aint win_size = 0;
+    int disp_unit = 1, node_id = 0, i;
+    int *ids;
+    char *base = NULL;
+
+    MPI_CHECK(MPI_Comm_split_type(ref->comm, MPI_COMM_TYPE_SHARED, 0,
+                MPI_INFO_NULL, &ref->node_comm));
+    MPI_CHECK(MPI_Comm_rank(ref->node_comm, &ref->node_rank));
+    MPI_CHECK(MPI_Comm_size(ref->node_comm, &ref->node_size));
+    MPI_CHECK(MPI_Comm_split(ref->comm, 0 == ref->node_rank ? 0 :
+                MPI_UNDEFINED, ref->rank, &ref->leader_comm));
+    if (MPI_COMM_NULL != ref->leader_comm) {
+        MPI_CHECK(MPI_Comm_rank(ref->leader_comm, &node_id));
+        MPI_CHECK(MPI_Comm_size(ref->leader_comm, &ref->nnodes));
+    }
+    MPI_CHECK(MPI_Bcast(&node_id, 1, MPI_INT, 0, ref->node_comm));
+    MPI_CHECK(MPI_Bcast(&ref->nnodes, 1, MPI_INT, 0, ref->node_comm));
+
+    /* Result blocks are in node order; positions maps ranks to blocks */
+    ids = omb_ref_alloc(2 * numprocs * sizeof(int));
+    ref->node_sizes = omb_ref_alloc(ref->nnodes * sizeof(int));
+    ref->node_firsts = omb_ref_alloc(ref->nnodes * sizeof(int));
+    ref->positions = omb_ref_alloc(numprocs * sizeof(int));
+    ids[2 * ref->rank] = node_id;
+    ids[2 * ref->rank + 1] = ref->node_rank;
+    MPI_CHECK(MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, ids, 2,
+                MPI_INT, ref->comm));
+    memset(ref->node_sizes, 0, ref->nnodes * sizeof(int));
+    for (i = 0; i < numprocs; i++) {
+        ref->node_sizes[ids[2 * i]]++;
+    }
+    for (i = 0; i < ref->nnodes; i++) {
+        ref->node_firsts[i] = i ? ref->node_firsts[i - 1] +
+            ref->node_sizes[i - 1] : 0;
+    }
+    for (i = 0; i < numprocs; i++) {
+        ref->positions[i] = ref->node_firsts[ids[2 * i]] + ids[2 * i + 1];
+    }
+    free(ids);
+
+    if (0 == ref->node_rank) {
+        win_size = ref->node_size * ref->max_size + 2 * ref->result_size;
+    }
+    MPI_CHECK(MPI_Win_allocate_shared(win_size, 1, MPI_INFO_NULL,
+                ref->node_comm, &base, &ref->win));
+    MPI_CHECK(MPI_Win_shared_query(ref->win, 0, &win_size, &disp_unit,
+                &base));
+    ref->slots = base;
+    ref->result = base + ref->node_size * ref->max_size;
+    MPI_CHECK(MPI_Win_lock_all(MPI_MODE_NOCHECK, ref->win));
+}
+
+void omb_ref_init(omb_ref_t *ref, size_t max_size, size_t result_size,
+                  MPI_Comm comm)
+{
+    int numprocs;
+
+    memset(ref, 0, sizeof(*ref));
+    ref->comm = comm;
+    ref->node_comm = MPI_COMM_NULL;
+    ref->leader_comm = MPI_COMM_NULL;
+    ref->win = MPI_WIN_NULL;
+    ref->max_size = max_size;
+    ref->result_size = result_size;
+    if (OMB_REF_NONE == options.ref_algo) {
+        return;
+    }
+    MPI_CHECK(MPI_Comm_rank(comm, &ref->rank));
+    MPI_CHECK(MPI_Comm_size(comm, &numprocs));
+    ref->counts = omb_ref_alloc((numprocs + 1) * sizeof(int));
+    ref->displs = omb_ref_alloc((numprocs + 1) * sizeof(int));
+    if (OMB_REF_HIER == options.ref_algo) {
+        omb_ref_hier_init(ref, numprocs);
+    } else {
+        ref->tmp = omb_ref_alloc(2 * result_size);
+        ref->requests = omb_ref_alloc(2 * (max_size / OMB_REF_SEGMENT_SIZE +
+                    1) * sizeof(MPI_Request));
+    }
+}
+
+void omb_ref_free(omb_ref_t *ref)
+{
+    if (MPI_WIN_NULL != ref->win) {
+        MPI_CHECK(MPI_Win_unlock_all(ref->win));
+        MPI_CHECK(MPI_Win_free(&ref->win));
+    }
+    if (MPI_COMM_NULL != ref->leader_comm) {
+        MPI_CHECK(MPI_Comm_free(&ref->leader_comm));
+    }
+    if (MPI_COMM_NULL != ref->node_comm) {
+        MPI_CHECK(MPI_Comm_free(&ref->node_comm));
+    }
+    free(ref->node_sizes);
+    free(ref->node_firsts);
+    free(ref->positions);
+    free(ref->counts);
+    free(ref->displs);
+    free(ref->tmp);
+    free(ref->requests);
+}
+
+/*
+ * Reduce the contributions of the node into the result area: every rank
+ * copies its vector into its slot and then reduces its share of the
+ * elements across all slots.
+ */
+static char *omb_ref_node_reduce(omb_ref_t *ref, void *sendbuf, int count,
+                                 MPI_Datatype datatype, MPI_Op op)
+{
+    char *result = ref->result + (ref->epoch++ % 2) * ref->result_size;
+    int type_size, share, extra, first, n, i;
+    size_t offset;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    memcpy(ref->slots + ref->node_rank * ref->max_size, sendbuf,
+            (size_t)count * type_size);
+    omb_ref_node_sync(ref);
+
+    share = count / ref->node_size;
+    extra = count % ref->node_size;
+    first = ref->node_rank * share + (ref->node_rank < extra ?
+            ref->node_rank : extra);
+    n = share + (ref->node_rank < extra);
+    offset = (size_t)first * type_size;
+    if (n > 0) {
+        memcpy(result + offset, ref->slots + offset, (size_t)n * type_size);
+        for (i = 1; i < ref->node_size; i++) {
+            MPI_CHECK(MPI_Reduce_local(ref->slots + i * ref->max_size +
+                        offset, result + offset, n, datatype, op));
+        }
+    }
+    omb_ref_node_sync(ref);
+
+    return result;
+}
+
+static int omb_ref_hier_allreduce(omb_ref_t *ref, void *sendbuf,
+                                  void *recvbuf, int count,
+                                  MPI_Datatype datatype, MPI_Op op)
+{
+    char *result;
+    int type_size;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    result = omb_ref_node_reduce(ref, sendbuf, count, datatype, op);
+    if (MPI_COMM_NULL != ref->leader_comm && ref->nnodes > 1) {
+        MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, result, count, datatype, op,
+                    ref->leader_comm));
+    }
+    omb_ref_node_sync(ref);
+    memcpy(recvbuf, result, (size_t)count * type_size);
+
+    return MPI_SUCCESS;
+}
+
+/* Rank 0 is node rank 0 and leader rank 0, so it receives directly */
+static int omb_ref_hier_reduce(omb_ref_t *ref, void *sendbuf, void *recvbuf,
+                               int count, MPI_Datatype datatype, MPI_Op op)
+{
+    char *result;
+    int type_size;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    result = omb_ref_node_reduce(ref, sendbuf, count, datatype, op);
+    if (MPI_COMM_NULL != ref->leader_comm && ref->nnodes > 1) {
+        MPI_CHECK(MPI_Reduce(0 == ref->rank ? MPI_IN_PLACE : result, result,
+                    count, datatype, op, 0, ref->leader_comm));
+    }
+    if (0 == ref->rank) {
+        memcpy(recvbuf, result, (size_t)count * type_size);
+    }
+
+    return MPI_SUCCESS;
+}
+
+static int omb_ref_hier_bcast(omb_ref_t *ref, void *buffer, int count,
+                              MPI_Datatype datatype)
+{
+    char *result = ref->result + (ref->epoch++ % 2) * ref->result_size;
+    int type_size;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    if (MPI_COMM_NULL != ref->leader_comm) {
+        if (ref->nnodes > 1) {
+            MPI_CHECK(MPI_Bcast(buffer, count, datatype, 0,
+                        ref->leader_comm));
+        }
+        memcpy(result, buffer, (size_t)count * type_size);
+    }
+    omb_ref_node_sync(ref);
+    if (MPI_COMM_NULL == ref->leader_comm) {
+        memcpy(buffer, result, (size_t)count * type_size);
+    }
+
+    return MPI_SUCCESS;
+}
+
+static int omb_ref_hier_allgather(omb_ref_t *ref, void *sendbuf,
+                                  void *recvbuf, int count,
+                                  MPI_Datatype datatype, int numprocs)
+{
+    char *result = ref->result + (ref->epoch++ % 2) * ref->result_size;
+    size_t bytes;
+    int type_size, i;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    bytes = (size_t)count * type_size;
+    memcpy(result + ref->positions[ref->rank] * bytes, sendbuf, bytes);
+    omb_ref_node_sync(ref);
+    if (MPI_COMM_NULL != ref->leader_comm && ref->nnodes > 1) {
+        for (i = 0; i < ref->nnodes; i++) {
+            ref->counts[i] = ref->node_sizes[i] * count;
+            ref->displs[i] = ref->node_firsts[i] * count;
+        }
+        MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, result,
+                    ref->counts, ref->displs, datatype, ref->leader_comm));
+    }
+    omb_ref_node_sync(ref);
+    for (i = 0; i < numprocs; i++) {
+        memcpy((char *)recvbuf + i * bytes, result + ref->positions[i] *
+                bytes, bytes);
+    }
+
+    return MPI_SUCCESS;
+}
+
+static int omb_ref_hier(omb_ref_t *ref, omb_coll_args_t *a, int numprocs)
+{
+    switch (a->type) {
+        case OMB_COLL_ALLREDUCE:
+            return omb_ref_hier_allreduce(ref, a->sendbuf, a->recvbuf,
+                    a->sendcount, a->sendtype, a->op);
+        case OMB_COLL_REDUCE:
+            return omb_ref_hier_reduce(ref, a->sendbuf, a->recvbuf,
+                    a->sendcount, a->sendtype, a->op);
+        case OMB_COLL_BCAST:
+            return omb_ref_hier_bcast(ref, a->sendbuf, a->sendcount,
+                    a->sendtype);
+        case OMB_COLL_ALLGATHER:
+            return omb_ref_hier_allgather(ref, a->sendbuf, a->recvbuf,
+                    a->sendcount, a->sendtype, numprocs);
+        default:
+            break;
+    }
+
+    return MPI_ERR_OTHER;
+}
+
+/* One exchange over MPI_Isend and MPI_Irecv; either side may be empty */
+static void omb_ref_sendrecv(void *sendbuf, int sendcount, int dest,
+                             void *recvbuf, int recvcount, int source,
+                             MPI_Datatype datatype, MPI_Comm comm)
+{
+    MPI_Request requests[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+
+    if (MPI_PROC_NULL != source) {
+        MPI_CHECK(MPI_Irecv(recvbuf, recvcount, datatype, source, OMB_REF_TAG,
+                    comm, &requests[0]));
+    }
+    if (MPI_PROC_NULL != dest) {
+        MPI_CHECK(MPI_Isend(sendbuf, sendcount, datatype, dest, OMB_REF_TAG,
+                    comm, &requests[1]));
+    }
+    MPI_CHECK(MPI_Waitall(2, requests, MPI_STATUSES_IGNORE));
+}
+
+/* Split count elements into numprocs nearly equal blocks */
+static void omb_ref_blocks(omb_ref_t *ref, int count, int numprocs)
+{
+    int i;
+
+    for (i = 0; i < numprocs; i++) {
+        ref->counts[i] = count / numprocs + (i < count % numprocs);
+        ref->displs[i] = i ? ref->displs[i - 1] + ref->counts[i - 1] : 0;
+    }
+}
+
+/*
+ * Recursive doubling and Rabenseifner run on the largest power of two pof2
+ * of ranks. The first 2 * (numprocs - pof2) ranks pair up beforehand: even
+ * ranks hand their vector to the odd neighbour and sit out, and get the
+ * result back at the end. Returns the rank among the pof2 or -1.
+ */
+static int omb_ref_fold_in(omb_ref_t *ref, void *buffer, int count,
+                           MPI_Datatype datatype, MPI_Op op, int pof2,
+                           int numprocs)
+{
+    int rem = numprocs - pof2;
+
+    if (ref->rank >= 2 * rem) {
+        return ref->rank - rem;
+    }
+    if (0 == ref->rank % 2) {
+        omb_ref_sendrecv(buffer, count, ref->rank + 1, NULL, 0,
+                MPI_PROC_NULL, datatype, ref->comm);
+        return -1;
+    }
+    omb_ref_sendrecv(NULL, 0, MPI_PROC_NULL, ref->tmp, count, ref->rank - 1,
+            datatype, ref->comm);
+    MPI_CHECK(MPI_Reduce_local(ref->tmp, buffer, count, datatype, op));
+
+    return ref->rank / 2;
+}
+
+static void omb_ref_fold_out(omb_ref_t *ref, void *buffer, int count,
+                             MPI_Datatype datatype, int pof2, int numprocs)
+{
+    int rem = numprocs - pof2;
+
+    if (ref->rank >= 2 * rem) {
+        return;
+    }
+    if (ref->rank % 2) {
+        omb_ref_sendrecv(buffer, count, ref->rank - 1, NULL, 0,
+                MPI_PROC_NULL, datatype, ref->comm);
+    } else {
+        omb_ref_sendrecv(NULL, 0, MPI_PROC_NULL, buffer, count,
+                ref->rank + 1, datatype, ref->comm);
+    }
+}
+
+/* Rank of the participant with index newrank among the pof2 */
+static int omb_ref_fold_rank(int newrank, int pof2, int numprocs)
+{
+    int rem = numprocs - pof2;
+
+    return newrank < rem ? newrank * 2 + 1 : newrank + rem;
+}
+
+static int omb_ref_pof2(int numprocs)
+{
+    int pof2 = 1;
+
+    while (pof2 * 2 <= numprocs) {
+        pof2 *= 2;
+    }
+
+    return pof2;
+}
+
+/* Ring reduce-scatter of numprocs blocks, then ring allgather */
+static int omb_ref_ring_allreduce(omb_ref_t *ref, void *sendbuf,
+                                  void *recvbuf, int count,
+                                  MPI_Datatype datatype, MPI_Op op,
+                                  int numprocs)
+{
+    char *buf = recvbuf;
+    int type_size, left, right, k, send_block, recv_block;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    memcpy(recvbuf, sendbuf, (size_t)count * type_size);
+    omb_ref_blocks(ref, count, numprocs);
+    left = (ref->rank - 1 + numprocs) % numprocs;
+    right = (ref->rank + 1) % numprocs;
+
+    for (k = 0; k < numprocs - 1; k++) {
+        send_block = (ref->rank - k + numprocs) % numprocs;
+        recv_block = (ref->rank - k - 1 + numprocs) % numprocs;
+        omb_ref_sendrecv(buf + (size_t)ref->displs[send_block] * type_size,
+                ref->counts[send_block], right, ref->tmp,
+                ref->counts[recv_block], left, datatype, ref->comm);
+        MPI_CHECK(MPI_Reduce_local(ref->tmp, buf +
+                    (size_t)ref->displs[recv_block] * type_size,
+                    ref->counts[recv_block], datatype, op));
+    }
+    /* Each rank now holds the reduced block rank + 1 */
+    for (k = 0; k < numprocs - 1; k++) {
+        send_block = (ref->rank + 1 - k + numprocs) % numprocs;
+        recv_block = (ref->rank - k + numprocs) % numprocs;
+        omb_ref_sendrecv(buf + (size_t)ref->displs[send_block] * type_size,
+                ref->counts[send_block], right, buf +
+                (size_t)ref->displs[recv_block] * type_size,
+                ref->counts[recv_block], left, datatype, ref->comm);
+    }
+
+    return MPI_SUCCESS;
+}
+
+static int omb_ref_rd_allreduce(omb_ref_t *ref, void *sendbuf, void *recvbuf,
+                                int count, MPI_Datatype datatype, MPI_Op op,
+                                int numprocs)
+{
+    int type_size, pof2 = omb_ref_pof2(numprocs), newrank, mask, dst;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    memcpy(recvbuf, sendbuf, (size_t)count * type_size);
+    newrank = omb_ref_fold_in(ref, recvbuf, count, datatype, op, pof2,
+            numprocs);
+    if (newrank >= 0) {
+        for (mask = 1; mask < pof2; mask <<= 1) {
+            dst = omb_ref_fold_rank(newrank ^ mask, pof2, numprocs);
+            omb_ref_sendrecv(recvbuf, count, dst, ref->tmp, count, dst,
+                    datatype, ref->comm);
+            MPI_CHECK(MPI_Reduce_local(ref->tmp, recvbuf, count, datatype,
+                        op));
+        }
+    }
+    omb_ref_fold_out(ref, recvbuf, count, datatype, pof2, numprocs);
+
+    return MPI_SUCCESS;
+}
+
+/*
+ * Reduce-scatter by recursive halving over pof2 blocks, then allgather of
+ * the blocks by recursive doubling, retracing the same pairs in reverse.
+ */
+static int omb_ref_rabenseifner_allreduce(omb_ref_t *ref, void *sendbuf,
+                                          void *recvbuf, int count,
+                                          MPI_Datatype datatype, MPI_Op op,
+                                          int numprocs)
+{
+    char *buf = recvbuf;
+    int type_size, pof2 = omb_ref_pof2(numprocs), newrank, newdst, dst;
+    int mask, send_idx = 0, recv_idx = 0, last_idx, send_cnt, recv_cnt, i;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    memcpy(recvbuf, sendbuf, (size_t)count * type_size);
+    newrank = omb_ref_fold_in(ref, recvbuf, count, datatype, op, pof2,
+            numprocs);
+    if (newrank >= 0) {
+        omb_ref_blocks(ref, count, pof2);
+        last_idx = pof2;
+        mask = 1;
+        while (mask < pof2) {
+            newdst = newrank ^ mask;
+            dst = omb_ref_fold_rank(newdst, pof2, numprocs);
+            send_cnt = recv_cnt = 0;
+            if (newrank < newdst) {
+                send_idx = recv_idx + pof2 / (mask * 2);
+                for (i = send_idx; i < last_idx; i++) {
+                    send_cnt += ref->counts[i];
+                }
+                for (i = recv_idx; i < send_idx; i++) {
+                    recv_cnt += ref->counts[i];
+                }
+            } else {
+                recv_idx = send_idx + pof2 / (mask * 2);
+                for (i = send_idx; i < recv_idx; i++) {
+                    send_cnt += ref->counts[i];
+                }
+                for (i = recv_idx; i < last_idx; i++) {
+                    recv_cnt += ref->counts[i];
+                }
+            }
+            omb_ref_sendrecv(buf + (size_t)ref->displs[send_idx] * type_size,
+                    send_cnt, dst, ref->tmp + (size_t)ref->displs[recv_idx] *
+                    type_size, recv_cnt, dst, datatype, ref->comm);
+            MPI_CHECK(MPI_Reduce_local(ref->tmp +
+                        (size_t)ref->displs[recv_idx] * type_size, buf +
+                        (size_t)ref->displs[recv_idx] * type_size, recv_cnt,
+                        datatype, op));
+            send_idx = recv_idx;
+            mask <<= 1;
+            if (mask < pof2) {
+                last_idx = recv_idx + pof2 / mask;
+            }
+        }
+
+        for (mask >>= 1; mask > 0; mask >>= 1) {
+            newdst = newrank ^ mask;
+            dst = omb_ref_fold_rank(newdst, pof2, numprocs);
+            send_cnt = recv_cnt = 0;
+            if (newrank < newdst) {
+                if (mask != pof2 / 2) {
+                    last_idx = last_idx + pof2 / (mask * 2);
+                }
+                recv_idx = send_idx + pof2 / (mask * 2);
+                for (i = send_idx; i < recv_idx; i++) {
+                    send_cnt += ref->counts[i];
+                }
+                for (i = recv_idx; i < last_idx; i++) {
+                    recv_cnt += ref->counts[i];
+                }
+            } else {
+                recv_idx = send_idx - pof2 / (mask * 2);
+                for (i = send_idx; i < last_idx; i++) {
+                    send_cnt += ref->counts[i];
+                }
+                for (i = recv_idx; i < send_idx; i++) {
+                    recv_cnt += ref->counts[i];
+                }
+            }
+            omb_ref_sendrecv(buf + (size_t)ref->displs[send_idx] * type_size,
+                    send_cnt, dst, buf + (size_t)ref->displs[recv_idx] *
+                    type_size, recv_cnt, dst, datatype, ref->comm);
+            if (newrank > newdst) {
+                send_idx = recv_idx;
+            }
+        }
+    }
+    omb_ref_fold_out(ref, recvbuf, count, datatype, pof2, numprocs);
+
+    return MPI_SUCCESS;
+}
+
+static int omb_ref_ring_allgather(omb_ref_t *ref, void *sendbuf,
+                                  void *recvbuf, int count,
+                                  MPI_Datatype datatype, int numprocs)
+{
+    char *buf = recvbuf;
+    size_t bytes;
+    int type_size, left, right, k, send_block, recv_block;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    bytes = (size_t)count * type_size;
+    memcpy(buf + ref->rank * bytes, sendbuf, bytes);
+    left = (ref->rank - 1 + numprocs) % numprocs;
+    right = (ref->rank + 1) % numprocs;
+    for (k = 0; k < numprocs - 1; k++) {
+        send_block = (ref->rank - k + numprocs) % numprocs;
+        recv_block = (ref->rank - k - 1 + numprocs) % numprocs;
+        omb_ref_sendrecv(buf + send_block * bytes, count, right,
+                buf + recv_block * bytes, count, left, datatype, ref->comm);
+    }
+
+    return MPI_SUCCESS;
+}
+
+/*
+ * Recursive doubling over the folded pof2 ranks. A participant stands for
+ * one or two consecutive ranks, so every group of participants still owns
+ * a contiguous range of blocks.
+ */
+static int omb_ref_rd_allgather(omb_ref_t *ref, void *sendbuf, void *recvbuf,
+                                int count, MPI_Datatype datatype,
+                                int numprocs)
+{
+    char *buf = recvbuf;
+    size_t bytes;
+    int type_size, pof2 = omb_ref_pof2(numprocs), rem = numprocs - pof2;
+    int newrank, mask, dst, mine, theirs, i;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    bytes = (size_t)count * type_size;
+    memcpy(buf + ref->rank * bytes, sendbuf, bytes);
+    /* First block of participant i; ref->displs[pof2] is numprocs */
+    for (i = 0; i <= pof2; i++) {
+        ref->displs[i] = i < rem ? 2 * i : i + rem;
+    }
+
+    if (ref->rank < 2 * rem) {
+        if (0 == ref->rank % 2) {
+            omb_ref_sendrecv(sendbuf, count, ref->rank + 1, NULL, 0,
+                    MPI_PROC_NULL, datatype, ref->comm);
+            newrank = -1;
+        } else {
+            omb_ref_sendrecv(NULL, 0, MPI_PROC_NULL, buf + (ref->rank - 1) *
+                    bytes, count, ref->rank - 1, datatype, ref->comm);
+            newrank = ref->rank / 2;
+        }
+    } else {
+        newrank = ref->rank - rem;
+    }
+    if (newrank >= 0) {
+        for (mask = 1; mask < pof2; mask <<= 1) {
+            dst = omb_ref_fold_rank(newrank ^ mask, pof2, numprocs);
+            mine = newrank & ~(mask - 1);
+            theirs = (newrank ^ mask) & ~(mask - 1);
+            omb_ref_sendrecv(buf + ref->displs[mine] * bytes,
+                    (ref->displs[mine + mask] - ref->displs[mine]) * count,
+                    dst, buf + ref->displs[theirs] * bytes,
+                    (ref->displs[theirs + mask] - ref->displs[theirs]) *
+                    count, dst, datatype, ref->comm);
+        }
+    }
+    omb_ref_fold_out(ref, recvbuf, numprocs * count, datatype, pof2,
+            numprocs);
+
+    return MPI_SUCCESS;
+}
+
+static int omb_ref_binomial_bcast(omb_ref_t *ref, void *buffer, int count,
+                                  MPI_Datatype datatype, int numprocs)
+{
+    int mask;
+
+    for (mask = 1; mask < numprocs; mask <<= 1) {
+        if (ref->rank & mask) {
+            omb_ref_sendrecv(NULL, 0, MPI_PROC_NULL, buffer, count,
+                    ref->rank - mask, datatype, ref->comm);
+            break;
+        }
+    }
+    for (mask >>= 1; mask > 0; mask >>= 1) {
+        if (ref->rank + mask < numprocs) {
+            omb_ref_sendrecv(buffer, count, ref->rank + mask, NULL, 0,
+                    MPI_PROC_NULL, datatype, ref->comm);
+        }
+    }
+
+    return MPI_SUCCESS;
+}
+
+/*
+ * Every rank forwards each segment to the next rank as soon as it arrives,
+ * with all receives posted up front.
+ */
+static int omb_ref_chain_bcast(omb_ref_t *ref, void *buffer, int count,
+                               MPI_Datatype datatype, int numprocs)
+{
+    char *buf = buffer;
+    int type_size, segment, nsegs, n, i, nsends = 0;
+    MPI_Request *recvs = ref->requests;
+    MPI_Request *sends;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    segment = OMB_REF_SEGMENT_SIZE / type_size;
+    nsegs = count ? (count + segment - 1) / segment : 0;
+    sends = recvs + nsegs;
+    for (i = 0; i < nsegs && ref->rank > 0; i++) {
+        n = i < nsegs - 1 ? segment : count - i * segment;
+        MPI_CHECK(MPI_Irecv(buf + (size_t)i * segment * type_size, n,
+                    datatype, ref->rank - 1, OMB_REF_TAG, ref->comm,
+                    &recvs[i]));
+    }
+    for (i = 0; i < nsegs; i++) {
+        n = i < nsegs - 1 ? segment : count - i * segment;
+        if (ref->rank > 0) {
+            MPI_CHECK(MPI_Wait(&recvs[i], MPI_STATUS_IGNORE));
+        }
+        if (ref->rank < numprocs - 1) {
+            MPI_CHECK(MPI_Isend(buf + (size_t)i * segment * type_size, n,
+                        datatype, ref->rank + 1, OMB_REF_TAG, ref->comm,
+                        &sends[nsends++]));
+        }
+    }
+    MPI_CHECK(MPI_Waitall(nsends, sends, MPI_STATUSES_IGNORE));
+
+    return MPI_SUCCESS;
+}
+
+/* In round k, rank r sends its block for r + k and receives from r - k */
+static int omb_ref_pairwise_alltoall(omb_ref_t *ref, void *sendbuf,
+                                     void *recvbuf, int count,
+                                     MPI_Datatype datatype, int numprocs)
+{
+    char *sbuf = sendbuf, *rbuf = recvbuf;
+    size_t bytes;
+    int type_size, k, dst, src;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    bytes = (size_t)count * type_size;
+    memcpy(rbuf + ref->rank * bytes, sbuf + ref->rank * bytes, bytes);
+    for (k = 1; k < numprocs; k++) {
+        dst = (ref->rank + k) % numprocs;
+        src = (ref->rank - k + numprocs) % numprocs;
+        omb_ref_sendrecv(sbuf + dst * bytes, count, dst, rbuf + src * bytes,
+                count, src, datatype, ref->comm);
+    }
+
+    return MPI_SUCCESS;
+}
+
+/*
+ * Rotate the blocks by rank, then in round k send every block whose index
+ * has bit k set to rank + 2^k, and finally put the blocks in rank order.
+ */
+static int omb_ref_bruck_alltoall(omb_ref_t *ref, void *sendbuf,
+                                  void *recvbuf, int count,
+                                  MPI_Datatype datatype, int numprocs)
+{
+    char *sbuf = sendbuf, *rbuf = recvbuf, *blocks = ref->tmp;
+    char *pack, *unpack;
+    size_t bytes;
+    int type_size, pof, i, n;
+
+    MPI_CHECK(MPI_Type_size(datatype, &type_size));
+    bytes = (size_t)count * type_size;
+    pack = blocks + numprocs * bytes;
+    unpack = pack + numprocs / 2 * bytes;
+    for (i = 0; i < numprocs; i++) {
+        memcpy(blocks + i * bytes, sbuf + ((ref->rank + i) % numprocs) *
+                bytes, bytes);
+    }
+    for (pof = 1; pof < numprocs; pof <<= 1) {
+        for (n = 0, i = 0; i < numprocs; i++) {
+            if (i & pof) {
+                memcpy(pack + n++ * bytes, blocks + i * bytes, bytes);
+            }
+        }
+        omb_ref_sendrecv(pack, n * count, (ref->rank + pof) % numprocs,
+                unpack, n * count, (ref->rank - pof + numprocs) % numprocs,
+                datatype, ref->comm);
+        for (n = 0, i = 0; i < numprocs; i++) {
+            if (i & pof) {
+                memcpy(blocks + i * bytes, unpack + n++ * bytes, bytes);
+            }
+        }
+    }
+    for (i = 0; i < numprocs; i++) {
+        memcpy(rbuf + ((ref->rank - i + numprocs) % numprocs) * bytes,
+                blocks + i * bytes, bytes);
+    }
+
+    return MPI_SUCCESS;
+}
+
+static int omb_ref_flat(omb_ref_t *ref, omb_coll_args_t *a, int numprocs)
+{
+    switch (a->type) {
+        case OMB_COLL_ALLREDUCE:
+            if (OMB_REF_RING == options.ref_algo) {
+                return omb_ref_ring_allreduce(ref, a->sendbuf, a->recvbuf,
+                        a->sendcount, a->sendtype, a->op, numprocs);
+            } else if (OMB_REF_RD == options.ref_algo) {
+                return omb_ref_rd_allreduce(ref, a->sendbuf, a->recvbuf,
+                        a->sendcount, a->sendtype, a->op, numprocs);
+            } else if (OMB_REF_RABENSEIFNER == options.ref_algo) {
+                return omb_ref_rabenseifner_allreduce(ref, a->sendbuf,
+                        a->recvbuf, a->sendcount, a->sendtype, a->op,
+                        numprocs);
+            }
+            break;
+        case OMB_COLL_ALLGATHER:
+            if (OMB_REF_RING == options.ref_algo) {
+                return omb_ref_ring_allgather(ref, a->sendbuf, a->recvbuf,
+                        a->sendcount, a->sendtype, numprocs);
+            } else if (OMB_REF_RD == options.ref_algo) {
+                return omb_ref_rd_allgather(ref, a->sendbuf, a->recvbuf,
+                        a->sendcount, a->sendtype, numprocs);
+            }
+            break;
+        case OMB_COLL_BCAST:
+            if (OMB_REF_BINOMIAL == options.ref_algo) {
+                return omb_ref_binomial_bcast(ref, a->sendbuf, a->sendcount,
+                        a->sendtype, numprocs);
+            } else if (OMB_REF_CHAIN == options.ref_algo) {
+                return omb_ref_chain_bcast(ref, a->sendbuf, a->sendcount,
+                        a->sendtype, numprocs);
+            }
+            break;
+        case OMB_COLL_ALLTOALL:
+            if (OMB_REF_BRUCK == options.ref_algo) {
+                return omb_ref_bruck_alltoall(ref, a->sendbuf, a->recvbuf,
+                        a->sendcount, a->sendtype, numprocs);
+            } else if (OMB_REF_PAIRWISE == options.ref_algo) {
+                return omb_ref_pairwise_alltoall(ref, a->sendbuf, a->recvbuf,
+                        a->sendcount, a->sendtype, numprocs);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return MPI_ERR_OTHER;
+}
+
+int omb_ref_call(omb_ref_t *ref, omb_coll_args_t *args)
+{
+    int numprocs;
+
+    if (0 != args->root) {
+        return MPI_ERR_ROOT;
+    }
+    MPI_CHECK(MPI_Comm_size(ref->comm, &numprocs));
+    if (OMB_REF_HIER == options.ref_algo) {
+        return omb_ref_hier(ref, args, numprocs);
+    }
+
+    return omb_ref_flat(ref, args, numprocs);
+}
+/* vi:set sw=4 sts=4 tw=80: */
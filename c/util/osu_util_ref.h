@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2002-2022 the Network-Based Computing Laboratory
+ * (NBCL), The Ohio State University.
+ *
+ * Contact: Dr. D. K. Panda (panda@cse.ohio-state.edu)
+ *
+ * For detailed copyright and licensing information, please refer to the
+ * copyright file COPYRIGHT in the top level OMB directory.
+ */
+
+/*
+ * Reference collectives (-E): algorithms built on top of the MPI library and
+ * timed next to its own collective on the same buffers. hier works in two
+ * levels; the ranks of a node combine their data in an MPI-3 shared memory
+ * window and one leader per node runs the library's collective among the
+ * nodes. The flat algorithms are textbook collectives over MPI_Isend and
+ * MPI_Irecv: ring, recursive doubling (rd) and Rabenseifner allreduce, ring
+ * and rd allgather, binomial and pipelined chain bcast, Bruck and pairwise
+ * alltoall. Host buffers, contiguous predefined types and root 0 only.
+ */
+#define OMB_REF_TAG 77
+#define OMB_REF_SEGMENT_SIZE 8192
+
+struct omb_coll_args;
+
+typedef struct omb_ref {
+    MPI_Comm comm;
+    MPI_Comm node_comm;
+    MPI_Comm leader_comm;
+    int rank;
+    int node_rank;
+    int node_size;
+    int nnodes;
+    int *node_sizes;
+    int *node_firsts;
+    int *positions;
+    int *counts;
+    int *displs;
+    size_t max_size;
+    size_t result_size;
+    unsigned long epoch;
+    MPI_Win win;
+    char *slots;
+    char *result;
+    char *tmp;
+    MPI_Request *requests;
+} omb_ref_t;
+
+void omb_ref_init(omb_ref_t *ref, size_t max_size, size_t result_size,
+                  MPI_Comm comm);
+void omb_ref_free(omb_ref_t *ref);
+int omb_ref_call(omb_ref_t *ref, struct omb_coll_args *args);